@@ -0,0 +1,382 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+#define BITS_PER_WORD 64
+
+/*
+    This function makes the bit matrix mutual, so the check that a friendship is set in both cells happens once here instead of
+    in every getFriendWord_BitMatrix call. The diagonal is cleared and every set bit whose mirrored bit is not set is cleared,
+    the same entries that normalizeNeighbors_CSR drops. A bit is only cleared when its mirror is unset, so the order of the
+    checks does not matter. Sets bitMatrix->verifiedSymmetric and returns the number of bits cleared.
+*/
+int normalizeBitMatrix(BitMatrix *bitMatrix)
+{
+    int i, w, j, removed = 0;
+    uint64_t *row, candidates;
+
+    for (i = 0; i < bitMatrix->numVertices; i++) {
+        row = bitMatrix->bits + (size_t)i * bitMatrix->wordsPerRow;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            candidates = row[w];
+            while (candidates != 0) {
+                j = w * BITS_PER_WORD + countTrailingZeros64(candidates);
+                if (j == i || !((bitMatrix->bits[(size_t)j * bitMatrix->wordsPerRow + i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1)) {
+                    row[w] &= ~((uint64_t)1 << (j % BITS_PER_WORD));
+                    removed++;
+                }
+                candidates &= candidates - 1; //clear the lowest set bit
+            }
+        }
+    }
+    bitMatrix->verifiedSymmetric = true;
+
+    if (removed > 0) {
+        printf("Removed %d self-loop or one-way entries.\n", removed);
+    }
+    return removed;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file and stores them in a bit-packed adjacency matrix.
+    Every cell takes one bit instead of one bool, and all rows live in a single allocation, each padded to a whole number of
+    64-bit words so that a row can be scanned one word at a time. This needs 8 times less memory than loadAdjMatrix.
+    The header has already been read and checked by openEdgeFile, and edges with out-of-range IDs are skipped by readEdge.
+    The bits are then made mutual by normalizeBitMatrix, so the searches never have to check the mirrored bit.
+*/
+BitMatrix* loadBitMatrixFromReader(EdgeFileReader *reader, int *numVertices, int *numEdges)
+{
+    int ID1, ID2;
+
+    *numVertices = reader->numVertices;
+    *numEdges = reader->numEdges;
+    BitMatrix *bitMatrix = malloc(sizeof(BitMatrix));
+    if (bitMatrix == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    bitMatrix->numVertices = *numVertices;
+    bitMatrix->verifiedSymmetric = false;
+    bitMatrix->wordsPerRow = (*numVertices + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    bitMatrix->bits = calloc((size_t)*numVertices * bitMatrix->wordsPerRow, sizeof(uint64_t));
+    if (bitMatrix->bits == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        free(bitMatrix);
+        exit(-1);
+    }
+
+    //read the subsequent lines of the file which contain the edges and set the corresponding bits
+    while (readEdge(reader, &ID1, &ID2)) {
+        bitMatrix->bits[(size_t)ID1 * bitMatrix->wordsPerRow + ID2 / BITS_PER_WORD] |= (uint64_t)1 << (ID2 % BITS_PER_WORD);
+    }
+    normalizeBitMatrix(bitMatrix);
+    return bitMatrix;
+}
+
+/*
+    This function loads the social graph data from a .txt file and stores it in a bit-packed adjacency matrix.
+    The file is opened and its header is checked by openEdgeFile, then the edges are read by loadBitMatrixFromReader.
+    Returns NULL if the file does not exist or is not of valid format.
+*/
+BitMatrix* loadBitMatrix(char *fileString, int *numVertices, int *numEdges)
+{
+    EdgeFileReader *reader = openEdgeFile(fileString); //check edgeFileReader.c for the implementation of EdgeFileReader and its operations
+    if (reader == NULL) {
+        return NULL;
+    }
+    printf("File found. Now loading...\n");
+
+    BitMatrix *bitMatrix = loadBitMatrixFromReader(reader, numVertices, numEdges);
+    printEdgeFileStats(reader);
+    closeEdgeFile(reader);
+    return bitMatrix;
+}
+
+/*
+    This function builds a bit matrix from a graph in CSR form, e.g., one loaded from a snapshot.
+    If the CSR graph is verifiedSymmetric, so is the bit matrix.
+*/
+BitMatrix* convertCSRToBitMatrix(CSRGraph *graph)
+{
+    int i, k, j;
+
+    BitMatrix *bitMatrix = malloc(sizeof(BitMatrix));
+    if (bitMatrix == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    bitMatrix->numVertices = graph->numVertices;
+    bitMatrix->verifiedSymmetric = graph->verifiedSymmetric; //the same edges are stored, so the check carries over
+    bitMatrix->wordsPerRow = (graph->numVertices + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    bitMatrix->bits = calloc((size_t)graph->numVertices * bitMatrix->wordsPerRow, sizeof(uint64_t));
+    if (bitMatrix->bits == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        free(bitMatrix);
+        exit(-1);
+    }
+    for (i = 0; i < graph->numVertices; i++) {
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            j = graph->neighbors[k];
+            bitMatrix->bits[(size_t)i * bitMatrix->wordsPerRow + j / BITS_PER_WORD] |= (uint64_t)1 << (j % BITS_PER_WORD);
+        }
+    }
+    return bitMatrix;
+}
+
+/*
+    This function returns true if the bit for cell (ID1, ID2) of the bit matrix is set, and false otherwise.
+    It does not check the IDs, so it is only meant for IDs that are known to be valid.
+*/
+bool getBit_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2)
+{
+    return (bitMatrix->bits[(size_t)ID1 * bitMatrix->wordsPerRow + ID2 / BITS_PER_WORD] >> (ID2 % BITS_PER_WORD)) & 1;
+}
+
+/*
+    This function checks if an edge exists between two vertices in the social graph represented by a bit matrix.
+    Same as hasEdge_AdjMatrix, it returns true only if both cells (ID1, ID2) and (ID2, ID1) are set,
+    and returns false when the IDs are invalid or when they are the same.
+*/
+bool hasEdge_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2)
+{
+    if ((ID1 < 0 || ID1 >= bitMatrix->numVertices) || (ID2 < 0 || ID2 >= bitMatrix->numVertices) || ID1 == ID2) {
+        return false;
+    }
+    return getBit_BitMatrix(bitMatrix, ID1, ID2) && (bitMatrix->verifiedSymmetric || getBit_BitMatrix(bitMatrix, ID2, ID1));
+}
+
+/*
+    This function returns the friends of ID1 found in word w of its row, i.e., the set bits of that word whose mirrored cell is also set.
+    The bits are visited by jumping from one set bit to the next with countTrailingZeros64, so empty stretches of the row cost nothing.
+    If the bit matrix is verifiedSymmetric, the word is returned as it is.
+*/
+uint64_t getFriendWord_BitMatrix(BitMatrix *bitMatrix, int ID1, int w)
+{
+    uint64_t candidates = bitMatrix->bits[(size_t)ID1 * bitMatrix->wordsPerRow + w];
+    uint64_t friends = 0;
+    if (bitMatrix->verifiedSymmetric) {
+        return candidates; //every set bit is already known to be mirrored
+    }
+    while (candidates != 0) {
+        int bit = countTrailingZeros64(candidates);
+        int i = w * BITS_PER_WORD + bit;
+        if (i != ID1 && getBit_BitMatrix(bitMatrix, i, ID1)) {
+            friends |= (uint64_t)1 << bit;
+        }
+        candidates &= candidates - 1; //clear the lowest set bit
+    }
+    return friends;
+}
+
+/*
+    Prints the bit matrix of the social graph. 1 if set, 0 if not.
+    Used for testing purposes.
+*/
+void printBitMatrix(BitMatrix *bitMatrix)
+{
+    int i, j;
+
+    for (i = 0; i < bitMatrix->numVertices; i++) {
+        for (j = 0; j < bitMatrix->numVertices; j++) {
+            printf("%d ", getBit_BitMatrix(bitMatrix, i, j));
+        }
+        printf("\n");
+    }
+}
+
+/*
+    This function prints the friend list of a given ID in the social graph represented by a bit matrix.
+    The row is scanned 64 cells per word, and the friends found in each word are counted with countSetBits64.
+*/
+void printFriendList_BitMatrix(BitMatrix *bitMatrix, int ID1)
+{
+    int w, friendCount = 0;
+    uint64_t friends;
+    if (ID1 < 0 || ID1 >= bitMatrix->numVertices) {
+        printf("Invalid ID. ID should be a value between 0 to %d. Please try again.\n", bitMatrix->numVertices - 1);
+        return;
+    }
+    printf("\n\t=== %d's FRIEND LIST ===\n", ID1);
+    for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+        friends = getFriendWord_BitMatrix(bitMatrix, ID1, w);
+        friendCount += countSetBits64(friends);
+        while (friends != 0) {
+            printf("%d\n", w * BITS_PER_WORD + countTrailingZeros64(friends));
+            friends &= friends - 1;
+        }
+    }
+    printf("\n%d's Friend Count: %d\n", ID1, friendCount);
+}
+
+/*
+    This function is an implementation of the BFS algorithm to determine whether if a connection exists between two IDs
+    in the social graph that is represented by a bit matrix.
+    The visited set is also kept as bits, so each word of the current vertex's row is masked with the unvisited vertices
+    and 64 candidates are ruled out at once. The search visits vertices in the same order as findConnections_BFS_AdjMatrix.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+*/
+int* findConnections_BFS_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *pathLength)
+{
+    int numVertices = bitMatrix->numVertices;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+
+    int i, j, w, currentIndex;
+    bool connectionFound = false;
+    uint64_t candidates;
+
+    //create a parent array of size numVertices to store the parent of each vertex
+    int* parentVertices = malloc(numVertices * sizeof(int));
+    if (parentVertices == NULL) {
+        printf("Memory allocation for parentVertices has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memset(parentVertices, -1, numVertices * sizeof(int)); //set all elements to -1
+
+    //create a visited bit set, one bit per vertex
+    uint64_t* visitedWords = calloc(bitMatrix->wordsPerRow, sizeof(uint64_t));
+    if (visitedWords == NULL) {
+        printf("Memory allocation for visitedWords has failed. Terminating program...\n");
+        free(parentVertices);
+        exit(-1);
+    }
+
+    CircularQueue *queue = createCircularQueue(numVertices); //check data_structures.c for the implementation of the circular queue and its operations
+
+    //initialize the search by visiting the starting vertex and enqueueing it
+    visitedWords[ID1 / BITS_PER_WORD] |= (uint64_t)1 << (ID1 % BITS_PER_WORD);
+    enqueueCircular(queue, ID1);
+
+    while (!isEmptyCircularQueue(queue)) {
+        currentIndex = dequeueCircular(queue); //dequeue the front of the queue
+        if (currentIndex == ID2) {
+            connectionFound = true;
+            break;
+        }
+        //visit all the unvisited adjacent vertices of the current vertex, one word of its row at a time
+        uint64_t *currentRow = bitMatrix->bits + (size_t)currentIndex * bitMatrix->wordsPerRow;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            candidates = currentRow[w] & ~visitedWords[w];
+            while (candidates != 0) {
+                i = w * BITS_PER_WORD + countTrailingZeros64(candidates);
+                if (bitMatrix->verifiedSymmetric || (i != currentIndex && getBit_BitMatrix(bitMatrix, i, currentIndex))) {
+                    visitedWords[w] |= (uint64_t)1 << (i % BITS_PER_WORD); //mark the vertex as visited
+                    parentVertices[i] = currentIndex; //set the parent of the vertex
+                    enqueueCircular(queue, i); //enqueue the vertex
+                }
+                candidates &= candidates - 1; //move on to the next set bit
+            }
+        }
+    }
+
+    if (!connectionFound) {
+        free(parentVertices);
+        free(visitedWords);
+        freeCircularQueue(queue);
+        return NULL; //if no connection is found, return NULL
+    }
+
+    //reconstruct the path by tracing back from ID2 to ID1 using the parent array
+    *pathLength = 0;
+    for (i = ID2; i != -1; i = parentVertices[i]) {
+        (*pathLength)++; //count the number of vertices in the path
+    }
+
+    int* path = malloc(*pathLength * sizeof(int));
+    if (path == NULL) {
+        printf("Memory allocation for path has failed. Terminating program...\n");
+        free(parentVertices);
+        free(visitedWords);
+        freeCircularQueue(queue);
+        exit(-1);
+    }
+
+    i = ID2;
+    for (j = *pathLength - 1; j >= 0; j--) { //store the path in reverse order
+        path[j] = i; //store the current vertex in the path array
+        i = parentVertices[i]; //move to the parent vertex
+    }
+
+    free(parentVertices);
+    free(visitedWords);
+    freeCircularQueue(queue);
+    return path; //return the path
+}
+
+/*
+    This function is a nonrecursive implementation of the DFS algorithm to determine whether if a connection exists between two IDs
+    in the social graph that is represented by a bit matrix.
+    Like findConnections_BFS_BitMatrix, rows are scanned 64 cells at a time against a visited bit set,
+    and vertices are pushed in the same order as findConnections_DFS_AdjMatrix.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+    The visited bits, parents and stack are those of scratch, or of one made for this search when it is NULL.
+*/
+int* findConnections_DFS_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *pathLength, SearchScratch *scratch)
+{
+    int numVertices = bitMatrix->numVertices;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) { //if the IDs are invalid or the same, return NULL
+        return NULL;
+    }
+
+    int i, w, currentVertex, numStacked = 0;
+    bool connectionFound = false;
+    uint64_t candidates;
+    SearchScratch *ownScratch = NULL;
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_DFS); //check data_structures.c for the implementation of createSearchScratch
+    }
+    uint64_t* visitedWords = scratch->visitedBits;
+    int* parentVertices = scratch->parentVertices[0]; //only read for visited vertices, so it is not cleared
+    int* stack = scratch->frontier[0]; //each vertex is pushed at most once, so numVertices entries are enough
+    memset(visitedWords, 0, bitMatrix->wordsPerRow * sizeof(uint64_t));
+
+    //initialize the search by visiting the starting vertex and pushing it onto the stack
+    stack[numStacked++] = ID1;
+    visitedWords[ID1 / BITS_PER_WORD] |= (uint64_t)1 << (ID1 % BITS_PER_WORD);
+    parentVertices[ID1] = -1;
+
+    while (numStacked > 0) {
+        currentVertex = stack[--numStacked]; //pop the top of the stack
+        if (currentVertex == ID2) {
+            connectionFound = true;
+            break;
+        }
+        //visit all the unvisited adjacent vertices of the current vertex, one word of its row at a time
+        uint64_t *currentRow = bitMatrix->bits + (size_t)currentVertex * bitMatrix->wordsPerRow;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            candidates = currentRow[w] & ~visitedWords[w];
+            while (candidates != 0) {
+                i = w * BITS_PER_WORD + countTrailingZeros64(candidates);
+                if (bitMatrix->verifiedSymmetric || (i != currentVertex && getBit_BitMatrix(bitMatrix, i, currentVertex))) {
+                    visitedWords[w] |= (uint64_t)1 << (i % BITS_PER_WORD); //mark the vertex as visited
+                    parentVertices[i] = currentVertex; //set the parent of the vertex
+                    stack[numStacked++] = i; //push the vertex onto the stack
+                }
+                candidates &= candidates - 1; //move on to the next set bit
+            }
+        }
+    }
+
+    int* path = NULL;
+    if (connectionFound) {
+        path = reconstructPath(parentVertices, ID2, pathLength); //check data_structures.c for the implementation of reconstructPath
+    }
+    freeSearchScratch(ownScratch);
+    return path;
+}
+
+/*
+    This function frees the memory dynamically allocated for the bit matrix. All of its rows share one allocation.
+*/
+void freeBitMatrix(BitMatrix *bitMatrix)
+{
+    if (bitMatrix != NULL) {
+        free(bitMatrix->bits);
+        free(bitMatrix);
+    }
+    printf("Memory dynamically allocated for the bit matrix and its contents has been freed.\n");
+}
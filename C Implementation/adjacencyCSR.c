@@ -0,0 +1,518 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    This function looks for ID in an ascending array of count neighbors with a galloping search. The step doubles until it
+    passes ID, then a binary search finds it within the last step, so the cost is O(log d) where d is how far in ID would be.
+    Returns true if ID is in the array.
+*/
+bool containsNeighbor_CSR(const int *neighbors, int count, int ID) {
+    int low = 0, high = 0, step = 1, middle;
+    while (high < count && neighbors[high] < ID) {
+        low = high + 1;
+        high += step;
+        step *= 2;
+    }
+    if (high >= count) {
+        high = count - 1;
+    }
+    while (low <= high) { //ID can only be in neighbors[low] to neighbors[high]
+        middle = low + (high - low) / 2;
+        if (neighbors[middle] == ID) {
+            return true;
+        } else if (neighbors[middle] < ID) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return false;
+}
+
+/*
+    This function makes the neighbors of every vertex unique and mutual, so the check that a friendship is listed in both
+    directions happens once here instead of in every hasEdge_CSR call. Each vertex's neighbors must already be sorted.
+    Duplicates and self-loops are dropped first, then every entry whose reverse is not stored, and the arrays are compacted in place.
+    Sets graph->verifiedSymmetric and returns the number of entries removed.
+*/
+int normalizeNeighbors_CSR(CSRGraph *graph) {
+    int i, k, start, end, v, previous, count = 0;
+    int numEntries = graph->numEdges;
+
+    //drop duplicates and self-loops
+    for (i = 0; i < graph->numVertices; i++) {
+        start = graph->offsets[i];
+        end = graph->offsets[i + 1];
+        graph->offsets[i] = count;
+        previous = -1;
+        for (k = start; k < end; k++) {
+            v = graph->neighbors[k];
+            if (v != i && v != previous) {
+                graph->neighbors[count++] = v;
+            }
+            previous = v;
+        }
+    }
+    graph->offsets[graph->numVertices] = count;
+
+    //drop the entries whose reverse is missing. Rows before i are already compacted, and an entry of theirs pointing back
+    //at i was only dropped if i does not list it either, so the lookups give the same answers as on the original arrays
+    count = 0;
+    for (i = 0; i < graph->numVertices; i++) {
+        start = graph->offsets[i];
+        end = graph->offsets[i + 1];
+        graph->offsets[i] = count;
+        for (k = start; k < end; k++) {
+            v = graph->neighbors[k];
+            if (containsNeighbor_CSR(graph->neighbors + graph->offsets[v], graph->offsets[v + 1] - graph->offsets[v], i)) {
+                graph->neighbors[count++] = v;
+            }
+        }
+    }
+    graph->offsets[graph->numVertices] = count;
+    graph->numEdges = count;
+    graph->verifiedSymmetric = true;
+
+    if (count < numEntries) {
+        printf("Removed %d duplicate, self-loop or one-way neighbor entries.\n", numEntries - count);
+    }
+    return numEntries - count;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file and stores them in compressed sparse row (CSR) form.
+    The edges are read in two passes. The first pass counts the number of friends of each ID, and a prefix sum of those counts
+    gives the offsets array. The second pass scatters every edge into its slot of the contiguous neighbors array.
+    Each vertex's neighbors are then sorted in ascending order so searches visit friends in the same order as the other formats.
+    Every line of the file is kept, including duplicates, self-loops and one-way edges.
+    The header has already been read and checked by openEdgeFile, and edges with out-of-range IDs are skipped by readEdge.
+    Returns NULL if the file cannot be rewound for the second pass.
+*/
+CSRGraph* loadSortedCSRGraphFromReader(EdgeFileReader *reader, int *numVertices, int *numEdges) {
+    int i, ID1, ID2;
+
+    *numVertices = reader->numVertices;
+    *numEdges = reader->numEdges;
+    CSRGraph *graph = malloc(sizeof(CSRGraph));
+    if (graph == NULL) {
+        printf("Memory allocation for CSR graph has failed. Terminating program...\n");
+        exit(-1);
+    }
+    graph->numVertices = *numVertices;
+    graph->mappedData = NULL;
+    graph->mappedSize = 0;
+    graph->verifiedSymmetric = false;
+    graph->offsets = calloc(*numVertices + 1, sizeof(int));
+    if (graph->offsets == NULL) {
+        printf("Memory allocation for CSR offsets has failed. Terminating program...\n");
+        free(graph);
+        exit(-1);
+    }
+
+    //first pass: count the degree of each vertex, stored one slot ahead so the prefix sum below yields the offsets
+    while (readEdge(reader, &ID1, &ID2)) {
+        graph->offsets[ID1 + 1]++;
+    }
+    for (i = 0; i < *numVertices; i++) {
+        graph->offsets[i + 1] += graph->offsets[i];
+    }
+    graph->numEdges = graph->offsets[*numVertices];
+
+    //second pass: go back to the first edge and scatter each one into the next free slot of its source vertex
+    if (!rewindEdgeFile(reader)) {
+        printf("The file cannot be read a second time, so the CSR graph cannot be built. Please try again.\n");
+        free(graph->offsets);
+        free(graph);
+        return NULL;
+    }
+
+    graph->neighbors = malloc((graph->numEdges > 0 ? graph->numEdges : 1) * sizeof(int));
+    int *cursor = malloc(*numVertices * sizeof(int));
+    if (graph->neighbors == NULL || cursor == NULL) {
+        printf("Memory allocation for CSR neighbors has failed. Terminating program...\n");
+        free(graph->neighbors);
+        free(cursor);
+        free(graph->offsets);
+        free(graph);
+        exit(-1);
+    }
+    memcpy(cursor, graph->offsets, *numVertices * sizeof(int));
+
+    while (readEdge(reader, &ID1, &ID2)) {
+        if (cursor[ID1] < graph->offsets[ID1 + 1]) { //guards against the file changing between the two passes
+            graph->neighbors[cursor[ID1]++] = ID2;
+        }
+    }
+
+    for (i = 0; i < *numVertices; i++) {
+        qsort(graph->neighbors + graph->offsets[i], graph->offsets[i + 1] - graph->offsets[i], sizeof(int), compareIntegers);
+    }
+
+    free(cursor);
+    return graph;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file into a graph in CSR form with loadSortedCSRGraphFromReader,
+    then removes duplicates, self-loops and one-way entries with normalizeNeighbors_CSR.
+    Returns NULL if the file cannot be rewound for the second pass.
+*/
+CSRGraph* loadCSRGraphFromReader(EdgeFileReader *reader, int *numVertices, int *numEdges) {
+    CSRGraph *graph = loadSortedCSRGraphFromReader(reader, numVertices, numEdges);
+    if (graph != NULL) {
+        normalizeNeighbors_CSR(graph);
+    }
+    return graph;
+}
+
+/*
+    This function loads the social graph data from a .txt file and stores it in compressed sparse row (CSR) form.
+    The file is opened and its header is checked by openEdgeFile, then the edges are read by loadCSRGraphFromReader.
+    Returns NULL if the file does not exist or is not of valid format.
+*/
+CSRGraph* loadCSRGraph(char *fileString, int *numVertices, int *numEdges) {
+    EdgeFileReader *reader = openEdgeFile(fileString); //check edgeFileReader.c for the implementation of EdgeFileReader and its operations
+    if (reader == NULL) {
+        return NULL;
+    }
+    printf("File found. Now loading...\n");
+
+    CSRGraph *graph = loadCSRGraphFromReader(reader, numVertices, numEdges);
+    printEdgeFileStats(reader);
+    closeEdgeFile(reader);
+    return graph;
+}
+
+/*
+    This function checks if there is an edge between two vertices in a graph stored in CSR form.
+    Like the other formats, it returns true only if each ID appears in the other's neighbors, and false otherwise.
+    Each vertex's neighbors are sorted, so every lookup is a galloping search. If the graph is verifiedSymmetric, finding one
+    direction is enough, so only the vertex with fewer neighbors is searched.
+*/
+bool hasEdge_CSR(CSRGraph *graph, int ID1, int ID2) {
+    if ((ID1 < 0 || ID1 >= graph->numVertices) || (ID2 < 0 || ID2 >= graph->numVertices) || ID1 == ID2) {
+        return false;
+    }
+
+    int degree1 = graph->offsets[ID1 + 1] - graph->offsets[ID1];
+    int degree2 = graph->offsets[ID2 + 1] - graph->offsets[ID2];
+
+    if (graph->verifiedSymmetric) {
+        if (degree1 <= degree2) {
+            return containsNeighbor_CSR(graph->neighbors + graph->offsets[ID1], degree1, ID2);
+        }
+        return containsNeighbor_CSR(graph->neighbors + graph->offsets[ID2], degree2, ID1);
+    }
+    return containsNeighbor_CSR(graph->neighbors + graph->offsets[ID1], degree1, ID2)
+        && containsNeighbor_CSR(graph->neighbors + graph->offsets[ID2], degree2, ID1);
+}
+
+/*
+    This function prints the offsets and neighbors of a graph stored in CSR form, one vertex per line.
+    Used for testing purposes.
+*/
+void printCSRGraph(CSRGraph *graph) {
+    int i, k;
+    for (i = 0; i < graph->numVertices; i++) {
+        printf("%d: ", i);
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            printf("%d ", graph->neighbors[k]);
+        }
+        printf("\n");
+    }
+}
+
+/*
+    This function prints the friend list of a certain ID in a graph stored in CSR form.
+    The friends are printed in ascending order since each vertex's neighbors are sorted when the graph is loaded.
+*/
+void printFriendList_CSR(CSRGraph *graph, int ID1) {
+    if (ID1 < 0 || ID1 >= graph->numVertices) {
+        printf("Invalid ID. ID should be a value between 0 to %d. Please try again.\n", graph->numVertices - 1);
+        return;
+    }
+    int k;
+    printf("\n\t=== %d's FRIEND LIST ===\n", ID1);
+    for (k = graph->offsets[ID1]; k < graph->offsets[ID1 + 1]; k++) {
+        printf("%d\n", graph->neighbors[k]);
+    }
+    printf("\n%d's Friend Count: %d\n", ID1, graph->offsets[ID1 + 1] - graph->offsets[ID1]);
+}
+
+/*
+    This function is an implementation of the BFS algorithm to determine whether if a connection exists between two IDs
+    in the social graph that is stored in CSR form.
+    Only the neighbors of each dequeued vertex are looked at, and they are read from one contiguous slice of the neighbors array.
+    The edge files list both directions of every friendship, so the stored neighbors of a vertex are exactly its friends.
+    With the first-in first-out CircularQueue as the frontier, the whole search costs O(V + E) and returns a shortest path.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+*/
+int* findConnections_BFS_CSR(CSRGraph *graph, int ID1, int ID2, int *pathLength) {
+    int numVertices = graph->numVertices;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+
+    int i, j, k, currentIndex;
+    bool connectionFound = false;
+
+    int* parentVertices = malloc(numVertices * sizeof(int));
+    if (parentVertices == NULL) {
+        printf("Memory allocation for parentVertices has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memset(parentVertices, -1, numVertices * sizeof(int));
+
+    bool* visitedVertices = calloc(numVertices, sizeof(bool));
+    if (visitedVertices == NULL) {
+        printf("Memory allocation for visitedVertices has failed. Terminating program...\n");
+        free(parentVertices);
+        exit(-1);
+    }
+
+    CircularQueue *queue = createCircularQueue(numVertices); //check data_structures.c for the implementation of CircularQueue and its operations
+
+    visitedVertices[ID1] = true;
+    enqueueCircular(queue, ID1);
+
+    while (!isEmptyCircularQueue(queue)) {
+        currentIndex = dequeueCircular(queue); //dequeue the front element
+        if (currentIndex == ID2) {
+            connectionFound = true;
+            break;
+        }
+        for (k = graph->offsets[currentIndex]; k < graph->offsets[currentIndex + 1]; k++) { //enqueue the adjacent vertices
+            i = graph->neighbors[k];
+            if (!visitedVertices[i] && i != currentIndex) {
+                visitedVertices[i] = true; //mark the vertex as visited
+                parentVertices[i] = currentIndex; //set the parent of the vertex
+                enqueueCircular(queue, i); //enqueue the vertex
+            }
+        }
+    }
+
+    if (!connectionFound) { //return NULL if no connection is found
+        free(parentVertices);
+        free(visitedVertices);
+        freeCircularQueue(queue);
+        return NULL;
+    }
+
+    //reconstruct the path by tracing back from ID2 to ID1 using the parent array
+    *pathLength = 0;
+    for (i = ID2; i != -1; i = parentVertices[i]) {
+        (*pathLength)++; //increment the path length
+    }
+
+    int* path = malloc(*pathLength * sizeof(int));
+    if (path == NULL) {
+        printf("Memory allocation for path has failed. Terminating program...\n");
+        free(parentVertices);
+        free(visitedVertices);
+        freeCircularQueue(queue);
+        exit(-1);
+    }
+
+    i = ID2;
+    for (j = *pathLength - 1; j >= 0; j--) { //store the path in the array
+        path[j] = i; //store the vertex in the array
+        i = parentVertices[i]; //move to the parent vertex
+    }
+
+    free(parentVertices);
+    free(visitedVertices);
+    freeCircularQueue(queue);
+    return path;
+}
+
+/*
+    This function is a nonrecursive implementation of the DFS algorithm to determine whether if a connection exists between two IDs
+    in the social graph that is stored in CSR form.
+    Neighbors are pushed in ascending order, the same order the other formats push them in, so the resulting path is the same.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+    Its arrays are taken from scratch when one is given, and allocated for this search alone otherwise.
+*/
+int* findConnections_DFS_CSR(CSRGraph *graph, int ID1, int ID2, int *pathLength, SearchScratch *scratch) {
+    int numVertices = graph->numVertices;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+
+    int i, k, currentVertex, numStacked = 0;
+    bool connectionFound = false;
+    SearchScratch *ownScratch = NULL;
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_DFS); //check data_structures.c for the implementation of createSearchScratch
+    }
+    beginSearch_Scratch(scratch);
+    int stamp = scratch->stamp;
+    int* visitedStamp = scratch->visitedStamp[0]; //visitedStamp[i] == stamp means vertex i was visited by this search
+    int* parentVertices = scratch->parentVertices[0]; //only read for visited vertices, so it is not cleared
+    int* stack = scratch->frontier[0]; //each vertex is pushed at most once, so numVertices entries are enough
+
+    //push the source vertex to the stack and mark it as visited
+    stack[numStacked++] = ID1;
+    visitedStamp[ID1] = stamp;
+    parentVertices[ID1] = -1;
+
+    while (numStacked > 0) {
+        currentVertex = stack[--numStacked]; //pop the top element
+        if (currentVertex == ID2) {
+            connectionFound = true;
+            break;
+        }
+        for (k = graph->offsets[currentVertex]; k < graph->offsets[currentVertex + 1]; k++) { //push the adjacent vertices to the stack
+            i = graph->neighbors[k];
+            if (visitedStamp[i] != stamp && i != currentVertex) {
+                visitedStamp[i] = stamp; //mark the vertex as visited
+                parentVertices[i] = currentVertex; //set the parent of the vertex
+                stack[numStacked++] = i; //push the vertex to the stack
+            }
+        }
+    }
+
+    int* path = NULL;
+    if (connectionFound) {
+        path = reconstructPath(parentVertices, ID2, pathLength); //check data_structures.c for the implementation of reconstructPath
+    }
+    freeSearchScratch(ownScratch);
+    return path;
+}
+
+/*
+    This function creates an empty graph in CSR form with room for numEdges neighbors.
+    The offsets are all set to 0, and the neighbors are left for the caller to fill in.
+    Returns a pointer to the newly created graph.
+*/
+CSRGraph* createCSRGraph(int numVertices, int numEdges) {
+    CSRGraph *graph = malloc(sizeof(CSRGraph));
+    if (graph == NULL) {
+        printf("Memory allocation for CSR graph has failed. Terminating program...\n");
+        exit(-1);
+    }
+    graph->numVertices = numVertices;
+    graph->numEdges = numEdges;
+    graph->mappedData = NULL;
+    graph->mappedSize = 0;
+    graph->verifiedSymmetric = false;
+    graph->offsets = calloc(numVertices + 1, sizeof(int));
+    graph->neighbors = malloc((numEdges > 0 ? numEdges : 1) * sizeof(int));
+    if (graph->offsets == NULL || graph->neighbors == NULL) {
+        printf("Memory allocation for CSR graph has failed. Terminating program...\n");
+        exit(-1);
+    }
+    return graph;
+}
+
+/*
+    This function copies an adjacency list into a new graph in CSR form, e.g., so that it can be saved as a snapshot.
+    Each vertex's neighbors are sorted, same as in loadCSRGraph. The entries are copied as they are, so the graph is
+    verifiedSymmetric only if the list is.
+*/
+CSRGraph* convertAdjListToCSR(singlyNode** adjList, int numVertices) {
+    int i, k, numEdges = 0;
+    singlyNode *temp;
+
+    for (i = 0; i < numVertices; i++) {
+        for (temp = adjList[i]; temp != NULL; temp = temp->nextNode) {
+            numEdges++;
+        }
+    }
+
+    CSRGraph *graph = createCSRGraph(numVertices, numEdges);
+    k = 0;
+    for (i = 0; i < numVertices; i++) {
+        graph->offsets[i] = k;
+        for (temp = adjList[i]; temp != NULL; temp = temp->nextNode) {
+            graph->neighbors[k++] = temp->data;
+        }
+        qsort(graph->neighbors + graph->offsets[i], k - graph->offsets[i], sizeof(int), compareIntegers);
+    }
+    graph->offsets[numVertices] = k;
+    graph->verifiedSymmetric = getStorage_AdjList(adjList)->verifiedSymmetric; //the same edges are stored, so the check carries over
+    return graph;
+}
+
+/*
+    This function copies every set cell of an adjacency matrix into a new graph in CSR form.
+    Scanning each row from left to right leaves each vertex's neighbors already sorted and unique. The matrix has no flag of its own,
+    so the counting pass also checks that the diagonal is clear and every cell matches its mirror, which makes the graph verifiedSymmetric.
+*/
+CSRGraph* convertAdjMatrixToCSR(bool** adjMatrix, int numVertices) {
+    int i, j, k, numEdges = 0;
+    bool symmetric = true;
+
+    for (i = 0; i < numVertices; i++) {
+        symmetric = symmetric && !adjMatrix[i][i];
+        for (j = 0; j < numVertices; j++) {
+            numEdges += adjMatrix[i][j];
+            symmetric = symmetric && (j <= i || adjMatrix[i][j] == adjMatrix[j][i]);
+        }
+    }
+
+    CSRGraph *graph = createCSRGraph(numVertices, numEdges);
+    k = 0;
+    for (i = 0; i < numVertices; i++) {
+        graph->offsets[i] = k;
+        for (j = 0; j < numVertices; j++) {
+            if (adjMatrix[i][j]) {
+                graph->neighbors[k++] = j;
+            }
+        }
+    }
+    graph->offsets[numVertices] = k;
+    graph->verifiedSymmetric = symmetric;
+    return graph;
+}
+
+/*
+    This function copies every set bit of a bit matrix into a new graph in CSR form, jumping between set bits one word at a time.
+    If the bit matrix is verifiedSymmetric, so is the graph.
+*/
+CSRGraph* convertBitMatrixToCSR(BitMatrix *bitMatrix) {
+    int i, w, k, numEdges = 0;
+    size_t numWords = (size_t)bitMatrix->numVertices * bitMatrix->wordsPerRow;
+    size_t word;
+    uint64_t bits;
+
+    for (word = 0; word < numWords; word++) {
+        numEdges += countSetBits64(bitMatrix->bits[word]);
+    }
+
+    CSRGraph *graph = createCSRGraph(bitMatrix->numVertices, numEdges);
+    k = 0;
+    for (i = 0; i < bitMatrix->numVertices; i++) {
+        graph->offsets[i] = k;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            bits = bitMatrix->bits[(size_t)i * bitMatrix->wordsPerRow + w];
+            while (bits != 0) {
+                graph->neighbors[k++] = w * 64 + countTrailingZeros64(bits);
+                bits &= bits - 1;
+            }
+        }
+    }
+    graph->offsets[bitMatrix->numVertices] = k;
+    graph->verifiedSymmetric = bitMatrix->verifiedSymmetric;
+    return graph;
+}
+
+/*
+    This function frees the memory dynamically allocated for a graph stored in CSR form.
+    Only three allocations need to be released, no matter how many edges the graph has.
+    If the graph was loaded from a snapshot, its arrays belong to the mapped file, which is unmapped instead.
+*/
+void freeCSRGraph(CSRGraph *graph) {
+    if (graph != NULL) {
+        if (graph->mappedData != NULL) {
+            unmapGraphSnapshot(graph->mappedData, graph->mappedSize); //check graphSnapshot.c for the implementation of unmapGraphSnapshot
+        } else {
+            free(graph->offsets);
+            free(graph->neighbors);
+        }
+        free(graph);
+    }
+    printf("Memory dynamically allocated for the CSR graph and its contents has been freed.\n");
+}
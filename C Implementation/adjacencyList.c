@@ -2,55 +2,142 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h> 
+#include <stddef.h>
 #include "data_structures.h"
 
 /*
-    This function loads the social graph data from a .txt file and stores it in an adjacency list implemented as an array of singly linked lists.
-    It is assumed that the file is of valid format, i.e., the first line contains the number of vertices and edges, and the subsequent lines contain the edges.
-    Specifically, this array of singly linked lists is implemented as an array of singlyNode pointers, where each singlyNode pointer points to the head of a singly linked list.
-    
-    By Aaron Barcelita.
+    The array of list heads of an adjacency list, together with the node pool that all of its nodes come from.
+    The rest of the program only sees the heads, and freeAdjacencyList finds the pool from them, so the whole graph is freed
+    by releasing a few slabs instead of calling free once per edge.
+    Room is kept for capacity heads, so that addVertex_AdjList can add people without moving the storage every time.
 */
-singlyNode** loadAdjacencyList(char *fileString, int *numVertices, int *numEdges) {
-    FILE *fp;
-    int i, j, ID1, ID2, status;
+typedef struct AdjListStorageTag {
+    NodePool pool;
+    bool verifiedSymmetric; //true if the lists have no duplicates or self-loops and every friend lists the vertex back
+    EdgeIndex *edgeIndex; //built by the first update, check graphUpdates.c, or NULL
+    int capacity; //number of heads there is room for
+    singlyNode *heads[];
+} AdjListStorage;
 
-    //open the file
-    fp = fopen(fileString, "r");
-    if (fp == NULL) {
-        printf("File not found. Please try again.\n");
-        return NULL;
-    } else {
-        printf("File found. Now loading...\n");
+/*
+    This function creates an adjacency list of numVertices empty lists, with a node pool whose first slab holds expectedNodes nodes.
+    Returns a pointer to the list heads.
+*/
+singlyNode** createAdjacencyList(int numVertices, int expectedNodes) {
+    int i;
+    AdjListStorage *storage = malloc(sizeof(AdjListStorage) + (size_t)numVertices * sizeof(singlyNode*));
+    if (storage == NULL) {
+        printf("Memory allocation for adjacency list has failed. Terminating program...\n");
+        exit(-1);
     }
+    initNodePool(&storage->pool, expectedNodes); //check data_structures.c for the implementation of NodePool and its operations
+    storage->verifiedSymmetric = false;
+    storage->edgeIndex = NULL;
+    storage->capacity = numVertices;
+    for (i = 0; i < numVertices; i++) {
+        storage->heads[i] = NULL;
+    }
+    return storage->heads;
+}
+
+/*
+    This function returns the storage that the heads of an adjacency list created by createAdjacencyList belong to.
+*/
+AdjListStorage* getStorage_AdjList(singlyNode** adjList) {
+    return (AdjListStorage*)((char*)adjList - offsetof(AdjListStorage, heads));
+}
+
+/*
+    This function returns the node pool of an adjacency list created by createAdjacencyList.
+*/
+NodePool* getNodePool_AdjList(singlyNode** adjList) {
+    return &getStorage_AdjList(adjList)->pool;
+}
 
-    //read the number of vertices and edges
-    fscanf(fp, "%d %d", numVertices, numEdges);
-    singlyNode **adjList = malloc(*numVertices * sizeof(singlyNode*));
-    if (adjList == NULL) {
+/*
+    This function reads the edges of an opened social graph .txt file and stores them in an adjacency list.
+    The header has already been read and checked by openEdgeFile, and edges with out-of-range IDs are skipped by readEdge.
+    The last node of every list is remembered while loading, so each edge is appended in O(1) instead of walking the list,
+    and loading takes O(V + E) time. The friends of each vertex stay in the order of the file.
+    Duplicates, self-loops and one-way entries are then dropped by normalizeAdjacencyList, as the CSR loaders do, so the list is
+    verifiedSymmetric and the traversals can skip the reverse check.
+*/
+singlyNode** loadAdjacencyListFromReader(EdgeFileReader *reader, int *numVertices, int *numEdges) {
+    int ID1, ID2;
+    singlyNode *newNode;
+
+    *numVertices = reader->numVertices;
+    *numEdges = reader->numEdges;
+    singlyNode **adjList = createAdjacencyList(*numVertices, *numEdges); //one node per edge line, so the first slab usually holds them all
+    NodePool *pool = getNodePool_AdjList(adjList);
+    singlyNode **tails = calloc(*numVertices > 0 ? *numVertices : 1, sizeof(singlyNode*)); //tails[i] is the last node of list i, or NULL if it is empty
+    if (tails == NULL) {
         printf("Memory allocation for adjacency list has failed. Terminating program...\n");
-        free(adjList);
-        fclose(fp);
         exit(-1);
     }
 
-    //initialize the adjacency list
-    for (i = 0; i < *numVertices; i++) {
-        adjList[i] = NULL;
+    //read the edges
+    while (readEdge(reader, &ID1, &ID2)) {
+        newNode = allocateNode(pool, ID2); //check data_structures.c for the implementation of allocateNode
+        if (tails[ID1] == NULL) {
+            adjList[ID1] = newNode;
+        } else {
+            tails[ID1]->nextNode = newNode;
+        }
+        tails[ID1] = newNode;
     }
+    free(tails);
+    normalizeAdjacencyList(adjList, *numVertices); //check graphValidation.c for the implementation of normalizeAdjacencyList
+    return adjList;
+}
 
-    //read the edges
-    while (fscanf(fp, "%d %d", &ID1, &ID2) == 2) {
-        insertAtEnd(&adjList[ID1], ID2); //check data_structures.c for the implementation of insertAtEnd
+/*
+    This function loads the social graph data from a .txt file and stores it in an adjacency list implemented as an array of singly linked lists.
+    The file is opened and its header is checked by openEdgeFile, then the edges are read by loadAdjacencyListFromReader.
+    Specifically, this array of singly linked lists is implemented as an array of singlyNode pointers, where each singlyNode pointer points to the head of a singly linked list.
+    Returns NULL if the file does not exist or is not of valid format.
+    
+    By Aaron Barcelita.
+*/
+singlyNode** loadAdjacencyList(char *fileString, int *numVertices, int *numEdges) {
+    EdgeFileReader *reader = openEdgeFile(fileString); //check edgeFileReader.c for the implementation of EdgeFileReader and its operations
+    if (reader == NULL) {
+        return NULL;
     }
+    printf("File found. Now loading...\n");
 
-    fclose(fp);
+    singlyNode **adjList = loadAdjacencyListFromReader(reader, numVertices, numEdges);
+    printEdgeFileStats(reader);
+    closeEdgeFile(reader);
+    return adjList;
+}
+
+/*
+    This function builds an adjacency list from a graph in CSR form, e.g., one loaded from a snapshot.
+    Each list is built back to front by inserting at its head, so it keeps the order of the CSR neighbors without walking to its end.
+    If the CSR graph is verifiedSymmetric, so is the adjacency list.
+*/
+singlyNode** convertCSRToAdjList(CSRGraph *graph) {
+    int i, k;
+    singlyNode *newNode;
+
+    singlyNode **adjList = createAdjacencyList(graph->numVertices, graph->numEdges);
+    NodePool *pool = getNodePool_AdjList(adjList);
+    getStorage_AdjList(adjList)->verifiedSymmetric = graph->verifiedSymmetric; //the same edges are stored, so the check carries over
+    for (i = 0; i < graph->numVertices; i++) {
+        for (k = graph->offsets[i + 1] - 1; k >= graph->offsets[i]; k--) {
+            newNode = allocateNode(pool, graph->neighbors[k]); //check data_structures.c for the implementation of allocateNode
+            newNode->nextNode = adjList[i];
+            adjList[i] = newNode;
+        }
+    }
     return adjList;
 }
 
 /*
     This function checks if there is an edge between two vertices in an adjacency list implemented as an array of singly linked lists.
     It returns true if there is an edge between the two vertices, and false otherwise.
+    If the adjacency list is verified symmetric, only the list of ID1 is walked.
     
     By Aaron Barcelita.
 */
@@ -66,20 +153,47 @@ bool hasEdge_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2) {
     while (temp != NULL) {
         if (temp->data == ID2) {
             found1 = true;
+            break; //no need to walk the rest of the list
         }
         temp = temp->nextNode;
     }
 
-    temp = adjList[ID2];
+    if (found1 && getStorage_AdjList(adjList)->verifiedSymmetric) {
+        return true; //every friend is known to list the vertex back
+    }
+
+    temp = found1 ? adjList[ID2] : NULL; //the reverse only has to be checked if the first direction was found
     while (temp != NULL) {
         if (temp->data == ID1) {
             found2 = true;
+            break;
         }
         temp = temp->nextNode;
     }
     return found1 && found2;
 }
 
+/*
+    This function checks whether ID2 can be reached from ID1 in a traversal of the adjacency list, where ID2 was found in
+    the list of ID1. If the adjacency list is verified symmetric, every friend lists the vertex back and nothing is walked;
+    otherwise ID2 has to list ID1 back, as hasEdge_AdjList requires.
+*/
+bool isMutual_AdjList(singlyNode** adjList, int ID1, int ID2) {
+    if (getStorage_AdjList(adjList)->verifiedSymmetric) {
+        return true;
+    }
+    if (ID1 == ID2) {
+        return false;
+    }
+    singlyNode *temp;
+    for (temp = adjList[ID2]; temp != NULL; temp = temp->nextNode) {
+        if (temp->data == ID1) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
     This function prints the adjacency list implemented as an array of singly linked lists.
     Used for testing purposes.
@@ -127,6 +241,15 @@ void printFriendList_AdjList(singlyNode** adjList, int numVertices, int ID1) {
     in the social graph that is implemented as an adjacency list.
     Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
 
+    Each dequeued vertex only walks its own linked list instead of probing all numVertices IDs with hasEdge_AdjList,
+    so every edge is looked at once and the neighbor expansion costs O(V + E) over the whole search.
+    That bound only holds for a verifiedSymmetric list, which is exactly the set of friends of its vertex. Otherwise, each friend
+    also has to list the vertex back (isMutual_AdjList), so the same paths are found as with hasEdge_AdjList, but every entry
+    walks the list of its neighbor and the expansion costs O(sum of deg^2) instead.
+    The frontier is a first-in first-out CircularQueue with O(1) enqueue and dequeue, so the returned path is a shortest path.
+    Newly discovered vertices are sorted before they are enqueued so vertices on the same level are visited in ascending order;
+    since a vertex is discovered at most once, this sorting adds at most O(V log V) to the search.
+
     By Aaron Barcelita.
 */
 int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *pathLength) {
@@ -134,8 +257,9 @@ int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1,
         return NULL;
     }
 
-    int i, j, currentIndex;
+    int i, j, currentIndex, numDiscovered;
     bool connectionFound = false;
+    singlyNode *temp;
 
     int* parentVertices =  malloc(numVertices * sizeof(int));
     if (parentVertices == NULL) {
@@ -145,46 +269,53 @@ int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1,
     }
     memset(parentVertices, -1, numVertices * sizeof(int));
 
-    bool* visitedVertices = calloc(numVertices, sizeof(bool));
-    if (visitedVertices == NULL) {
-        printf("Memory allocation for visitedVertices has failed. Terminating program...\n");
+    int* discoveredVertices = malloc(numVertices * sizeof(int)); //holds the unvisited neighbors found while expanding one vertex
+    if (discoveredVertices == NULL) {
+        printf("Memory allocation for discoveredVertices has failed. Terminating program...\n");
         free(parentVertices);
-        free(visitedVertices);
         exit(-1);
     }
 
-    //initialize the priority queue
-    PriorityQueue *priorityQueue = createPriorityQueue(); //check data_structures.c for the implementation of PriorityQueue and its operations
-    if (priorityQueue == NULL) {
-        printf("Memory allocation for priorityQueue has failed. Terminating program...\n");
+    bool* visitedVertices = calloc(numVertices, sizeof(bool));
+    if (visitedVertices == NULL) {
+        printf("Memory allocation for visitedVertices has failed. Terminating program...\n");
         free(parentVertices);
         free(visitedVertices);
-        freePriorityQueue(priorityQueue);
         exit(-1);
     }
 
+    //initialize the queue, each vertex is enqueued at most once so numVertices slots are enough
+    CircularQueue *queue = createCircularQueue(numVertices); //check data_structures.c for the implementation of CircularQueue and its operations
+
     visitedVertices[ID1] = true;
-    enqueue(priorityQueue, ID1);
+    enqueueCircular(queue, ID1);
 
-    while (!isEmptyQueue(priorityQueue)) {
-        currentIndex = dequeue(priorityQueue); //dequeue the front element
+    while (!isEmptyCircularQueue(queue)) {
+        currentIndex = dequeueCircular(queue); //dequeue the front element
         if (currentIndex == ID2) {
             connectionFound = true;
             break;
         }
-        for (i = 0; i < numVertices; i++) { //enqueue the adjacent vertices
-            if (hasEdge_AdjList(adjList, numVertices, i, currentIndex) && !visitedVertices[i]) { //check if there is an edge between the two vertices
+        numDiscovered = 0;
+        for (temp = adjList[currentIndex]; temp != NULL; temp = temp->nextNode) { //walk only the friends of the current vertex
+            i = temp->data;
+            if (!visitedVertices[i] && isMutual_AdjList(adjList, currentIndex, i)) {
                 visitedVertices[i] = true; //mark the vertex as visited
                 parentVertices[i] = currentIndex; //set the parent of the vertex
-                enqueue(priorityQueue, i); //enqueue the vertex
+                discoveredVertices[numDiscovered++] = i;
             }
         }
+        qsort(discoveredVertices, numDiscovered, sizeof(int), compareIntegers); //keep the ascending visiting order
+        for (j = 0; j < numDiscovered; j++) { //enqueue the adjacent vertices
+            enqueueCircular(queue, discoveredVertices[j]);
+        }
     }
+    free(discoveredVertices);
     
     if (!connectionFound) { //return NULL if no connection is found
         free(parentVertices);
         free(visitedVertices);
-        free(priorityQueue);
+        freeCircularQueue(queue);
         return NULL;
     }
 
@@ -203,7 +334,7 @@ int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1,
         printf("Memory allocation for path has failed. Terminating program...\n");
         free(parentVertices);
         free(visitedVertices);
-        freePriorityQueue(priorityQueue);
+        freeCircularQueue(queue);
         exit(-1);
     }
 
@@ -215,7 +346,7 @@ int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1,
 
     free(parentVertices);
     free(visitedVertices);
-    freePriorityQueue(priorityQueue);
+    freeCircularQueue(queue);
     return path;
 }
 
@@ -223,108 +354,86 @@ int* findConnections_BFS_AdjList(singlyNode** adjList, int numVertices, int ID1,
     This function is a nonrecursive implementation of the DFS algorithm to determine whether if a connection exists between two IDs 
     in the social graph that is implemented as an adjacency list.
     Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+    The visited stamps, parents and stack come from scratch (createSearchScratch for SEARCH_DFS), or are allocated for this search if it is NULL.
+
+    Like findConnections_BFS_AdjList, each popped vertex only walks its own linked list, so the search costs O(V + E)
+    plus at most O(V log V) for pushing newly discovered vertices in ascending order, which keeps the resulting path the same.
+    As there, O(V + E) needs a verifiedSymmetric list; on any other list, isMutual_AdjList makes it O(sum of deg^2).
 
     By Aaron Barcelita.
 
 */
-int* findConnections_DFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int* pathLength) {
+int* findConnections_DFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int* pathLength, SearchScratch *scratch) {
     if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
         return NULL;
     }
-    
-    bool connectionFound = false;
-    int* parentVertices = malloc(numVertices * sizeof(int));
-
-    if (parentVertices == NULL) {
-        printf("Memory allocation for parentVertices has failed. Terminating program...\n");
-        free(parentVertices);
-        exit(-1);
-    }
-    memset(parentVertices, -1, numVertices * sizeof(int)); //initialize the parent array
 
-    bool* visitedVertices = calloc(numVertices, sizeof(bool));
-    if (visitedVertices == NULL) {
-        printf("Memory allocation for visitedVertices has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        exit(-1);
-    }
-
-    Stack* stack = createStack(); //check data_structures.c for the implementation of Stack and its operations
-    if (stack == NULL) {
-        printf("Memory allocation for stack has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        freeStack(stack);
-        exit(-1);
+    bool connectionFound = false;
+    int numStacked = 0, firstDiscovered;
+    SearchScratch *ownScratch = NULL;
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_DFS); //check data_structures.c for the implementation of createSearchScratch
     }
+    beginSearch_Scratch(scratch);
+    int stamp = scratch->stamp;
+    int* visitedStamp = scratch->visitedStamp[0]; //visitedStamp[i] == stamp means vertex i was visited by this search
+    int* parentVertices = scratch->parentVertices[0]; //only read for visited vertices, so it is not cleared
+    int* stack = scratch->frontier[0]; //each vertex is pushed at most once, so numVertices entries are enough
 
     //push the source vertex to the stack and mark it as visited
-    push(stack, ID1);
-    visitedVertices[ID1] = true;
+    stack[numStacked++] = ID1;
+    visitedStamp[ID1] = stamp;
+    parentVertices[ID1] = -1;
 
-    while(!isEmptyStack(stack)) {
-        int currentVertex = pop(stack); //pop the top element
+    while (numStacked > 0) {
+        int currentVertex = stack[--numStacked]; //pop the top element
         if (currentVertex == ID2) {
             connectionFound = true;
             break;
         }
 
-        singlyNode* temp = adjList[currentVertex]; //traverse the adjacency list of the current vertex
-        for (int i = 0; i < numVertices; i++) { //push the adjacent vertices to the stack
-            if (hasEdge_AdjList(adjList, numVertices, i, currentVertex) && !visitedVertices[i]) {
-                visitedVertices[i] = true; //mark the vertex as visited
+        firstDiscovered = numStacked;
+        for (singlyNode* temp = adjList[currentVertex]; temp != NULL; temp = temp->nextNode) { //traverse the adjacency list of the current vertex
+            int i = temp->data;
+            if (visitedStamp[i] != stamp && isMutual_AdjList(adjList, currentVertex, i)) {
+                visitedStamp[i] = stamp; //mark the vertex as visited
                 parentVertices[i] = currentVertex; //set the parent of the vertex
-                push(stack, i); //push the vertex to the stack
+                stack[numStacked++] = i; //push the vertex to the stack
             }
         }
+        qsort(stack + firstDiscovered, numStacked - firstDiscovered, sizeof(int), compareIntegers); //keep the ascending push order
     }
 
-    //return NULL if no connection is found
-    if (!connectionFound) {
-        free(parentVertices);
-        free(visitedVertices);
-        freeStack(stack);
-        return NULL;
-    }
-
-    *pathLength = 0;
-    for (int i = ID2; i != -1; i = parentVertices[i]) {
-        (*pathLength)++; //increment the path length
-    }
-
-    int* path = malloc(*pathLength * sizeof(int));
-    if (path == NULL) {
-        printf("Memory allocation for path has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        freeStack(stack);
-        exit(-1);
-    }
-
-    int i = ID2;
-    for (int j = *pathLength - 1; j >= 0; j--) { //store the path in the array
-        path[j] = i; //store the vertex in the array
-        i = parentVertices[i]; //move to the parent vertex
+    int* path = NULL;
+    if (connectionFound) {
+        path = reconstructPath(parentVertices, ID2, pathLength); //check data_structures.c for the implementation of reconstructPath
     }
-
-    free(parentVertices);
-    free(visitedVertices);
-    freeStack(stack);
+    freeSearchScratch(ownScratch);
     return path;
 }
 
+/*
+    This function frees an adjacency list like freeAdjacencyList, but without printing anything, e.g., for one only used
+    as a step of a conversion.
+*/
+void releaseAdjacencyList(singlyNode** adjList, int numVertices) {
+    (void)numVertices; //the nodes are freed through the pool, so the lists do not have to be walked
+    AdjListStorage *storage = getStorage_AdjList(adjList);
+    releaseNodePool(&storage->pool); //check data_structures.c for the implementation of releaseNodePool
+    freeEdgeIndex(storage->edgeIndex); //check graphUpdates.c for the implementation of freeEdgeIndex
+    free(storage);
+}
+
 /*
     This functions allows us to free the memory dynamically allocated for the adjacency list and its contents.
     Doing so would help prevent memory leaks. Even though memory for this is freed after program termination, this is
     still considered as a good practice.
+    All the nodes are freed at once by releasing the node pool of the adjacency list, and its usage is printed first.
 
     By Aaron Barcelita.
 */
 void freeAdjacencyList(singlyNode** adjList, int numVertices) {
-    for (int i = 0; i < numVertices; i++) {
-        freeLinkedList(&adjList[i]); //check data_structures.c for the implementation of freeLinkedList
-    }
-    free(adjList);
+    printNodePoolStats(getNodePool_AdjList(adjList), "Adjacency list nodes");
+    releaseAdjacencyList(adjList, numVertices);
     printf("Memory dynamically allocated for the adjacency list and its contents has been freed.\n");
-}
\ No newline at end of file
+}
@@ -4,33 +4,49 @@
 #include "data_structures.h"
 
 /*
-    This function loads the social graph data from a .txt file and stores it in an adjacency matrix (as a 2D boolean array), and returns it.
-    It is assumed that the file is of valid format, i.e., the first line contains the number of vertices and edges, and the subsequent lines contain the edges.
+    This function makes the adjacency matrix mutual: the diagonal is cleared, and a cell stays set only if its mirrored cell is set too.
+    These are the same entries that normalizeNeighbors_CSR drops, so every format holds the same friendships after loading.
+    Returns the number of cells cleared.
+*/
+int normalizeAdjMatrix(bool** adjMatrix, int numVertices)
+{
+    int i, j, removed = 0;
+
+    for (i = 0; i < numVertices; i++) {
+        removed += adjMatrix[i][i];
+        adjMatrix[i][i] = false;
+        for (j = i + 1; j < numVertices; j++) {
+            if (adjMatrix[i][j] != adjMatrix[j][i]) {
+                adjMatrix[i][j] = false;
+                adjMatrix[j][i] = false;
+                removed++;
+            }
+        }
+    }
+
+    if (removed > 0) {
+        printf("Removed %d self-loop or one-way entries.\n", removed);
+    }
+    return removed;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file and stores them in an adjacency matrix (as a 2D boolean array), and returns it.
+    The header has already been read and checked by openEdgeFile, and edges with out-of-range IDs are skipped by readEdge.
     The adjacency matrix is a square matrix where the number of rows and columns is equal to the number of vertices in the social graph.
+    The cells are then made mutual by normalizeAdjMatrix.
     
     By Aaron Barcelita.
 */
-bool** loadAdjMatrix(char *fileString, int *numVertices, int *numEdges)
+bool** loadAdjMatrixFromReader(EdgeFileReader *reader, int *numVertices, int *numEdges)
 {
-    FILE *fp;
-    int i, j, ID1, ID2, status;
-
-    //open the file, check if it exists (assumes that file is of valid format)
-    fp = fopen(fileString, "r");
-    if (fp == NULL) {
-        printf("File not found. Please try again.\n");
-        return NULL;
-    } else {
-        printf("File found. Now loading...\n");
-    }
+    int i, j, ID1, ID2;
 
-    //next, read the first line of the file which contains the number of vertices and edges
-    fscanf(fp, "%d %d", numVertices, numEdges);
+    *numVertices = reader->numVertices;
+    *numEdges = reader->numEdges;
     bool **adjMatrix = malloc(*numVertices * sizeof(bool*));
     if (adjMatrix == NULL) { //if memory allocation fails, free all previously allocated memory and terminate the program
         printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
-        free(adjMatrix);
-        fclose(fp);
         exit(-1);
     }
 
@@ -43,20 +59,68 @@ bool** loadAdjMatrix(char *fileString, int *numVertices, int *numEdges)
                 free(adjMatrix[j]);
             }
             free(adjMatrix);
-            fclose(fp);
             exit(-1);
         }
     }
 
     //read the subsequent lines of the file which contain the edges and set the corresponding elements in the adjacency matrix to true
-    while (fscanf(fp, "%d %d", &ID1, &ID2) == 2) {
+    while (readEdge(reader, &ID1, &ID2)) {
         adjMatrix[ID1][ID2] = true;
     }
-
-    fclose(fp);
+    normalizeAdjMatrix(adjMatrix, *numVertices);
     return adjMatrix; //return the adjacency matrix
 }
 
+/*
+    This function loads the social graph data from a .txt file and stores it in an adjacency matrix (as a 2D boolean array), and returns it.
+    The file is opened and its header is checked by openEdgeFile, then the edges are read by loadAdjMatrixFromReader.
+    Returns NULL if the file does not exist or is not of valid format.
+    
+    By Aaron Barcelita.
+*/
+bool** loadAdjMatrix(char *fileString, int *numVertices, int *numEdges)
+{
+    EdgeFileReader *reader = openEdgeFile(fileString); //check edgeFileReader.c for the implementation of EdgeFileReader and its operations
+    if (reader == NULL) {
+        return NULL;
+    }
+    printf("File found. Now loading...\n");
+
+    bool **adjMatrix = loadAdjMatrixFromReader(reader, numVertices, numEdges);
+    printEdgeFileStats(reader);
+    closeEdgeFile(reader);
+    return adjMatrix;
+}
+
+/*
+    This function builds an adjacency matrix from a graph in CSR form, e.g., one loaded from a snapshot.
+*/
+bool** convertCSRToAdjMatrix(CSRGraph *graph)
+{
+    int i, j, k;
+
+    bool **adjMatrix = malloc(graph->numVertices * sizeof(bool*));
+    if (adjMatrix == NULL) {
+        printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (i = 0; i < graph->numVertices; i++) {
+        adjMatrix[i] = calloc(graph->numVertices, sizeof(bool));
+        if (adjMatrix[i] == NULL) {
+            printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+            for (j = 0; j < i; j++) {
+                free(adjMatrix[j]);
+            }
+            free(adjMatrix);
+            exit(-1);
+        }
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            adjMatrix[i][graph->neighbors[k]] = true;
+        }
+    }
+    return adjMatrix;
+}
+
 /*
     This function checks if an edge exists between two vertices in the social graph represented by an adjacency matrix.
     It returns true if an edge exists between the two vertices, and false otherwise.
@@ -117,6 +181,12 @@ void printFriendList_adjMatrix(bool **adjMatrix, int numVertices, int ID1)
     in the social graph that is implemented as an adjacency matrix.
     Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
 
+    Each dequeued vertex scans its own row of the matrix from left to right, which is contiguous in memory,
+    and only checks the mirrored cell when the row cell is set. A matrix has no cheaper way to list neighbors,
+    so the neighbor expansion costs O(V^2) over the whole search.
+    The frontier is a first-in first-out CircularQueue, and since each row is scanned in ascending order,
+    vertices on the same level are visited in ascending order and the returned path is a shortest path.
+
     By Aaron Barcelita.
 */
 int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int* pathLength)
@@ -127,6 +197,7 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
 
     int i, j, currentIndex;
     bool connectionFound = false;
+    bool* currentRow;
 
     //create a parent array of size numVertices to store the parent of each vertex
     int* parentVertices =  malloc(numVertices * sizeof(int));
@@ -145,32 +216,26 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
         exit(-1);
     }
 
-    //create a priority queue to store the vertices to be visited, is used to prioritize lower value nodes
-    PriorityQueue *priorityQueue = createPriorityQueue(); //check data_structures.c for the implementation of the priority queue and its operations
-    if (priorityQueue == NULL) {
-        printf("Memory allocation for priorityQueue has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        freePriorityQueue(priorityQueue);
-        exit(-1);
-    }
+    //create a queue to store the vertices to be visited, each vertex is enqueued at most once so numVertices slots are enough
+    CircularQueue *queue = createCircularQueue(numVertices); //check data_structures.c for the implementation of the circular queue and its operations
 
     //initialize the search by visiting the starting vertex and enqueueing it
     visitedVertices[ID1] = true;
-    enqueue(priorityQueue, ID1);
+    enqueueCircular(queue, ID1);
 
-    while (!isEmptyQueue(priorityQueue)) {
-        currentIndex = dequeue(priorityQueue); //dequeue the front of the priority queue
+    while (!isEmptyCircularQueue(queue)) {
+        currentIndex = dequeueCircular(queue); //dequeue the front of the queue
         if (currentIndex == ID2) {
             connectionFound = true;
             break;
         }
-        //visit all the adjacent vertices of the current vertex
+        //visit all the adjacent vertices of the current vertex by scanning its row
+        currentRow = adjMatrix[currentIndex];
         for (i = 0; i < numVertices; i++) {
-            if (hasEdge_AdjMatrix(adjMatrix, numVertices, i, currentIndex) && !visitedVertices[i]) {
+            if (currentRow[i] && !visitedVertices[i] && adjMatrix[i][currentIndex] && i != currentIndex) {
                 visitedVertices[i] = true; //mark the vertex as visited
                 parentVertices[i] = currentIndex; //set the parent of the vertex
-                enqueue(priorityQueue, i); //enqueue the vertex
+                enqueueCircular(queue, i); //enqueue the vertex
             }
         }
     }
@@ -178,7 +243,7 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
     if (!connectionFound) {
         free(parentVertices);
         free(visitedVertices);
-        free(priorityQueue);
+        freeCircularQueue(queue);
         return NULL; //if no connection is found, return NULL
     }
 
@@ -197,7 +262,7 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
         printf("Memory allocation for path has failed. Terminating program...\n");
         free(parentVertices);
         free(visitedVertices);
-        freePriorityQueue(priorityQueue);
+        freeCircularQueue(queue);
         exit(-1);
     }
 
@@ -209,7 +274,7 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
 
     free(parentVertices);
     free(visitedVertices);
-    freePriorityQueue(priorityQueue);
+    freeCircularQueue(queue);
     return path; //return the path
 }
 
@@ -217,96 +282,59 @@ int* findConnections_BFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, i
     This function is a nonrecursive implementation of the DFS algorithm to determine whether if a connection exists between two IDs 
     in the social graph that is implemented as an adjacency matrix.
     Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+    scratch holds the stack and the visited stamps, so a caller answering many queries can reuse them; NULL allocates them for this search.
+
+    Like findConnections_BFS_AdjMatrix, each popped vertex scans only its own row, so the search costs O(V^2).
 
     By Aaron Barcelita.
 */
-int* findConnections_DFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int* pathLength)
+int* findConnections_DFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int* pathLength, SearchScratch *scratch)
 {
     if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) { //if the IDs are invalid or the same, return NULL
         return NULL;
     }
 
-    int i, j, currentVertex;
+    int i, currentVertex, numStacked = 0;
     bool connectionFound = false;
-
-    int* parentVertices = malloc(numVertices * sizeof(int));
-    if (parentVertices == NULL) {
-        printf("Memory allocation for parentVertices has failed. Terminating program...\n");
-        exit(-1);
-    }
-    memset(parentVertices, -1, numVertices * sizeof(int)); //set all elements to -1
-
-    bool* visitedVertices = calloc(numVertices, sizeof(bool));
-    if (visitedVertices == NULL) {
-        printf("Memory allocation for visitedVertices has failed. Terminating program...\n");
-        free(parentVertices);
-        exit(-1);
-    }
-
-    Stack *stack = createStack(); //check data_structures.c for the implementation of the stack and its operations
-    if (stack == NULL) {
-        printf("Memory allocation for stack has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        exit(-1);
+    bool* currentRow;
+    SearchScratch *ownScratch = NULL;
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_DFS); //check data_structures.c for the implementation of createSearchScratch
     }
+    beginSearch_Scratch(scratch);
+    int stamp = scratch->stamp;
+    int* visitedStamp = scratch->visitedStamp[0]; //visitedStamp[i] == stamp means vertex i was visited by this search
+    int* parentVertices = scratch->parentVertices[0]; //only read for visited vertices, so it is not cleared
+    int* stack = scratch->frontier[0]; //each vertex is pushed at most once, so numVertices entries are enough
 
     //initialize the search by visiting the starting vertex and pushing it onto the stack
-    push(stack, ID1);
-    visitedVertices[ID1] = true;
+    stack[numStacked++] = ID1;
+    visitedStamp[ID1] = stamp;
+    parentVertices[ID1] = -1;
 
-    while(!isEmptyStack(stack)) {
-        currentVertex = pop(stack); //pop the top of the stack
+    while (numStacked > 0) {
+        currentVertex = stack[--numStacked]; //pop the top of the stack
         if (currentVertex == ID2) {
             connectionFound = true;
             break;
         }
-        //visit all the adjacent vertices of the current vertex
+        //visit all the adjacent vertices of the current vertex by scanning its row
+        currentRow = adjMatrix[currentVertex];
         for(i = 0; i < numVertices; i++) {
-            if (hasEdge_AdjMatrix(adjMatrix, numVertices, i, currentVertex) && !visitedVertices[i]) {
-                visitedVertices[i] = true; //mark the vertex as visited
+            if (currentRow[i] && visitedStamp[i] != stamp && adjMatrix[i][currentVertex] && i != currentVertex) {
+                visitedStamp[i] = stamp; //mark the vertex as visited
                 parentVertices[i] = currentVertex; //set the parent of the vertex
-                push(stack, i); //push the vertex onto the stack
+                stack[numStacked++] = i; //push the vertex onto the stack
             }
         }
     }
 
-    if (!connectionFound) { //if no connection is found, free the memory and return NULL
-        free(parentVertices);
-        free(visitedVertices);
-        freeStack(stack);
-        return NULL;
+    int* path = NULL;
+    if (connectionFound) {
+        path = reconstructPath(parentVertices, ID2, pathLength); //check data_structures.c for the implementation of reconstructPath
     }
-
-    /*
-        Reconstruct the path from the destination vertex to the source vertex using the parent array.
-        The path is stored in an array of integers, and the length of the path is stored in the pathLength variable.
-        There is a need to trace back from ID2 to ID1 to determine the path because we only keep track of the parent of each vertex.
-    */
-    *pathLength = 0;
-    for (i = ID2; i != -1; i = parentVertices[i]) {
-        (*pathLength)++; //count the number of vertices in the path
-    }
-
-    int* path = malloc(*pathLength * sizeof(int));
-    if (path == NULL) {
-        printf("Memory allocation for path has failed. Terminating program...\n");
-        free(parentVertices);
-        free(visitedVertices);
-        freeStack(stack);
-        exit(-1);
-    }
-
-    i = ID2;
-    for(j = *pathLength - 1; j >= 0; j--) { //store the path in reverse order
-        path[j] = i; //store the current vertex in the path array
-        i = parentVertices[i]; //move to the parent vertex
-    }
-
-    free(parentVertices);
-    free(visitedVertices);
-    freeStack(stack);
-    return path; //return the path
+    freeSearchScratch(ownScratch);
+    return path;
 }
 
 /*
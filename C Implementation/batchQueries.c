@@ -0,0 +1,601 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include "data_structures.h"
+
+/*
+    Batch mode: answers a whole file of connection queries without the menu.
+
+    The query file holds one "ID1 ID2" pair per line. For every pair, in the same order, the output file gets the line
+        ID1 ID2 length v0 v1 ... vk
+    where length is the number of friendships on the path v0 = ID1, ..., vk = ID2, or the line "ID1 ID2 -1" if there is no connection.
+    A line that is not a pair of IDs is reported and gets no answer, and blank lines are ignored; the other queries are still answered.
+
+    The queries are read, answered and written BATCH_CHUNK_SIZE at a time, so the memory used does not grow with the size of the file.
+    With BFS, the queries of a chunk that share ID1 are answered by a single search that runs until all of their ID2s are reached,
+    and every search reuses the same scratch arrays instead of allocating and clearing O(V) arrays per query. The other methods
+    answer each query with its own search, which also runs on scratch arrays kept by the worker (SearchScratch).
+    The paths are the same as the ones from findConnections_BFS_*. On a relabeled graph, the searches run on the new IDs, as those
+    of findConnections_GraphHandle do, and only the IDs of a chunk and of its paths are mapped.
+
+    The graph is only read while the queries are answered, so a chunk is split into work items (one per search) that a pool of
+    worker threads answers in parallel, each with its own scratch arrays. Every worker starts with an equal share of the items
+    in its own deque and, once its deque is empty, steals items from the others, so a few long searches do not leave the other
+    threads idle. The answers of a chunk are written only after all of them are ready, in the order of the query file,
+    so the output is the same for any number of threads.
+*/
+
+#define BATCH_CHUNK_SIZE 4096
+#define BATCH_LINE_LENGTH 256 //longest query line read at once, far more than two IDs need
+
+/*
+    Arrays reused by every search of a batch.
+    Instead of clearing visitedStamp before each search, every search gets a new stamp, and a vertex counts as visited
+    only if its entry equals the current stamp. The arrays are only cleared when the stamp would overflow.
+*/
+typedef struct QueryScratchTag {
+    int numVertices;
+    int stamp;
+    int *visitedStamp;
+    int *targetStamp; //targetStamp[v] == stamp means v is an ID2 of the current search that has not been reached yet
+    int *parentVertices;
+    int *queue;
+    int *neighbors;
+    int *targets; //the ID2s of the queries answered by one search, at most BATCH_CHUNK_SIZE
+    SearchScratch *search; //the arrays of every other method, which answers each query with its own search
+    int id; //index of the worker that owns this scratch space
+    int *pathVertices; //paths found by this worker for the current chunk
+    int pathCount;
+    int pathCapacity;
+    long long numSearches;
+} QueryScratch;
+
+/*
+    A chunk of queries and their answers. The path of query q is stored in the pathVertices of worker pathOwners[q],
+    from pathStarts[q], with pathLengths[q] vertices, where a length of 0 means no connection.
+    Work item i is made of the queries order[itemStarts[i]] to order[itemStarts[i + 1] - 1].
+*/
+typedef struct QueryChunkTag {
+    int numQueries;
+    int sources[BATCH_CHUNK_SIZE];
+    int targets[BATCH_CHUNK_SIZE];
+    int order[BATCH_CHUNK_SIZE]; //query indices sorted by source
+    uint64_t sortKeys[BATCH_CHUNK_SIZE];
+    int pathOwners[BATCH_CHUNK_SIZE];
+    int pathStarts[BATCH_CHUNK_SIZE];
+    int pathLengths[BATCH_CHUNK_SIZE];
+    int itemStarts[BATCH_CHUNK_SIZE + 1];
+    int numItems;
+} QueryChunk;
+
+/*
+    A worker thread of the pool and its deque of work items.
+    The worker takes items from the bottom of its own deque, while other workers steal from the top.
+*/
+typedef struct BatchWorkerTag {
+    pthread_t thread;
+    QueryScratch *scratch;
+    pthread_mutex_t dequeLock;
+    int deque[BATCH_CHUNK_SIZE];
+    int dequeTop;
+    int dequeBottom;
+    struct BatchPoolTag *pool;
+} BatchWorker;
+
+/*
+    A pool of worker threads that stay alive for the whole batch. The main thread hands them a chunk by increasing generation,
+    and waits until workersDone reaches numThreads. With a single thread, chunks are answered on the main thread instead.
+*/
+typedef struct BatchPoolTag {
+    int numThreads;
+    BatchWorker *workers;
+    GraphHandle *handle;
+    int method;
+    QueryChunk *chunk;
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    int generation;
+    int workersDone;
+    bool shuttingDown;
+} BatchPool;
+
+/*
+    This function creates the scratch arrays for searches with the given method on a graph with numVertices vertices.
+    Only BFS uses the arrays of QueryScratch itself; every other method gets a SearchScratch.
+*/
+QueryScratch* createQueryScratch(int numVertices, int method, int id)
+{
+    QueryScratch *scratch = calloc(1, sizeof(QueryScratch));
+    if (scratch == NULL) {
+        printf("Memory allocation for query scratch space has failed. Terminating program...\n");
+        exit(-1);
+    }
+    scratch->numVertices = numVertices;
+    scratch->id = id;
+    if (method != SEARCH_BFS) {
+        scratch->search = createSearchScratch(numVertices, method); //check data_structures.c for the implementation of createSearchScratch
+        return scratch;
+    }
+    scratch->visitedStamp = calloc(numVertices, sizeof(int));
+    scratch->targetStamp = calloc(numVertices, sizeof(int));
+    scratch->parentVertices = malloc(numVertices * sizeof(int));
+    scratch->queue = malloc(numVertices * sizeof(int));
+    scratch->neighbors = malloc(numVertices * sizeof(int));
+    scratch->targets = malloc(BATCH_CHUNK_SIZE * sizeof(int));
+    if (scratch->visitedStamp == NULL || scratch->targetStamp == NULL || scratch->parentVertices == NULL
+        || scratch->queue == NULL || scratch->neighbors == NULL || scratch->targets == NULL) {
+        printf("Memory allocation for query scratch space has failed. Terminating program...\n");
+        exit(-1);
+    }
+    return scratch;
+}
+
+void freeQueryScratch(QueryScratch *scratch)
+{
+    if (scratch != NULL) {
+        free(scratch->visitedStamp);
+        free(scratch->targetStamp);
+        free(scratch->parentVertices);
+        free(scratch->queue);
+        free(scratch->neighbors);
+        free(scratch->targets);
+        free(scratch->pathVertices);
+        freeSearchScratch(scratch->search);
+        free(scratch);
+    }
+}
+
+/*
+    This function starts a new search, which marks every vertex as not visited in O(1) time.
+*/
+void beginSearch_Batch(QueryScratch *scratch)
+{
+    if (scratch->stamp == INT_MAX) {
+        memset(scratch->visitedStamp, 0, scratch->numVertices * sizeof(int));
+        memset(scratch->targetStamp, 0, scratch->numVertices * sizeof(int));
+        scratch->stamp = 0;
+    }
+    scratch->stamp++;
+}
+
+/*
+    This function runs one BFS from source that stops as soon as every vertex in targets has been reached.
+    Source and targets use the IDs of the graph, i.e., the new IDs if the vertices were relabeled, so no friend is mapped.
+    Afterwards, parentVertices leads back to source from every reached target, with the same parents as findConnections_BFS_*.
+*/
+void searchFromSource_Batch(GraphHandle *handle, QueryScratch *scratch, int source, int *targets, int numTargets)
+{
+    int i, k, count, current, next, remaining = 0;
+    int front = 0, back = 0;
+
+    beginSearch_Batch(scratch);
+    for (i = 0; i < numTargets; i++) {
+        if (targets[i] != source && scratch->targetStamp[targets[i]] != scratch->stamp) {
+            scratch->targetStamp[targets[i]] = scratch->stamp;
+            remaining++;
+        }
+    }
+
+    scratch->visitedStamp[source] = scratch->stamp;
+    scratch->parentVertices[source] = -1;
+    scratch->queue[back++] = source;
+    while (front < back && remaining > 0) {
+        current = scratch->queue[front++];
+        count = collectGraphNeighbors_GraphHandle(handle, current, scratch->neighbors); //ascending, as findConnections_BFS_* visits them
+        for (k = 0; k < count; k++) {
+            next = scratch->neighbors[k];
+            if (scratch->visitedStamp[next] != scratch->stamp) {
+                scratch->visitedStamp[next] = scratch->stamp;
+                scratch->parentVertices[next] = current;
+                scratch->queue[back++] = next; //every vertex is queued at most once, so the queue never wraps around
+                if (scratch->targetStamp[next] == scratch->stamp) {
+                    scratch->targetStamp[next] = 0;
+                    remaining--;
+                }
+            }
+        }
+    }
+}
+
+/*
+    This function makes room for count more path vertices in the scratch space of a worker.
+*/
+void reservePath_Batch(QueryScratch *scratch, int count)
+{
+    if (scratch->pathCount + count > scratch->pathCapacity) {
+        while (scratch->pathCount + count > scratch->pathCapacity) {
+            scratch->pathCapacity = scratch->pathCapacity > 0 ? scratch->pathCapacity * 2 : 4 * BATCH_CHUNK_SIZE;
+        }
+        scratch->pathVertices = realloc(scratch->pathVertices, scratch->pathCapacity * sizeof(int));
+        if (scratch->pathVertices == NULL) {
+            printf("Memory allocation for query results has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+}
+
+/*
+    This function stores the path to target of the last search from source as the answer of query q.
+    Source and target use the IDs of the graph, and the path is stored with the IDs of the file through newToOld, if given.
+*/
+void storeSearchPath_Batch(QueryChunk *chunk, QueryScratch *scratch, int *newToOld, int q, int source, int target)
+{
+    int v, length = 0;
+
+    chunk->pathOwners[q] = scratch->id;
+    chunk->pathStarts[q] = scratch->pathCount;
+    chunk->pathLengths[q] = 0;
+    if (target == source || scratch->visitedStamp[target] != scratch->stamp) {
+        return; //same as findConnections_BFS_*, a person is not connected to themselves
+    }
+    for (v = target; v != -1; v = scratch->parentVertices[v]) {
+        length++;
+    }
+    reservePath_Batch(scratch, length);
+    chunk->pathLengths[q] = length;
+    for (v = target; v != -1; v = scratch->parentVertices[v]) {
+        scratch->pathVertices[scratch->pathCount + --length] = newToOld != NULL ? newToOld[v] : v;
+    }
+    scratch->pathCount += chunk->pathLengths[q];
+}
+
+/*
+    This function sorts the queries of a chunk by source into order, keeping queries with the same source in file order.
+    Each query is sorted as one 64-bit key, its source in the high half and its index in the low half.
+*/
+void sortQueriesBySource_Batch(QueryChunk *chunk)
+{
+    uint64_t *keys = chunk->sortKeys;
+    int q;
+    for (q = 0; q < chunk->numQueries; q++) {
+        keys[q] = ((uint64_t)(uint32_t)chunk->sources[q] << 32) | (uint32_t)q;
+    }
+    qsort(keys, chunk->numQueries, sizeof(uint64_t), compareKeys64);
+    for (q = 0; q < chunk->numQueries; q++) {
+        chunk->order[q] = (int)(keys[q] & 0xffffffffu);
+    }
+}
+
+/*
+    This function splits the sorted queries of a chunk into work items.
+    With BFS, an item is all the queries with the same source, since one search answers them; otherwise, every query is its own item.
+*/
+void splitWorkItems_Batch(QueryChunk *chunk, int method)
+{
+    int i;
+    chunk->numItems = 0;
+    for (i = 0; i < chunk->numQueries; i++) {
+        if (i == 0 || method != SEARCH_BFS || chunk->sources[chunk->order[i]] != chunk->sources[chunk->order[i - 1]]) {
+            chunk->itemStarts[chunk->numItems++] = i;
+        }
+    }
+    chunk->itemStarts[chunk->numItems] = chunk->numQueries;
+}
+
+/*
+    This function answers the queries of work item i of a chunk with the given method, using the scratch space of one worker.
+    All the queries of an item have the same source.
+*/
+void answerWorkItem_Batch(GraphHandle *handle, QueryScratch *scratch, QueryChunk *chunk, int method, int item)
+{
+    int i, q, pathLength, *path;
+    int first = chunk->itemStarts[item];
+    int last = chunk->itemStarts[item + 1];
+    int source = chunk->sources[chunk->order[first]];
+    int numVertices = handle->numVertices;
+
+    if (method == SEARCH_BFS && source >= 0 && source < numVertices) {
+        //the search runs on the IDs of the graph, so on a relabeled graph the IDs are mapped once here and in the stored paths
+        int *oldToNew = handle->oldToNew;
+        int numTargets = 0;
+        if (oldToNew != NULL) {
+            source = oldToNew[source];
+        }
+        for (i = first; i < last; i++) {
+            q = chunk->order[i];
+            if (chunk->targets[q] >= 0 && chunk->targets[q] < numVertices) {
+                scratch->targets[numTargets++] = oldToNew != NULL ? oldToNew[chunk->targets[q]] : chunk->targets[q];
+            }
+        }
+        searchFromSource_Batch(handle, scratch, source, scratch->targets, numTargets);
+        scratch->numSearches++;
+        for (i = first; i < last; i++) {
+            q = chunk->order[i];
+            if (chunk->targets[q] >= 0 && chunk->targets[q] < numVertices) {
+                storeSearchPath_Batch(chunk, scratch, handle->newToOld, q, source,
+                                      oldToNew != NULL ? oldToNew[chunk->targets[q]] : chunk->targets[q]);
+            } else {
+                chunk->pathLengths[q] = 0;
+            }
+        }
+        return;
+    }
+
+    //the other methods are point-to-point, so each query gets its own search, on the arrays of this worker
+    for (i = first; i < last; i++) {
+        q = chunk->order[i];
+        path = findConnectionsWithScratch_GraphHandle(handle, method, source, chunk->targets[q], &pathLength, scratch->search);
+        scratch->numSearches++;
+        chunk->pathOwners[q] = scratch->id;
+        chunk->pathStarts[q] = scratch->pathCount;
+        chunk->pathLengths[q] = 0;
+        if (path != NULL) {
+            reservePath_Batch(scratch, pathLength);
+            memcpy(scratch->pathVertices + scratch->pathCount, path, pathLength * sizeof(int));
+            chunk->pathLengths[q] = pathLength;
+            scratch->pathCount += pathLength;
+            free(path);
+        }
+    }
+}
+
+/*
+    This function takes the next work item for a worker: from the bottom of its own deque, or else from the top of another worker's deque.
+    Returns -1 when every deque is empty. No items are added while a chunk is being answered, so the chunk is then done.
+*/
+int takeWorkItem_Batch(BatchPool *pool, BatchWorker *worker)
+{
+    int i, item = -1;
+    BatchWorker *victim;
+
+    pthread_mutex_lock(&worker->dequeLock);
+    if (worker->dequeBottom > worker->dequeTop) {
+        item = worker->deque[--worker->dequeBottom];
+    }
+    pthread_mutex_unlock(&worker->dequeLock);
+
+    for (i = 1; item == -1 && i < pool->numThreads; i++) {
+        victim = &pool->workers[(worker->scratch->id + i) % pool->numThreads];
+        pthread_mutex_lock(&victim->dequeLock);
+        if (victim->dequeBottom > victim->dequeTop) {
+            item = victim->deque[victim->dequeTop++];
+        }
+        pthread_mutex_unlock(&victim->dequeLock);
+    }
+    return item;
+}
+
+/*
+    This function is run by every worker thread. It waits for a chunk, answers work items until none are left, reports back, and repeats.
+*/
+void* runWorker_Batch(void *argument)
+{
+    BatchWorker *worker = argument;
+    BatchPool *pool = worker->pool;
+    int item, generation = 0;
+
+    while (true) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == generation && !pool->shuttingDown) {
+            pthread_cond_wait(&pool->workReady, &pool->lock);
+        }
+        if (pool->shuttingDown) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        while ((item = takeWorkItem_Batch(pool, worker)) != -1) {
+            answerWorkItem_Batch(pool->handle, worker->scratch, pool->chunk, pool->method, item);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->workersDone == pool->numThreads) {
+            pthread_cond_signal(&pool->workDone);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/*
+    This function creates a pool of numThreads workers, each with its own scratch space, for answering queries on a graph.
+*/
+BatchPool* createBatchPool(int numThreads, GraphHandle *handle, int method)
+{
+    int i;
+    BatchPool *pool = malloc(sizeof(BatchPool));
+    if (pool != NULL) {
+        pool->workers = malloc(numThreads * sizeof(BatchWorker));
+    }
+    if (pool == NULL || pool->workers == NULL) {
+        printf("Memory allocation for the worker threads has failed. Terminating program...\n");
+        exit(-1);
+    }
+    pool->numThreads = numThreads;
+    pool->handle = handle;
+    pool->method = method;
+    pool->chunk = NULL;
+    pool->generation = 0;
+    pool->workersDone = 0;
+    pool->shuttingDown = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workReady, NULL);
+    pthread_cond_init(&pool->workDone, NULL);
+
+    for (i = 0; i < numThreads; i++) {
+        pool->workers[i].scratch = createQueryScratch(handle->numVertices, method, i);
+        pool->workers[i].pool = pool;
+        pool->workers[i].dequeTop = 0;
+        pool->workers[i].dequeBottom = 0;
+        pthread_mutex_init(&pool->workers[i].dequeLock, NULL);
+    }
+    for (i = 0; numThreads > 1 && i < numThreads; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, runWorker_Batch, &pool->workers[i]) != 0) {
+            printf("Creating worker thread %d has failed. Terminating program...\n", i);
+            exit(-1);
+        }
+    }
+    return pool;
+}
+
+/*
+    This function answers every query of a chunk with the pool, and returns once all of them are answered.
+*/
+void answerChunk_Batch(BatchPool *pool, QueryChunk *chunk)
+{
+    int i, w;
+    BatchWorker *worker;
+
+    //deal the items out in turn, so every worker starts with a mix of sources
+    for (w = 0; w < pool->numThreads; w++) {
+        worker = &pool->workers[w];
+        worker->scratch->pathCount = 0;
+        worker->dequeTop = 0;
+        worker->dequeBottom = 0;
+        for (i = w; i < chunk->numItems; i += pool->numThreads) {
+            worker->deque[worker->dequeBottom++] = i;
+        }
+    }
+    pool->chunk = chunk;
+
+    if (pool->numThreads == 1) {
+        while ((i = takeWorkItem_Batch(pool, &pool->workers[0])) != -1) {
+            answerWorkItem_Batch(pool->handle, pool->workers[0].scratch, chunk, pool->method, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->workersDone = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->workReady);
+    while (pool->workersDone < pool->numThreads) {
+        pthread_cond_wait(&pool->workDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+    This function stops the worker threads and frees the pool. Returns the number of searches the workers ran.
+*/
+long long freeBatchPool(BatchPool *pool)
+{
+    int i;
+    long long numSearches = 0;
+
+    if (pool->numThreads > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->shuttingDown = true;
+        pthread_cond_broadcast(&pool->workReady);
+        pthread_mutex_unlock(&pool->lock);
+        for (i = 0; i < pool->numThreads; i++) {
+            pthread_join(pool->workers[i].thread, NULL);
+        }
+    }
+    for (i = 0; i < pool->numThreads; i++) {
+        numSearches += pool->workers[i].scratch->numSearches;
+        freeQueryScratch(pool->workers[i].scratch);
+        pthread_mutex_destroy(&pool->workers[i].dequeLock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workReady);
+    pthread_cond_destroy(&pool->workDone);
+    free(pool->workers);
+    free(pool);
+    return numSearches;
+}
+
+/*
+    This function reads up to BATCH_CHUNK_SIZE queries from the query file into a chunk, one per line.
+    A line that is not a pair of integers is reported with its line number and skipped, and counted in skippedLines, so the
+    rest of the chunk is still answered. lineNumber counts the lines read so far.
+    Returns false if the end of the file was reached without reading a query.
+*/
+bool readQueryChunk_Batch(FILE *fp, QueryChunk *chunk, long long *lineNumber, long long *skippedLines)
+{
+    char line[BATCH_LINE_LENGTH], extra;
+    int c, result;
+    chunk->numQueries = 0;
+    while (chunk->numQueries < BATCH_CHUNK_SIZE && fgets(line, sizeof(line), fp) != NULL) {
+        (*lineNumber)++;
+        if (strchr(line, '\n') == NULL) { //skip the rest of a long line, so that it is not read as the next one
+            while ((c = fgetc(fp)) != EOF && c != '\n');
+        }
+        result = sscanf(line, "%d %d %c", &chunk->sources[chunk->numQueries], &chunk->targets[chunk->numQueries], &extra);
+        if (result == 2) {
+            chunk->numQueries++;
+        } else if (result != EOF) { //EOF means the line is blank
+            printf("Line %lld of the query file is not a pair of IDs, so it is skipped.\n", *lineNumber);
+            (*skippedLines)++;
+        }
+    }
+    return chunk->numQueries > 0;
+}
+
+/*
+    This function writes the answers of a chunk to the output file, in the order of the query file.
+*/
+void writeQueryChunk_Batch(FILE *out, QueryChunk *chunk, BatchPool *pool)
+{
+    int q, k, *path;
+    for (q = 0; q < chunk->numQueries; q++) {
+        fprintf(out, "%d %d %d", chunk->sources[q], chunk->targets[q], chunk->pathLengths[q] - 1);
+        path = chunk->pathLengths[q] > 0 ? pool->workers[chunk->pathOwners[q]].scratch->pathVertices + chunk->pathStarts[q] : NULL;
+        for (k = 0; k < chunk->pathLengths[q]; k++) {
+            fprintf(out, " %d", path[k]);
+        }
+        fputc('\n', out);
+    }
+}
+
+/*
+    This function answers every query in the file at queryPath on a loaded graph with the given method, using numThreads worker threads,
+    and writes the answers to outputPath. Returns true if every line of the query file was a query and was answered.
+*/
+bool runBatchQueries(GraphHandle *handle, int method, int numThreads, char *queryPath, char *outputPath)
+{
+    FILE *fp = fopen(queryPath, "r");
+    if (fp == NULL) {
+        printf("Query file not found.\n");
+        return false;
+    }
+    FILE *out = fopen(outputPath, "w");
+    if (out == NULL) {
+        printf("Could not create %s.\n", outputPath);
+        fclose(fp);
+        return false;
+    }
+
+    QueryChunk *chunk = calloc(1, sizeof(QueryChunk));
+    if (chunk == NULL) {
+        printf("Memory allocation for query results has failed. Terminating program...\n");
+        exit(-1);
+    }
+    BatchPool *pool = createBatchPool(numThreads, handle, method);
+    long long numQueries = 0, numFound = 0, numSearches, lineNumber = 0, skippedLines = 0;
+    int q;
+    double startTime = getWallClockTime(), seconds;
+
+    while (readQueryChunk_Batch(fp, chunk, &lineNumber, &skippedLines)) {
+        sortQueriesBySource_Batch(chunk);
+        splitWorkItems_Batch(chunk, method);
+        answerChunk_Batch(pool, chunk);
+        writeQueryChunk_Batch(out, chunk, pool);
+        for (q = 0; q < chunk->numQueries; q++) {
+            numFound += chunk->pathLengths[q] > 0;
+        }
+        numQueries += chunk->numQueries;
+    }
+
+    numSearches = freeBatchPool(pool);
+    seconds = getWallClockTime() - startTime;
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    printf("Answered %lld queries (%lld connected) with %lld searches on %d threads in %.3f s (%.0f queries/s).\n",
+           numQueries, numFound, numSearches, numThreads, seconds, numQueries / seconds);
+    if (skippedLines > 0) {
+        printf("Skipped %lld lines of the query file that are not a pair of IDs.\n", skippedLines);
+    }
+
+    free(chunk);
+    fclose(fp);
+    fclose(out);
+    return skippedLines == 0;
+}
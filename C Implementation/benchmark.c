@@ -0,0 +1,589 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adjacencyMatrix.c"
+#include "adjacencyList.c"
+#include "adjacencyCSR.c"
+#include "adjacencyBitMatrix.c"
+#include "directionOptimizingBFS.c"
+#include "bidirectionalBFS.c"
+#include "parallelBFS.c"
+#include "multiSourceBFS.c"
+#include "edgeFileReader.c"
+#include "graphValidation.c"
+#include "graphSnapshot.c"
+#include "parallelGraphLoader.c"
+#include "matFileReader.c"
+#include "graphUpdates.c"
+#include "edgeStream.c"
+#include "graphHandle.c"
+#include "vertexOrdering.c"
+#include "mutualFriends.c"
+#include "data_structures.c"
+
+#if defined(_WIN32)
+#define PSAPI_VERSION 2 //GetProcessMemoryInfo from kernel32, so no extra library has to be linked
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/*
+    Non-interactive benchmark of every graph format and search method on the bundled data sets.
+
+    Build it the same way as main.c, e.g., gcc -O2 -pthread benchmark.c -o benchmark, and run it from this directory:
+        benchmark [--data DIR] [--datasets A,B,...] [--backends list,matrix,csr,bitmatrix] [--methods bfs,dfs,dobfs,bibfs,pbfs]
+                  [--queries N] [--seed S] [--threads N] [--orderings none,rcm,degree,bfs] [--format csv|json]
+                  [--output FILE] [--label TEXT] [--mutual N]
+
+    Each data set is loaded from DIR/<name>.txt, or DIR/<name>.mat if there is no .txt file, once for every format.
+    The same seeded list of random ID pairs is then run through every search method, and one result row is written
+    per data set, format and method with the load time, peak memory, path statistics and query latency percentiles.
+    The parallel BFS (pbfs) uses --threads threads, by default one per processor, so comparing its rows with the bfs rows
+    for a few thread counts shows how it scales against the serial search. A .txt file is also loaded into CSR form by that
+    many threads (check parallelGraphLoader.c), so the load_s of the csr rows shows how loading scales.
+    Every format is also loaded once per vertex ordering in --orderings, by default only none, and relabeled with it
+    (check vertexOrdering.c). The rows of an ordering give the time the relabeling took and the speedup of each method
+    over the same format with the original IDs, which is 0 when none is not in the list. Their found stays the same, and so
+    does path_length_sum except for dfs, whose paths depend on the order of the IDs. Relabeling rebuilds an adjacency list
+    with the nodes of each vertex next to each other, so the list of the none rows is rebuilt the same way (repackAdjList_Benchmark)
+    and the speedups only measure the ordering.
+    With --mutual N, N seeded pairs of the BENCHMARK_MUTUAL_HUBS friendliest people are also run through the mutual friends
+    search (check mutualFriends.c), once with its scalar version and once with its vector version, in the rows of methods
+    mutual_scalar and mutual_vector. Their found is the number of pairs with a mutual friend, path_length_sum the number of
+    mutual friends, and the speedup of the vector rows is over the scalar rows of the same format and ordering.
+    The bfs and dobfs rows also give the neighbor checks of all their queries in edges_examined, counted in an untimed second
+    run of the direction-optimizing BFS, top-down only for bfs (check directionOptimizingBFS.c); it is empty for the other methods.
+    Snapshots are never used, so load times always include parsing. Progress goes to the console and results go to FILE.
+*/
+
+#define BENCHMARK_MAX_DATASETS 32
+#define BENCHMARK_MUTUAL_HUBS 64 //the people with the most friends, whose pairs the mutual friends search is timed on
+
+char *benchmarkDefaultDatasets[] = {"Caltech36", "Trinity100", "Rice31", "Harvard1", "Stanford3"};
+
+typedef struct BenchmarkOptionsTag {
+    char *dataDirectory;
+    char *outputPath;
+    char *label; //written in every row, e.g., to tell builds apart
+    bool json;
+    int numQueries;
+    uint64_t seed;
+    int numThreads; //threads of the parallel BFS and of the CSR loader
+    int numMutualPairs; //pairs of hubs for the mutual friends search, 0 to skip it
+    bool backends[GRAPH_NUM_FORMATS];
+    bool methods[SEARCH_NUM_METHODS];
+    bool orderings[GRAPH_NUM_ORDERS];
+    char *datasets[BENCHMARK_MAX_DATASETS];
+    int numDatasets;
+} BenchmarkOptions;
+
+/*
+    One result row, i.e., the measurements of one method on one data set, format and ordering.
+*/
+typedef struct BenchmarkRowTag {
+    char *dataset;
+    GraphHandle *graph;
+    int backend;
+    char *method;
+    double loadSeconds;
+    long peakRSS;
+    int numQueries;
+    int found;
+    long long pathLengthSum;
+    double *latencies; //sorted
+    double totalSeconds;
+    int numThreads;
+    int ordering;
+    double reorderSeconds;
+    double speedup;
+    long long edgesExamined; //neighbor checks over all queries, or -1 if the method does not count them
+} BenchmarkRow;
+
+/*
+    This function returns the highest resident memory of the process, in kilobytes, since it started or since the last resetPeakRSS.
+*/
+long getPeakRSS()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (long)(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    char line[256];
+    long peak = 0;
+    FILE *fp = fopen("/proc/self/status", "r"); //Linux, where the peak can be reset
+    if (fp != NULL) {
+        while (fgets(line, sizeof(line), fp) != NULL) {
+            if (sscanf(line, "VmHWM: %ld", &peak) == 1) {
+                break;
+            }
+        }
+        fclose(fp);
+        if (peak > 0) {
+            return peak;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024; //bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/*
+    This function starts a new peak for getPeakRSS, so that each format is measured on its own.
+    Only Linux allows this; elsewhere the peak stays the highest of the whole run.
+*/
+void resetPeakRSS()
+{
+#if defined(__linux__)
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+    if (fp != NULL) {
+        fputs("5", fp);
+        fclose(fp);
+    }
+#endif
+}
+
+int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    This function returns the p-th percentile (0 to 1) of sorted values, using the nearest-rank method.
+*/
+double getPercentile(double *sortedValues, int count, double p)
+{
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sortedValues[rank > count ? count - 1 : rank - 1];
+}
+
+/*
+    This function turns a comma-separated list of names into flags, e.g., "csr,list" for the backends.
+    Returns false if a name is not in names.
+*/
+bool parseNameList(char *list, char **names, int numNames, bool *selected)
+{
+    char copy[256], *token;
+    int i;
+
+    for (i = 0; i < numNames; i++) {
+        selected[i] = false;
+    }
+    snprintf(copy, sizeof(copy), "%s", list);
+    for (token = strtok(copy, ","); token != NULL; token = strtok(NULL, ",")) {
+        i = findNameIndex(token, names, numNames);
+        if (i == -1) {
+            printf("Unknown name: %s\n", token);
+            return false;
+        }
+        selected[i] = true;
+    }
+    return true;
+}
+
+void printUsage_Benchmark()
+{
+    printf("Usage: benchmark [--data DIR] [--datasets A,B,...] [--backends list,matrix,csr,bitmatrix]\n"
+           "                 [--methods bfs,dfs,dobfs,bibfs,pbfs] [--queries N] [--seed S]\n"
+           "                 [--threads N] [--orderings none,rcm,degree,bfs] [--format csv|json]\n"
+           "                 [--output FILE] [--label TEXT] [--mutual N]\n");
+}
+
+/*
+    This function reads the command-line options into options, starting from the defaults.
+    Returns false if an option is invalid.
+*/
+bool parseOptions_Benchmark(int argc, char **argv, BenchmarkOptions *options)
+{
+    int i;
+    char *value, *token;
+
+    options->dataDirectory = "../data/data";
+    options->outputPath = NULL;
+    options->label = "";
+    options->json = false;
+    options->numQueries = 100;
+    options->seed = 12345;
+    options->numThreads = getNumProcessors();
+    options->numMutualPairs = 0;
+    for (i = 0; i < GRAPH_NUM_FORMATS; i++) {
+        options->backends[i] = true;
+    }
+    for (i = 0; i < SEARCH_NUM_METHODS; i++) {
+        options->methods[i] = true;
+    }
+    for (i = 0; i < GRAPH_NUM_ORDERS; i++) {
+        options->orderings[i] = i == GRAPH_ORDER_NONE;
+    }
+    options->numDatasets = sizeof(benchmarkDefaultDatasets) / sizeof(benchmarkDefaultDatasets[0]);
+    for (i = 0; i < options->numDatasets; i++) {
+        options->datasets[i] = benchmarkDefaultDatasets[i];
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printUsage_Benchmark();
+            return false;
+        }
+        value = argv[++i];
+        if (strcmp(argv[i - 1], "--data") == 0) {
+            options->dataDirectory = value;
+        } else if (strcmp(argv[i - 1], "--output") == 0) {
+            options->outputPath = value;
+        } else if (strcmp(argv[i - 1], "--label") == 0) {
+            options->label = value;
+        } else if (strcmp(argv[i - 1], "--format") == 0 && (strcmp(value, "csv") == 0 || strcmp(value, "json") == 0)) {
+            options->json = strcmp(value, "json") == 0;
+        } else if (strcmp(argv[i - 1], "--queries") == 0 && atoi(value) > 0) {
+            options->numQueries = atoi(value);
+        } else if (strcmp(argv[i - 1], "--threads") == 0 && atoi(value) > 0) {
+            options->numThreads = atoi(value);
+        } else if (strcmp(argv[i - 1], "--mutual") == 0 && atoi(value) >= 0) {
+            options->numMutualPairs = atoi(value);
+        } else if (strcmp(argv[i - 1], "--seed") == 0) {
+            options->seed = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--backends") == 0) {
+            if (!parseNameList(value, graphFormatNames, GRAPH_NUM_FORMATS, options->backends)) {
+                return false;
+            }
+        } else if (strcmp(argv[i - 1], "--methods") == 0) {
+            if (!parseNameList(value, searchMethodNames, SEARCH_NUM_METHODS, options->methods)) {
+                return false;
+            }
+        } else if (strcmp(argv[i - 1], "--orderings") == 0) {
+            if (!parseNameList(value, vertexOrderNames, GRAPH_NUM_ORDERS, options->orderings)) {
+                return false;
+            }
+        } else if (strcmp(argv[i - 1], "--datasets") == 0) {
+            options->numDatasets = 0;
+            for (token = strtok(value, ","); token != NULL && options->numDatasets < BENCHMARK_MAX_DATASETS; token = strtok(NULL, ",")) {
+                options->datasets[options->numDatasets++] = token;
+            }
+        } else {
+            printUsage_Benchmark();
+            return false;
+        }
+    }
+    if (options->outputPath == NULL) {
+        options->outputPath = options->json ? "benchmark.json" : "benchmark.csv";
+    }
+    return true;
+}
+
+/*
+    This function prints a result row to the console and writes it to out, in the format of options.
+*/
+void writeRow_Benchmark(FILE *out, BenchmarkOptions *options, BenchmarkRow *row, int numRows)
+{
+    double mean = row->totalSeconds / row->numQueries;
+    double p50 = getPercentile(row->latencies, row->numQueries, 0.50);
+    double p99 = getPercentile(row->latencies, row->numQueries, 0.99);
+    double max = row->latencies[row->numQueries - 1];
+    char edgesExamined[32] = "";
+
+    if (row->edgesExamined >= 0) {
+        snprintf(edgesExamined, sizeof(edgesExamined), "%lld", row->edgesExamined);
+    }
+
+    printf("%-6s load %.3f s, reorder %.3f s, peak %ld KB, %d/%d found, p50 %.1f us, p99 %.1f us, speedup %.2f\n",
+           row->method, row->loadSeconds, row->reorderSeconds, row->peakRSS, row->found, row->numQueries, p50 * 1e6, p99 * 1e6,
+           row->speedup);
+    if (options->json) {
+        fprintf(out, "%s  {\"label\": \"%s\", \"dataset\": \"%s\", \"vertices\": %d, \"edges\": %d, \"backend\": \"%s\", "
+                     "\"method\": \"%s\", \"load_s\": %.6f, \"peak_rss_kb\": %ld, \"queries\": %d, \"found\": %d, "
+                     "\"path_length_sum\": %lld, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"threads\": %d, "
+                     "\"ordering\": \"%s\", \"reorder_s\": %.6f, \"speedup\": %.3f, \"edges_examined\": %s}",
+                numRows > 0 ? ",\n" : "", options->label, row->dataset, row->graph->numVertices, row->graph->numEdges,
+                graphFormatNames[row->backend], row->method, row->loadSeconds, row->peakRSS, row->numQueries,
+                row->found, row->pathLengthSum, mean * 1e6, p50 * 1e6, p99 * 1e6, max * 1e6, row->numThreads,
+                vertexOrderNames[row->ordering], row->reorderSeconds, row->speedup, edgesExamined[0] != '\0' ? edgesExamined : "null");
+    } else {
+        fprintf(out, "%s,%s,%d,%d,%s,%s,%.6f,%ld,%d,%d,%lld,%.3f,%.3f,%.3f,%.3f,%d,%s,%.6f,%.3f,%s\n",
+                options->label, row->dataset, row->graph->numVertices, row->graph->numEdges,
+                graphFormatNames[row->backend], row->method, row->loadSeconds, row->peakRSS, row->numQueries,
+                row->found, row->pathLengthSum, mean * 1e6, p50 * 1e6, p99 * 1e6, max * 1e6, row->numThreads,
+                vertexOrderNames[row->ordering], row->reorderSeconds, row->speedup, edgesExamined);
+    }
+    fflush(out); //keep the finished rows if the run is stopped early
+}
+
+/*
+    This function picks the pairs of people for the mutual friends search: numPairs seeded pairs of different people among
+    the BENCHMARK_MUTUAL_HUBS with the most friends in graph, whose search takes the longest.
+    Returns the highest number of friends, which sizes the friend buffer of the adjacency list search.
+*/
+int pickMutualPairs_Benchmark(GraphHandle *graph, uint64_t seed, int numPairs, int *firsts, int *seconds)
+{
+    int i, k, v, degree, numHubs = 0;
+    int hubs[BENCHMARK_MUTUAL_HUBS], hubDegrees[BENCHMARK_MUTUAL_HUBS];
+    int *buffer = malloc((graph->numVertices > 0 ? graph->numVertices : 1) * sizeof(int));
+    if (buffer == NULL) {
+        printf("Memory allocation for the benchmark has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    //keep the hubs sorted by decreasing degree, inserting each vertex that beats the last one
+    for (v = 0; v < graph->numVertices; v++) {
+        degree = collectNeighbors_GraphHandle(graph, v, buffer);
+        if (numHubs == BENCHMARK_MUTUAL_HUBS && degree <= hubDegrees[numHubs - 1]) {
+            continue;
+        }
+        k = numHubs < BENCHMARK_MUTUAL_HUBS ? numHubs++ : numHubs - 1;
+        while (k > 0 && hubDegrees[k - 1] < degree) {
+            hubs[k] = hubs[k - 1];
+            hubDegrees[k] = hubDegrees[k - 1];
+            k--;
+        }
+        hubs[k] = v;
+        hubDegrees[k] = degree;
+    }
+    free(buffer);
+
+    uint64_t state = seed;
+    for (i = 0; i < numPairs; i++) {
+        firsts[i] = hubs[randomBelow(&state, numHubs)];
+        do {
+            seconds[i] = hubs[randomBelow(&state, numHubs)];
+        } while (seconds[i] == firsts[i] && numHubs > 1);
+    }
+    return numHubs > 0 ? hubDegrees[0] : 0;
+}
+
+/*
+    This function rebuilds the adjacency list of graph through CSR form, as reorderGraphHandle does for every other ordering,
+    so its nodes are packed per vertex and its friends sorted like those of a relabeled list.
+*/
+void repackAdjList_Benchmark(GraphHandle *graph)
+{
+    CSRGraph *csrGraph = convertAdjListToCSR(graph->adjList, graph->numVertices);
+    freeAdjacencyList(graph->adjList, graph->numVertices);
+    graph->adjList = convertCSRToAdjList(csrGraph);
+    freeCSRGraph(csrGraph);
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    GraphHandle graph;
+    char path[600];
+    int d, backend, ordering, method, q, pathLength, numVertices, found, count, numRows = 0;
+    int mutualCounts[2];
+    long long pathLengthSum;
+    double loadSeconds, reorderSeconds, startTime, totalSeconds, scalarMean = 0;
+    double originalMeans[SEARCH_NUM_METHODS]; //mean latency of each method with the original IDs, for the speedups
+    BenchmarkRow row;
+    FILE *fp, *out;
+
+    if (!parseOptions_Benchmark(argc, argv, &options)) {
+        return 1;
+    }
+    out = fopen(options.outputPath, "w");
+    if (out == NULL) {
+        printf("Could not create %s.\n", options.outputPath);
+        return 1;
+    }
+    if (options.json) {
+        fprintf(out, "[\n");
+    } else {
+        fprintf(out, "label,dataset,vertices,edges,backend,method,load_s,peak_rss_kb,queries,found,path_length_sum,"
+                     "mean_us,p50_us,p99_us,max_us,threads,ordering,reorder_s,speedup,edges_examined\n");
+    }
+
+    int *sources = malloc(options.numQueries * sizeof(int));
+    int *targets = malloc(options.numQueries * sizeof(int));
+    int numLatencies = options.numQueries > options.numMutualPairs ? options.numQueries : options.numMutualPairs;
+    double *latencies = malloc(numLatencies * sizeof(double));
+    int *mutualFirsts = malloc((options.numMutualPairs > 0 ? options.numMutualPairs : 1) * sizeof(int));
+    int *mutualSeconds = malloc((options.numMutualPairs > 0 ? options.numMutualPairs : 1) * sizeof(int));
+    int *common = NULL, *friends = NULL;
+    if (sources == NULL || targets == NULL || latencies == NULL || mutualFirsts == NULL || mutualSeconds == NULL) {
+        printf("Memory allocation for the benchmark has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    for (d = 0; d < options.numDatasets; d++) {
+        //prefer the .txt file, and fall back to the .mat file for the data sets that only come in that format
+        snprintf(path, sizeof(path), "%s/%s.txt", options.dataDirectory, options.datasets[d]);
+        fp = fopen(path, "rb");
+        if (fp != NULL) {
+            fclose(fp);
+        } else {
+            snprintf(path, sizeof(path), "%s/%s.mat", options.dataDirectory, options.datasets[d]);
+            if (!isMatFile(path)) {
+                printf("Skipping %s: no .txt or .mat file in %s.\n", options.datasets[d], options.dataDirectory);
+                continue;
+            }
+        }
+
+        numVertices = 0;
+        for (backend = 0; backend < GRAPH_NUM_FORMATS; backend++) {
+            if (!options.backends[backend]) {
+                continue;
+            }
+            for (method = 0; method < SEARCH_NUM_METHODS; method++) {
+                originalMeans[method] = 0;
+            }
+            for (ordering = 0; ordering < GRAPH_NUM_ORDERS; ordering++) {
+                if (!options.orderings[ordering]) {
+                    continue;
+                }
+                printf("\n=== %s, %s, %s order ===\n", options.datasets[d], graphFormatNames[backend], vertexOrderNames[ordering]);
+                resetPeakRSS();
+                startTime = getWallClockTime();
+                if (!loadGraphHandle(path, backend, false, options.numThreads, &graph)) {
+                    printf("Skipping %s: the file could not be loaded.\n", options.datasets[d]);
+                    break;
+                }
+                if (graph.stoppedEarly) {
+                    printf("Skipping %s: the file could not be read to its end.\n", options.datasets[d]);
+                    freeGraphHandle(&graph);
+                    break;
+                }
+                loadSeconds = getWallClockTime() - startTime;
+                startTime = getWallClockTime();
+                reorderGraphHandle(&graph, ordering);
+                if (ordering == GRAPH_ORDER_NONE && backend == GRAPH_FORMAT_LIST) {
+                    repackAdjList_Benchmark(&graph);
+                }
+                reorderSeconds = getWallClockTime() - startTime;
+                graph.numThreads = options.numThreads;
+
+                //the queries only depend on the seed and the number of vertices, so every format and method gets the same ones
+                if (numVertices != graph.numVertices) {
+                    uint64_t state = options.seed;
+                    numVertices = graph.numVertices;
+                    for (q = 0; q < options.numQueries; q++) {
+                        sources[q] = randomBelow(&state, numVertices);
+                        do {
+                            targets[q] = randomBelow(&state, numVertices);
+                        } while (targets[q] == sources[q] && numVertices > 1);
+                    }
+                    if (options.numMutualPairs > 0) {
+                        count = pickMutualPairs_Benchmark(&graph, options.seed, options.numMutualPairs, mutualFirsts, mutualSeconds);
+                        common = realloc(common, (numVertices > 0 ? numVertices : 1) * sizeof(int));
+                        friends = realloc(friends, (count > 0 ? 2 * count : 1) * sizeof(int)); //the friends of both people of a pair
+                        if (common == NULL || friends == NULL) {
+                            printf("Memory allocation for the benchmark has failed. Terminating program...\n");
+                            exit(-1);
+                        }
+                    }
+                }
+
+                row.dataset = options.datasets[d];
+                row.graph = &graph;
+                row.backend = backend;
+                row.loadSeconds = loadSeconds;
+                row.ordering = ordering;
+                row.reorderSeconds = reorderSeconds;
+
+                for (method = 0; method < SEARCH_NUM_METHODS; method++) {
+                    if (!options.methods[method]) {
+                        continue;
+                    }
+                    found = 0;
+                    pathLengthSum = 0;
+                    totalSeconds = 0;
+                    for (q = 0; q < options.numQueries; q++) {
+                        startTime = getWallClockTime();
+                        int *result = findConnections_GraphHandle(&graph, method, sources[q], targets[q], &pathLength);
+                        latencies[q] = getWallClockTime() - startTime;
+                        totalSeconds += latencies[q];
+                        if (result != NULL) {
+                            found++;
+                            pathLengthSum += pathLength;
+                            free(result);
+                        }
+                    }
+                    qsort(latencies, options.numQueries, sizeof(double), compareDoubles);
+                    if (ordering == GRAPH_ORDER_NONE) {
+                        originalMeans[method] = totalSeconds / options.numQueries;
+                    }
+                    row.method = searchMethodNames[method];
+                    row.peakRSS = getPeakRSS();
+                    row.numQueries = options.numQueries;
+                    row.found = found;
+                    row.pathLengthSum = pathLengthSum;
+                    row.latencies = latencies;
+                    row.totalSeconds = totalSeconds;
+                    row.numThreads = method == SEARCH_PARALLEL_BFS ? options.numThreads : 1;
+                    row.speedup = totalSeconds > 0 ? originalMeans[method] / (totalSeconds / options.numQueries) : 0;
+                    row.edgesExamined = -1;
+                    if (method == SEARCH_BFS || method == SEARCH_DOBFS) {
+                        row.edgesExamined = 0;
+                        for (q = 0; q < options.numQueries; q++) {
+                            row.edgesExamined += countEdgesExamined_GraphHandle(&graph, method == SEARCH_DOBFS, sources[q], targets[q]);
+                        }
+                    }
+                    writeRow_Benchmark(out, &options, &row, numRows);
+                    numRows++;
+                }
+
+                //the same pairs through the scalar and then the vector mutual friends search
+                for (method = 0; method < 2 && options.numMutualPairs > 0; method++) {
+                    found = 0;
+                    pathLengthSum = 0;
+                    totalSeconds = 0;
+                    for (q = 0; q < options.numMutualPairs; q++) {
+                        startTime = getWallClockTime();
+                        count = findMutualFriends_GraphHandle(&graph, mutualFirsts[q], mutualSeconds[q], common, friends, method == 1);
+                        latencies[q] = getWallClockTime() - startTime;
+                        totalSeconds += latencies[q];
+                        found += count > 0;
+                        pathLengthSum += count;
+                    }
+                    qsort(latencies, options.numMutualPairs, sizeof(double), compareDoubles);
+                    mutualCounts[method] = (int)pathLengthSum;
+                    if (method == 0) {
+                        scalarMean = totalSeconds / options.numMutualPairs;
+                    } else if (mutualCounts[1] != mutualCounts[0]) {
+                        printf("Warning: the vector search found %d mutual friends and the scalar one %d.\n", mutualCounts[1], mutualCounts[0]);
+                    }
+                    row.method = method == 0 ? "mutual_scalar" : "mutual_vector";
+                    row.peakRSS = getPeakRSS();
+                    row.numQueries = options.numMutualPairs;
+                    row.found = found;
+                    row.pathLengthSum = pathLengthSum;
+                    row.latencies = latencies;
+                    row.totalSeconds = totalSeconds;
+                    row.numThreads = 1;
+                    row.speedup = totalSeconds > 0 ? scalarMean / (totalSeconds / options.numMutualPairs) : 0;
+                    row.edgesExamined = -1;
+                    writeRow_Benchmark(out, &options, &row, numRows);
+                    numRows++;
+                }
+                freeGraphHandle(&graph);
+            }
+        }
+    }
+
+    if (options.json) {
+        fprintf(out, "%s]\n", numRows > 0 ? "\n" : "");
+    }
+    fclose(out);
+    free(sources);
+    free(targets);
+    free(latencies);
+    free(mutualFirsts);
+    free(mutualSeconds);
+    free(common);
+    free(friends);
+    printf("\nWrote %d results to %s.\n", numRows, options.outputPath);
+    return 0;
+}
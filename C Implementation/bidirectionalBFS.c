@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Bidirectional BFS for point-to-point connection queries.
+
+    One search grows from ID1 and another from ID2. Each round expands one whole level of whichever side has the smaller frontier,
+    and a round ends the search as soon as one of its edges reaches a vertex the other side has already visited.
+    Every edge between the two searches found in that round is a candidate, and the one giving the shortest total length is kept,
+    so the returned path is a shortest path, with the same length as the one from findConnections_BFS_*.
+    On social graphs each side only needs to go about half as deep, which visits far fewer vertices than a one-sided search.
+*/
+
+#define BIBFS_SOURCE_SIDE 0
+#define BIBFS_TARGET_SIDE 1
+
+/*
+    A function that stores the friends of vertex in buffer, which has room for numVertices entries, and returns how many there are.
+*/
+typedef int (*BiBFSNeighborFunction)(void *graph, int vertex, int *buffer);
+
+/*
+    This function runs a bidirectional BFS between ID1 and ID2 on any graph format.
+    The friends of a vertex are listed by collectNeighbors, which is the only format-specific part of the search.
+    If verticesVisited is not NULL, the number of vertices reached by both sides together is stored in it.
+    The arrays of the search come from scratch, made by createSearchScratch for SEARCH_BIBFS, where the distances of a side
+    only hold for the vertices it stamped; if scratch is NULL, they are allocated for this search alone.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+*/
+int* findConnections_BiBFS(void *graph, int numVertices, int ID1, int ID2, int *pathLength, long long *verticesVisited,
+                           BiBFSNeighborFunction collectNeighbors, SearchScratch *scratch)
+{
+    if (verticesVisited != NULL) {
+        *verticesVisited = 0;
+    }
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+
+    int side, other, f, k, u, v, count, total, stamp;
+    int bestLength = -1, meetSource = -1, meetTarget = -1;
+    long long numVisited = 2;
+    int *parentVertices[2], *distances[2], *visitedStamp[2], *frontier[2], *nextFrontier, frontierSize[2], nextSize;
+    SearchScratch *ownScratch = NULL;
+
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_BIBFS); //check data_structures.c for the implementation of createSearchScratch
+    }
+    beginSearch_Scratch(scratch);
+    stamp = scratch->stamp;
+    for (side = 0; side < 2; side++) {
+        parentVertices[side] = scratch->parentVertices[side];
+        distances[side] = scratch->distances[side];
+        visitedStamp[side] = scratch->visitedStamp[side]; //a vertex has a distance from a side only if that side stamped it
+        frontier[side] = scratch->frontier[side];
+    }
+    nextFrontier = scratch->nextFrontier;
+    int *neighbors = scratch->neighbors;
+
+    visitedStamp[BIBFS_SOURCE_SIDE][ID1] = stamp;
+    distances[BIBFS_SOURCE_SIDE][ID1] = 0;
+    parentVertices[BIBFS_SOURCE_SIDE][ID1] = -1;
+    frontier[BIBFS_SOURCE_SIDE][0] = ID1;
+    frontierSize[BIBFS_SOURCE_SIDE] = 1;
+    visitedStamp[BIBFS_TARGET_SIDE][ID2] = stamp;
+    distances[BIBFS_TARGET_SIDE][ID2] = 0;
+    parentVertices[BIBFS_TARGET_SIDE][ID2] = -1;
+    frontier[BIBFS_TARGET_SIDE][0] = ID2;
+    frontierSize[BIBFS_TARGET_SIDE] = 1;
+
+    while (bestLength == -1 && frontierSize[BIBFS_SOURCE_SIDE] > 0 && frontierSize[BIBFS_TARGET_SIDE] > 0) {
+        //expand one whole level of the side with the smaller frontier
+        side = frontierSize[BIBFS_SOURCE_SIDE] <= frontierSize[BIBFS_TARGET_SIDE] ? BIBFS_SOURCE_SIDE : BIBFS_TARGET_SIDE;
+        other = 1 - side;
+        nextSize = 0;
+
+        for (f = 0; f < frontierSize[side]; f++) {
+            u = frontier[side][f];
+            count = collectNeighbors(graph, u, neighbors);
+            for (k = 0; k < count; k++) {
+                v = neighbors[k];
+                if (visitedStamp[side][v] == stamp) {
+                    continue;
+                }
+                if (visitedStamp[other][v] == stamp) { //the two searches meet on the edge between u and v
+                    total = distances[side][u] + 1 + distances[other][v];
+                    if (bestLength == -1 || total < bestLength) {
+                        bestLength = total;
+                        meetSource = side == BIBFS_SOURCE_SIDE ? u : v;
+                        meetTarget = side == BIBFS_SOURCE_SIDE ? v : u;
+                    }
+                } else if (bestLength == -1) {
+                    visitedStamp[side][v] = stamp;
+                    distances[side][v] = distances[side][u] + 1;
+                    parentVertices[side][v] = u;
+                    nextFrontier[nextSize++] = v;
+                    numVisited++;
+                }
+            }
+        }
+
+        int *temp = frontier[side];
+        frontier[side] = nextFrontier;
+        nextFrontier = temp;
+        frontierSize[side] = nextSize;
+    }
+
+    int *path = NULL;
+    if (bestLength != -1) {
+        /*
+            The path runs from ID1 to meetSource through the source side's parents,
+            then crosses to meetTarget and follows the target side's parents up to ID2.
+        */
+        *pathLength = bestLength + 1;
+        path = malloc(*pathLength * sizeof(int));
+        if (path == NULL) {
+            printf("Memory allocation for path has failed. Terminating program...\n");
+            exit(-1);
+        }
+        k = distances[BIBFS_SOURCE_SIDE][meetSource];
+        for (v = meetSource; v != -1; v = parentVertices[BIBFS_SOURCE_SIDE][v]) {
+            path[k--] = v;
+        }
+        k = distances[BIBFS_SOURCE_SIDE][meetSource] + 1;
+        for (v = meetTarget; v != -1; v = parentVertices[BIBFS_TARGET_SIDE][v]) {
+            path[k++] = v;
+        }
+    }
+    if (verticesVisited != NULL) {
+        *verticesVisited = numVisited;
+    }
+
+    freeSearchScratch(ownScratch);
+    return path;
+}
+
+/*
+    These functions list the friends of a vertex for each graph format, each friend once, so buffer never needs more than
+    numVertices entries however many lines of the file repeat an edge.
+    For a verifiedSymmetric adjacency list or CSR graph, the stored neighbors are the friends. Otherwise, repeated neighbors
+    and self-loops are skipped, and a neighbor only counts if it lists the vertex back, same as hasEdge_AdjList and hasEdge_CSR.
+    For both matrices, a cell only counts if its mirrored cell is also set, same as hasEdge_AdjMatrix.
+*/
+
+/*
+    A neighbor of an adjacency list together with its position in the list, so the list can be sorted to find its repeats
+    and then put back in its own order.
+*/
+typedef struct BiBFSListEntryTag {
+    int ID;
+    int position;
+} BiBFSListEntry;
+
+int compareListEntries_BiBFS(const void *a, const void *b)
+{
+    const BiBFSListEntry *x = a, *y = b;
+    if (x->ID != y->ID) {
+        return (x->ID > y->ID) - (x->ID < y->ID);
+    }
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+int compareListPositions_BiBFS(const void *a, const void *b)
+{
+    const BiBFSListEntry *x = a, *y = b;
+    return (x->position > y->position) - (x->position < y->position);
+}
+
+int collectNeighbors_BiBFS_AdjList(void *graph, int vertex, int *buffer)
+{
+    singlyNode **adjList = graph;
+    singlyNode *temp;
+    int i, count = 0, length = 0;
+    BiBFSListEntry *entries;
+
+    if (getStorage_AdjList(adjList)->verifiedSymmetric) {
+        for (temp = adjList[vertex]; temp != NULL; temp = temp->nextNode) {
+            buffer[count++] = temp->data;
+        }
+        return count;
+    }
+
+    //the list can be longer than buffer, so its first copy of each friend is found in a sorted copy of it
+    for (temp = adjList[vertex]; temp != NULL; temp = temp->nextNode) {
+        length++;
+    }
+    entries = malloc((length > 0 ? length : 1) * sizeof(BiBFSListEntry));
+    if (entries == NULL) {
+        printf("Memory allocation for the friend list has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (temp = adjList[vertex]; temp != NULL; temp = temp->nextNode) {
+        entries[count].ID = temp->data;
+        entries[count].position = count;
+        count++;
+    }
+    qsort(entries, length, sizeof(BiBFSListEntry), compareListEntries_BiBFS);
+    count = 0;
+    for (i = 0; i < length; i++) {
+        if (entries[i].ID == vertex || (i > 0 && entries[i].ID == entries[i - 1].ID)) {
+            continue;
+        }
+        for (temp = adjList[entries[i].ID]; temp != NULL && temp->data != vertex; temp = temp->nextNode);
+        if (temp != NULL) { //the friend lists the vertex back
+            entries[count++] = entries[i];
+        }
+    }
+    qsort(entries, count, sizeof(BiBFSListEntry), compareListPositions_BiBFS); //back to the order of the list
+    for (i = 0; i < count; i++) {
+        buffer[i] = entries[i].ID;
+    }
+    free(entries);
+    return count;
+}
+
+int collectNeighbors_BiBFS_CSR(void *graph, int vertex, int *buffer)
+{
+    CSRGraph *csrGraph = graph;
+    int k, v, previous = -1, count = csrGraph->offsets[vertex + 1] - csrGraph->offsets[vertex];
+    if (csrGraph->verifiedSymmetric) {
+        memcpy(buffer, csrGraph->neighbors + csrGraph->offsets[vertex], count * sizeof(int));
+        return count;
+    }
+    count = 0;
+    for (k = csrGraph->offsets[vertex]; k < csrGraph->offsets[vertex + 1]; k++) {
+        v = csrGraph->neighbors[k];
+        if (v != vertex && v != previous //the neighbors are sorted, so a repeat comes right after its first copy
+            && containsNeighbor_CSR(csrGraph->neighbors + csrGraph->offsets[v], csrGraph->offsets[v + 1] - csrGraph->offsets[v], vertex)) {
+            buffer[count++] = v;
+        }
+        previous = v;
+    }
+    return count;
+}
+
+/*
+    The adjacency matrix does not carry its size, so it is passed to the search together with its number of vertices.
+*/
+typedef struct BiBFSMatrixTag {
+    bool **adjMatrix;
+    int numVertices;
+} BiBFSMatrix;
+
+int collectNeighbors_BiBFS_AdjMatrix(void *graph, int vertex, int *buffer)
+{
+    BiBFSMatrix *matrix = graph;
+    int i, count = 0;
+    for (i = 0; i < matrix->numVertices; i++) {
+        if (matrix->adjMatrix[vertex][i] && matrix->adjMatrix[i][vertex] && i != vertex) {
+            buffer[count++] = i;
+        }
+    }
+    return count;
+}
+
+int collectNeighbors_BiBFS_BitMatrix(void *graph, int vertex, int *buffer)
+{
+    BitMatrix *bitMatrix = graph;
+    int w, count = 0;
+    uint64_t friends;
+    for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+        friends = getFriendWord_BitMatrix(bitMatrix, vertex, w);
+        while (friends != 0) {
+            buffer[count++] = w * 64 + countTrailingZeros64(friends);
+            friends &= friends - 1;
+        }
+    }
+    return count;
+}
+
+/*
+    These functions run the bidirectional BFS on each graph format. They return the path between ID1 and ID2 if a connection
+    is found and NULL otherwise, and store the number of vertices reached by the search in verticesVisited if it is not NULL.
+    scratch is passed on to findConnections_BiBFS, and may be NULL.
+*/
+int* findConnections_BiBFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *pathLength, long long *verticesVisited, SearchScratch *scratch)
+{
+    return findConnections_BiBFS(adjList, numVertices, ID1, ID2, pathLength, verticesVisited, collectNeighbors_BiBFS_AdjList, scratch);
+}
+
+int* findConnections_BiBFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int *pathLength, long long *verticesVisited, SearchScratch *scratch)
+{
+    BiBFSMatrix matrix = {adjMatrix, numVertices};
+    return findConnections_BiBFS(&matrix, numVertices, ID1, ID2, pathLength, verticesVisited, collectNeighbors_BiBFS_AdjMatrix, scratch);
+}
+
+int* findConnections_BiBFS_CSR(CSRGraph *graph, int ID1, int ID2, int *pathLength, long long *verticesVisited, SearchScratch *scratch)
+{
+    return findConnections_BiBFS(graph, graph->numVertices, ID1, ID2, pathLength, verticesVisited, collectNeighbors_BiBFS_CSR, scratch);
+}
+
+int* findConnections_BiBFS_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *pathLength, long long *verticesVisited, SearchScratch *scratch)
+{
+    return findConnections_BiBFS(bitMatrix, bitMatrix->numVertices, ID1, ID2, pathLength, verticesVisited, collectNeighbors_BiBFS_BitMatrix, scratch);
+}
@@ -1,30 +1,135 @@
+#include <time.h>
+#include <string.h>
+#include <limits.h>
 #include "data_structures.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define NODE_POOL_FIRST_SLAB 64 //nodes in the first slab of a pool, so a short-lived stack stays small
+#define NODE_POOL_MAX_SLAB 65536 //slabs double in size up to this many nodes
+
 /*
-    This function creates a new singly linked list node with the given data. However, this is not inserted into the linked list yet.
-    Returns a pointer to the newly created node.
+    The pool used by createNode and freeLinkedList, for lists that are not part of a bigger structure.
+    It is only used from the main thread.
+*/
+NodePool defaultNodePool;
 
-    By Aaron Barcelita.
+/*
+    This function initializes an empty node pool. No memory is allocated until the first node is.
+    firstSlabSize is the number of nodes in the first slab, e.g., the expected number of nodes, or 0 for the default.
 */
-singlyNode* createNode (int data) {
-    singlyNode *newNode = (singlyNode*)malloc(sizeof(singlyNode));
-    if (newNode == NULL) {
-        printf("Memory allocation for new node has failed. Terminating program...\n");
-        free(newNode);
-        exit(-1);
+void initNodePool(NodePool *pool, int firstSlabSize) {
+    pool->slabs = NULL;
+    pool->freeNodes = NULL;
+    pool->firstSlabSize = firstSlabSize;
+    pool->nodesAllocated = 0;
+    pool->nodesInUse = 0;
+    pool->numSlabs = 0;
+    pool->bytesReserved = 0;
+}
+
+/*
+    This function takes a node from the pool and stores the given data in it.
+    A node given back by releaseNode is reused first. Otherwise, the node is cut from the current slab, and a new slab,
+    twice the size of the last one, is allocated when the current one is used up.
+    Returns a pointer to the node.
+*/
+singlyNode* allocateNode(NodePool *pool, int data) {
+    singlyNode *newNode;
+    if (pool->freeNodes != NULL) {
+        newNode = pool->freeNodes;
+        pool->freeNodes = newNode->nextNode;
+    } else {
+        if (pool->slabs == NULL || pool->slabs->used == pool->slabs->capacity) {
+            int capacity;
+            if (pool->slabs == NULL) {
+                capacity = pool->firstSlabSize > 0 ? pool->firstSlabSize : NODE_POOL_FIRST_SLAB;
+            } else {
+                capacity = pool->slabs->capacity < NODE_POOL_MAX_SLAB / 2 ? pool->slabs->capacity * 2 : NODE_POOL_MAX_SLAB;
+            }
+            size_t bytes = sizeof(NodeSlab) + (size_t)capacity * sizeof(singlyNode);
+            NodeSlab *slab = (NodeSlab*)malloc(bytes);
+            if (slab == NULL) {
+                printf("Memory allocation for new node has failed. Terminating program...\n");
+                exit(-1);
+            }
+            slab->capacity = capacity;
+            slab->used = 0;
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->numSlabs++;
+            pool->bytesReserved += bytes;
+        }
+        newNode = &pool->slabs->nodes[pool->slabs->used++];
     }
+    pool->nodesAllocated++;
+    pool->nodesInUse++;
     newNode->data = data;
     newNode->nextNode = NULL;
     return newNode;
 }
 
+/*
+    This function gives a node back to the pool it was taken from, so a later allocateNode can reuse it.
+*/
+void releaseNode(NodePool *pool, singlyNode *node) {
+    node->nextNode = pool->freeNodes;
+    pool->freeNodes = node;
+    pool->nodesInUse--;
+}
+
+/*
+    This function frees every slab of the pool at once, which frees all of its nodes, whether or not they were given back.
+    The pool is left empty and can be used again.
+*/
+void releaseNodePool(NodePool *pool) {
+    NodeSlab *slab = pool->slabs;
+    NodeSlab *nextSlab;
+    while (slab != NULL) {
+        nextSlab = slab->next;
+        free(slab);
+        slab = nextSlab;
+    }
+    initNodePool(pool, pool->firstSlabSize);
+}
+
+/*
+    This function prints how many nodes were taken from the pool and how much memory its slabs take.
+*/
+void printNodePoolStats(NodePool *pool, char *name) {
+    printf("%s: %lld nodes allocated, %lld in use, %lld slabs, %.2f MB reserved.\n", name, pool->nodesAllocated,
+           pool->nodesInUse, pool->numSlabs, pool->bytesReserved / (1024.0 * 1024.0));
+}
+
+/*
+    This function creates a new singly linked list node with the given data. However, this is not inserted into the linked list yet.
+    The node is taken from defaultNodePool, so it must be freed with freeLinkedList.
+    Returns a pointer to the newly created node.
+
+    By Aaron Barcelita.
+*/
+singlyNode* createNode (int data) {
+    return allocateNode(&defaultNodePool, data); //the node comes from a slab instead of its own malloc
+}
+
 /*
     This function inserts a new node with the given data into a linked list at its end.
 
     By Aaron Barcelita.
 */
 void insertAtEnd(singlyNode** head, int data) {
-    singlyNode *newNode = createNode(data);
+    insertAtEndFromPool(&defaultNodePool, head, data);
+}
+
+/*
+    This function inserts a new node, taken from the given pool, with the given data into a linked list at its end.
+*/
+void insertAtEndFromPool(NodePool *pool, singlyNode** head, int data) {
+    singlyNode *newNode = allocateNode(pool, data);
     if (*head == NULL) { //if linked list is empty
         *head = newNode;
     } else {
@@ -38,6 +143,7 @@ void insertAtEnd(singlyNode** head, int data) {
 
 /*
     This function frees the memory allocated for the linked list. Doing free(LinkedList) is not enough.
+    The nodes go back to defaultNodePool to be reused by createNode.
 
     By Aaron Barcelita.
 */
@@ -46,7 +152,7 @@ void freeLinkedList(singlyNode **head) {
     singlyNode *nextNode;
     while (current != NULL) {
         nextNode = current->nextNode;
-        free(current);
+        releaseNode(&defaultNodePool, current);
         current = nextNode;
     }
     *head = NULL;
@@ -64,7 +170,8 @@ void freeLinkedList(singlyNode **head) {
 */
 
 /*
-    This function creates a new priority queue. The priority queue is implemented using a singly linked list.
+    This function creates a new priority queue. The priority queue is implemented using a singly linked list
+    whose nodes come from its own node pool.
     Returns a pointer to the newly created priority queue.
 
     By Aaron Barcelita.
@@ -77,6 +184,7 @@ PriorityQueue* createPriorityQueue()
         exit(-1);
     }
     priorityQueue->front = priorityQueue->rear = NULL;
+    initNodePool(&priorityQueue->pool, 0);
     return priorityQueue;
 }
 
@@ -86,7 +194,7 @@ PriorityQueue* createPriorityQueue()
     By Aaron Barcelita.
 */
 void enqueue(PriorityQueue *priorityQueue, int data) {
-    singlyNode *newNode = createNode(data);
+    singlyNode *newNode = allocateNode(&priorityQueue->pool, data);
     
     if (priorityQueue->front == NULL) { // if the priority queue is empty
         priorityQueue->front = priorityQueue->rear = newNode;
@@ -130,7 +238,7 @@ int dequeue(PriorityQueue *priorityQueue) {
         singlyNode *temp = priorityQueue->front;
         int data = temp->data;
         priorityQueue->front = priorityQueue->front->nextNode;
-        free(temp);
+        releaseNode(&priorityQueue->pool, temp);
         return data;
     }
 }
@@ -142,20 +250,109 @@ int dequeue(PriorityQueue *priorityQueue) {
 */
 void freePriorityQueue(PriorityQueue *priorityQueue) {
     if (priorityQueue != NULL) {
-        singlyNode *current = priorityQueue->front;
-        singlyNode *nextNode;
-        while (current != NULL) {
-            nextNode = current->nextNode;
-            free(current);
-            current = nextNode;
-        }
+        releaseNodePool(&priorityQueue->pool); //frees all the nodes at once instead of walking the queue
         priorityQueue->front = priorityQueue->rear = NULL;
         free(priorityQueue);
     }
 }
 
 /*
-    This function creates a new stack. The stack is implemented using a singly linked list.
+    This function creates a new circular queue. The circular queue is implemented using an array that wraps around,
+    so enqueue and dequeue never have to walk or shift the elements.
+    The array is preallocated to hold capacity elements, e.g., the number of vertices for a BFS, since each vertex is enqueued at most once.
+    Returns a pointer to the newly created circular queue.
+*/
+CircularQueue* createCircularQueue(int capacity) {
+    CircularQueue *queue = (CircularQueue*)malloc(sizeof(CircularQueue));
+    if (queue == NULL) {
+        printf("Memory allocation for circular queue has failed. Terminating program...\n");
+        exit(-1);
+    }
+    if (capacity < 1) {
+        capacity = 1;
+    }
+    queue->items = (int*)malloc(capacity * sizeof(int));
+    if (queue->items == NULL) {
+        printf("Memory allocation for circular queue has failed. Terminating program...\n");
+        free(queue);
+        exit(-1);
+    }
+    queue->front = 0;
+    queue->count = 0;
+    queue->capacity = capacity;
+    return queue;
+}
+
+/*
+    This function inserts the given data at the rear of the circular queue.
+    If the array is full, it is doubled in size and the elements are unwrapped into the new array, so enqueue is amortized O(1).
+*/
+void enqueueCircular(CircularQueue *queue, int data) {
+    if (queue->count == queue->capacity) {
+        int i;
+        int *items = (int*)malloc(2 * queue->capacity * sizeof(int));
+        if (items == NULL) {
+            printf("Memory allocation for circular queue has failed. Terminating program...\n");
+            exit(-1);
+        }
+        for (i = 0; i < queue->count; i++) { //copy the elements in queue order so front becomes index 0
+            items[i] = queue->items[(queue->front + i) % queue->capacity];
+        }
+        free(queue->items);
+        queue->items = items;
+        queue->front = 0;
+        queue->capacity *= 2;
+    }
+    queue->items[(queue->front + queue->count) % queue->capacity] = data;
+    queue->count++;
+}
+
+/*
+    This function removes the element at the front of the circular queue.
+    Returns the removed element.
+*/
+int dequeueCircular(CircularQueue *queue) {
+    if (isEmptyCircularQueue(queue)) {
+        printf("Circular Queue is empty. Nothing to dequeue.\n");
+        return -1;
+    }
+    int data = queue->items[queue->front];
+    queue->front++;
+    if (queue->front == queue->capacity) {
+        queue->front = 0;
+    }
+    queue->count--;
+    return data;
+}
+
+/*
+    This function checks if the circular queue is empty.
+    Returns true if the circular queue is empty, false otherwise.
+*/
+bool isEmptyCircularQueue(CircularQueue *queue) {
+    return queue->count == 0;
+}
+
+/*
+    This function removes all the elements of the circular queue but keeps its array, so the queue can be reused.
+*/
+void clearCircularQueue(CircularQueue *queue) {
+    queue->front = 0;
+    queue->count = 0;
+}
+
+/*
+    This function frees the memory allocated for the circular queue and its array.
+*/
+void freeCircularQueue(CircularQueue *queue) {
+    if (queue != NULL) {
+        free(queue->items);
+        free(queue);
+    }
+}
+
+/*
+    This function creates a new stack. The stack is implemented using a singly linked list whose nodes come from its own node pool.
     Returns a pointer to the newly created stack.
 
     By Aaron Barcelita.
@@ -167,6 +364,7 @@ Stack* createStack() {
         exit(-1);
     }
     stack->top = NULL;
+    initNodePool(&stack->pool, 0);
     return stack;
 }
 
@@ -176,12 +374,7 @@ Stack* createStack() {
     By Aaron Barcelita.
 */
 void push(Stack *stack, int data) {
-    singlyNode* newNode = createNode(data);
-    if (newNode == NULL) {
-        printf("Memory allocation for new node has failed. Terminating program...\n");
-        exit(-1);
-    }
-    newNode->data = data;
+    singlyNode* newNode = allocateNode(&stack->pool, data);
     newNode->nextNode = stack->top;
     stack->top = newNode;
 }
@@ -210,7 +403,7 @@ int pop(Stack *stack) {
         singlyNode *temp = stack->top;
         int data = temp->data;
         stack->top = stack->top->nextNode;
-        free(temp);
+        releaseNode(&stack->pool, temp);
         return data;
     }
 }
@@ -221,9 +414,231 @@ int pop(Stack *stack) {
     By Aaron Barcelita.
 */
 void freeStack(Stack *stack) {
-    while(!isEmptyStack(stack)) {
-        pop(stack);
-    }
+    releaseNodePool(&stack->pool); //frees all the nodes at once instead of popping them one by one
     free(stack);
 }
 
+/*
+    This function allocates the scratch arrays that searches with the given SEARCH_* method need on a graph with numVertices vertices.
+*/
+SearchScratch* createSearchScratch(int numVertices, int method) {
+    int side, numSides = method == SEARCH_BIBFS ? 2 : 1;
+    size_t numWords = ((size_t)numVertices + 63) / 64;
+    bool failed = false;
+    SearchScratch *scratch = calloc(1, sizeof(SearchScratch));
+    if (scratch == NULL) {
+        printf("Memory allocation for search scratch space has failed. Terminating program...\n");
+        exit(-1);
+    }
+    scratch->numVertices = numVertices;
+    scratch->method = method;
+    scratch->totalDegree = -1; //the degrees are not counted yet
+
+    for (side = 0; side < numSides; side++) {
+        scratch->parentVertices[side] = malloc(numVertices * sizeof(int));
+        scratch->frontier[side] = malloc(numVertices * sizeof(int));
+        failed |= scratch->parentVertices[side] == NULL || scratch->frontier[side] == NULL;
+        if (method == SEARCH_DFS || method == SEARCH_BIBFS) {
+            scratch->visitedStamp[side] = calloc(numVertices, sizeof(int));
+            failed |= scratch->visitedStamp[side] == NULL;
+        }
+        if (method == SEARCH_BIBFS) {
+            scratch->distances[side] = malloc(numVertices * sizeof(int));
+            failed |= scratch->distances[side] == NULL;
+        }
+    }
+    if (method != SEARCH_DFS) {
+        scratch->nextFrontier = malloc(numVertices * sizeof(int));
+        failed |= scratch->nextFrontier == NULL;
+    }
+    if (method == SEARCH_BIBFS) {
+        scratch->neighbors = malloc(numVertices * sizeof(int));
+        failed |= scratch->neighbors == NULL;
+    }
+    if (method == SEARCH_DFS || method == SEARCH_DOBFS || method == SEARCH_PARALLEL_BFS) {
+        scratch->visitedBits = calloc(numWords, sizeof(uint64_t)); //the bit matrix DFS marks visited vertices in bits, as its rows are
+        failed |= scratch->visitedBits == NULL;
+    }
+    if (method == SEARCH_DOBFS) {
+        scratch->frontierBits = calloc(numWords, sizeof(uint64_t));
+        scratch->degrees = malloc(numVertices * sizeof(int));
+        failed |= scratch->frontierBits == NULL || scratch->degrees == NULL;
+    }
+    if (failed) {
+        printf("Memory allocation for search scratch space has failed. Terminating program...\n");
+        exit(-1);
+    }
+    return scratch;
+}
+
+/*
+    This function starts a new search, which marks every vertex as not reached by either side in O(1) time.
+*/
+void beginSearch_Scratch(SearchScratch *scratch) {
+    int side;
+    if (scratch->stamp == INT_MAX) {
+        for (side = 0; side < 2; side++) {
+            if (scratch->visitedStamp[side] != NULL) {
+                memset(scratch->visitedStamp[side], 0, scratch->numVertices * sizeof(int));
+            }
+        }
+        scratch->stamp = 0;
+    }
+    scratch->stamp++;
+}
+
+void freeSearchScratch(SearchScratch *scratch) {
+    int side;
+    if (scratch != NULL) {
+        for (side = 0; side < 2; side++) {
+            free(scratch->visitedStamp[side]);
+            free(scratch->parentVertices[side]);
+            free(scratch->distances[side]);
+            free(scratch->frontier[side]);
+        }
+        free(scratch->nextFrontier);
+        free(scratch->neighbors);
+        free(scratch->visitedBits);
+        free(scratch->frontierBits);
+        free(scratch->degrees);
+        free(scratch);
+    }
+}
+
+
+/*
+    This function compares two integers in ascending order. It is meant to be passed to qsort.
+    Returns a negative value if a < b, zero if a == b, and a positive value if a > b.
+*/
+int compareIntegers(const void *a, const void *b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    This function compares two unsigned 64-bit sort keys in ascending order. It is meant to be passed to qsort.
+    Packing what to sort by in the high half of a key and an index in the low half sorts by several fields without a global context.
+*/
+int compareKeys64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    This function returns the index of the lowest set bit of a nonzero 64-bit word, e.g., 3 for ...1000.
+    Used to jump straight to the next set cell when scanning a row of a BitMatrix.
+*/
+int countTrailingZeros64(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/*
+    This function returns the number of zero bits above the highest set bit of a nonzero 64-bit word.
+*/
+int countLeadingZeros64(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_clzll(word);
+#else
+    int count = 0;
+    while ((word & 0x8000000000000000ULL) == 0) {
+        word <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/*
+    This function returns the number of set bits in a 64-bit word.
+*/
+int countSetBits64(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    while (word != 0) {
+        word &= word - 1; //clear the lowest set bit
+        count++;
+    }
+    return count;
+#endif
+}
+
+/*
+    This function rebuilds the path that a search found from its parent array, where the source vertex has a parent of -1.
+    It traces back from ID2 to the source and stores the vertices in order from the source to ID2.
+    Returns the path, and its number of vertices is stored in pathLength.
+*/
+int* reconstructPath(int *parentVertices, int ID2, int *pathLength) {
+    int i, j;
+
+    *pathLength = 0;
+    for (i = ID2; i != -1; i = parentVertices[i]) {
+        (*pathLength)++; //count the number of vertices in the path
+    }
+
+    int *path = (int*)malloc(*pathLength * sizeof(int));
+    if (path == NULL) {
+        printf("Memory allocation for path has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    i = ID2;
+    for (j = *pathLength - 1; j >= 0; j--) { //store the path in reverse order
+        path[j] = i;
+        i = parentVertices[i]; //move to the parent vertex
+    }
+    return path;
+}
+
+/*
+    This function returns the current wall-clock time in seconds. Only differences between two calls are meaningful.
+*/
+double getWallClockTime() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+    This function returns the number of processors the program can run on, e.g., the default number of worker threads.
+*/
+int getNumProcessors() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+/*
+    This function returns the next number of a seeded pseudorandom sequence (splitmix64) and advances state.
+    Unlike rand(), the sequence is the same on every platform and compiler, so a seed always gives the same queries.
+*/
+uint64_t nextRandom64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*
+    This function returns a pseudorandom integer from 0 to bound - 1.
+*/
+int randomBelow(uint64_t *state, int bound) {
+    return (int)(nextRandom64(state) % (uint64_t)bound);
+}
@@ -4,24 +4,274 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 typedef struct singlyNodeTag {
     int data;
     struct singlyNodeTag *nextNode;
 } singlyNode;
 
+/*
+    Slab allocator for linked list nodes. Nodes are handed out from large blocks (slabs) instead of one malloc each,
+    nodes given back with releaseNode are kept on a free list for reuse, and releaseNodePool frees all the slabs at once.
+    A pool is not safe to use from several threads at once, so every Stack and PriorityQueue has its own.
+*/
+typedef struct NodeSlabTag {
+    struct NodeSlabTag *next;
+    int capacity;
+    int used;
+    singlyNode nodes[];
+} NodeSlab;
+
+typedef struct NodePoolTag {
+    NodeSlab *slabs; //most recent slab first
+    singlyNode *freeNodes; //nodes given back by releaseNode, reused before the slabs
+    int firstSlabSize; //number of nodes in the first slab, or 0 for NODE_POOL_FIRST_SLAB
+    long long nodesAllocated; //number of allocateNode calls
+    long long nodesInUse;
+    long long numSlabs;
+    size_t bytesReserved; //bytes taken by all the slabs
+} NodePool;
+
+/*
+    Open-addressing hash table from an edge (ID1, ID2) of an adjacency list to the node of ID1's list that stores ID2.
+    It is built the first time an adjacency list is updated, so that a friendship can be found, added or removed in expected
+    O(1) time instead of by walking a list. Check graphUpdates.c for its operations.
+*/
+typedef struct EdgeIndexTag {
+    uint64_t *keys; //(uint64_t)ID1 << 32 | ID2, or EDGE_INDEX_EMPTY for a free slot
+    singlyNode **nodes;
+    size_t capacity; //a power of two, at least twice count
+    size_t count;
+} EdgeIndex;
+
 typedef struct PriorityQueueTag {
     singlyNode *front;
     singlyNode *rear;
+    NodePool pool;
 } PriorityQueue;
 
+/*
+    First-in first-out queue stored in an array that wraps around, i.e., a ring buffer.
+    The next element to be dequeued is items[front], and the queue holds count elements.
+*/
+typedef struct CircularQueueTag {
+    int *items;
+    int front;
+    int count;
+    int capacity;
+} CircularQueue;
+
 typedef struct StackTag {
     singlyNode *top;
+    NodePool pool;
 } Stack;
 
+/*
+    Arrays reused by the connection searches of one graph, e.g., by every query a batch worker answers with the same method,
+    so that a search does not allocate and clear O(V) arrays. Only the arrays of the method it was created for are allocated.
+    A vertex counts as reached by side s of the current search only if visitedStamp[s][v] equals stamp, which
+    beginSearch_Scratch increments, so the stamps are only cleared when they would overflow. The bit sets are cleared by
+    the searches that use them, which takes numVertices / 64 words.
+*/
+typedef struct SearchScratchTag {
+    int numVertices;
+    int method; //SEARCH_* the arrays are for
+    int stamp;
+    int *visitedStamp[2]; //one per side of a bidirectional search; DFS only uses the first
+    int *parentVertices[2];
+    int *distances[2];
+    int *frontier[2]; //the stack of DFS
+    int *nextFrontier;
+    int *neighbors;
+    uint64_t *visitedBits;
+    uint64_t *frontierBits;
+    int *degrees; //degree of every vertex for the direction-optimizing BFS, counted by its first search
+    long long totalDegree;
+} SearchScratch;
+
+/*
+    Compressed sparse row (CSR) form of the social graph.
+    The friends of vertex i are stored in neighbors[offsets[i]] up to neighbors[offsets[i + 1] - 1],
+    so the whole graph lives in two contiguous arrays instead of one heap node per edge.
+*/
+typedef struct CSRGraphTag {
+    int numVertices;
+    int numEdges; //number of entries stored in the neighbors array
+    int *offsets; //numVertices + 1 entries
+    int *neighbors; //numEdges entries
+    void *mappedData; //if not NULL, offsets and neighbors point into this memory-mapped snapshot file instead of their own allocations
+    size_t mappedSize;
+    bool verifiedSymmetric; //true if every vertex's neighbors are sorted and unique, with no self-loops, and each one lists the vertex back
+} CSRGraph;
+
+/*
+    Adjacency matrix that packs one cell per bit into 64-bit words, all in one contiguous allocation.
+    Each row takes wordsPerRow words, so row i starts at bits + i * wordsPerRow, and cell (i, j) is bit j % 64 of word j / 64 of that row.
+*/
+typedef struct BitMatrixTag {
+    int numVertices;
+    int wordsPerRow;
+    uint64_t *bits;
+    bool verifiedSymmetric; //true if every set cell has its mirrored cell set and the diagonal is clear, so a row alone lists the friends
+} BitMatrix;
+
+/*
+    Reader for the "numVertices numEdges" header and "ID1 ID2" edge lines of a social graph .txt file.
+    The file is read in large blocks and the integers are parsed directly from the block, instead of one fscanf call per edge.
+*/
+typedef struct EdgeFileReaderTag {
+    FILE *fp;
+    char *buffer;
+    size_t length; //number of bytes currently in buffer
+    size_t position; //index of the next byte to parse in buffer
+    int numVertices;
+    int numEdges;
+    long long bytesRead; //in the current pass over the file
+    long long edgesRead; //in the current pass over the file
+    long long edgesRejected; //edges skipped because an ID is outside 0 to numVertices - 1
+    int passes; //times the file has been read from the start, counting the current one
+    bool stoppedEarly; //true if readEdge stopped at a token that is not a number, or at an ID without its pair, instead of at the end
+    long long stopOffset; //if stoppedEarly, the byte of the file, counting from 0, at which readEdge stopped
+    double startTime;
+    bool growVertices; //true for a stream, where numVertices grows to fit the highest ID read instead of rejecting it
+    int maxID; //for a stream, the highest ID accepted, so that one stray ID cannot grow numVertices to billions
+    bool ownsFile; //false for a stream, e.g., stdin, which closeEdgeFile leaves open
+} EdgeFileReader;
+
+/*
+    Counts of the problems found in a social graph by validateCSRGraph, and whether they were repaired.
+*/
+typedef struct GraphValidationTag {
+    long long outOfRange; //edge lines skipped because an ID is outside 0 to numVertices - 1
+    long long selfLoops;
+    long long duplicates; //extra copies of an edge that is already listed
+    long long missingReverse; //edges whose reverse direction is not listed
+    bool repaired;
+    bool verifiedSymmetric; //true if the graph has no self-loops, duplicates or edges without their reverse, as read or after the repair
+} GraphValidation;
+
+/*
+    What runMultiSourceBFS computes from a list of sources. Each array is only filled if it is not NULL.
+*/
+typedef struct MultiSourceBFSResultTag {
+    int *distances; //one row of numVertices per source, with the distance of every vertex from it, or -1 if it is not reachable
+    long long *histogram; //numVertices entries, the number of (source, vertex) pairs at each distance
+    int *eccentricities; //one per source, the highest distance from it to a vertex it reaches
+    int *sourceReachable; //one per source, the number of other vertices it reaches
+    long long *sourceDistanceSums; //one per source, the sum of the distances from it to those vertices
+    long long reachablePairs; //(source, vertex) pairs with a path between them, not counting a source with itself
+    long long distanceSum; //sum of the distances of those pairs
+} MultiSourceBFSResult;
+
+/*
+    The connected components of a graph, counted by countComponents.
+*/
+typedef struct ComponentStatisticsTag {
+    int numComponents;
+    int largestSize; //number of vertices in the largest component
+    int isolatedVertices; //components of a single vertex, i.e., people with no friends
+    double seconds;
+} ComponentStatistics;
+
+/*
+    The distance distribution of a graph, computed exactly or estimated by one of the STATS_METHOD_* methods.
+    Pairs are ordered pairs of distinct vertices with a path between them.
+*/
+typedef struct DistanceStatisticsTag {
+    int method; //STATS_METHOD_EXACT, STATS_METHOD_SAMPLE or STATS_METHOD_HYPERANF
+    int numSources; //vertices measured from, or registers per counter for STATS_METHOD_HYPERANF
+    double *pairs; //numVertices entries, the (estimated) number of pairs at each distance
+    int maxDistance; //highest distance with a pair
+    double connectedPairs;
+    double meanSeparation;
+    double meanSeparationError; //half-width of the 95% confidence interval of meanSeparation, 0 if it is exact or unknown
+    double pairsRelativeError; //relative standard error of the pair counts, 0 if they are exact
+    double effectiveDiameter; //distance within which 90% of the pairs are, interpolated between two distances
+    bool stoppedAtBudget; //true if HyperANF ran out of time before every counter stopped growing, so longer distances are missing
+    double seconds;
+} DistanceStatistics;
+
+/*
+    The triangles and clustering coefficients of a graph, computed by countTriangles_GraphHandle.
+    The arrays have numVertices entries.
+*/
+typedef struct ClusteringStatisticsTag {
+    int numVertices;
+    int method; //the TRIANGLE_METHOD_* used
+    int numThreads;
+    long long triangles;
+    long long triples; //connected triples, i.e., pairs of friends of the same person
+    double transitivity; //3 * triangles / triples
+    double averageClustering; //mean of localClustering, counting the people with fewer than two friends as 0
+    long long *vertexTriangles; //triangles through each person
+    int *degrees;
+    double *localClustering; //share of the pairs of friends of each person who are friends themselves
+    double seconds;
+} ClusteringStatistics;
+
+#define EDGE_STREAM_MAX_ID ((1 << 24) - 1) //highest ID accepted from a stream unless --max-id says otherwise
+
+#define GRAPH_FORMAT_LIST 0
+#define GRAPH_FORMAT_MATRIX 1
+#define GRAPH_FORMAT_CSR 2
+#define GRAPH_FORMAT_BITMATRIX 3
+#define GRAPH_NUM_FORMATS 4
+
+#define GRAPH_ORDER_NONE 0
+#define GRAPH_ORDER_RCM 1
+#define GRAPH_ORDER_DEGREE 2
+#define GRAPH_ORDER_BFS 3
+#define GRAPH_NUM_ORDERS 4
+
+#define STATS_METHOD_AUTO 0
+#define STATS_METHOD_EXACT 1
+#define STATS_METHOD_SAMPLE 2
+#define STATS_METHOD_HYPERANF 3
+#define STATS_NUM_METHODS 4
+
+#define TRIANGLE_METHOD_AUTO 0
+#define TRIANGLE_METHOD_MERGE 1
+#define TRIANGLE_METHOD_BITSET 2
+#define TRIANGLE_NUM_METHODS 3
+
+#define SEARCH_BFS 0
+#define SEARCH_DFS 1
+#define SEARCH_DOBFS 2
+#define SEARCH_BIBFS 3
+#define SEARCH_PARALLEL_BFS 4
+#define SEARCH_NUM_METHODS 5
+
+/*
+    A loaded social graph in any of the formats, for the non-interactive modes that let the format be chosen at run time.
+    Only the pointer of its format is set.
+*/
+typedef struct GraphHandleTag {
+    int format;
+    int numVertices;
+    int numEdges;
+    singlyNode **adjList;
+    bool **adjMatrix;
+    CSRGraph *csrGraph;
+    BitMatrix *bitMatrix;
+    int numThreads; //threads used by SEARCH_PARALLEL_BFS, or 0 for one per processor
+    int ordering; //GRAPH_ORDER_* the vertices were relabeled with by reorderGraphHandle
+    int *oldToNew; //ID in the graph of each ID of the file, or NULL if the vertices were not relabeled
+    int *newToOld; //ID of the file of each ID in the graph
+    bool stoppedEarly; //true if the edges of a .txt file or stream were not read to the end, so the graph lacks the rest of them
+} GraphHandle;
+
+//node pool function prototypes
+void initNodePool(NodePool *pool, int firstSlabSize);
+singlyNode* allocateNode(NodePool *pool, int data);
+void releaseNode(NodePool *pool, singlyNode *node);
+void releaseNodePool(NodePool *pool);
+void printNodePoolStats(NodePool *pool, char *name);
+
 //linked list function prototypes
 singlyNode* createNode (int data);
 void insertAtEnd(singlyNode **head, int data);
+void insertAtEndFromPool(NodePool *pool, singlyNode **head, int data);
 void freeLinkedList(singlyNode **head);
 
 //priority queue function prototypes
@@ -31,6 +281,14 @@ bool isEmptyQueue(PriorityQueue *priorityQueue);
 int dequeue(PriorityQueue *priorityQueue);
 void freePriorityQueue(PriorityQueue *priorityQueue);
 
+//circular queue function prototypes
+CircularQueue* createCircularQueue(int capacity);
+void enqueueCircular(CircularQueue *queue, int data);
+int dequeueCircular(CircularQueue *queue);
+bool isEmptyCircularQueue(CircularQueue *queue);
+void clearCircularQueue(CircularQueue *queue);
+void freeCircularQueue(CircularQueue *queue);
+
 //stack function prototypes
 Stack* createStack();
 void push(Stack *stack, int data);
@@ -38,4 +296,105 @@ int pop(Stack *stack);
 bool isEmptyStack(Stack *stack);
 void freeStack(Stack *stack);
 
+//search scratch function prototypes
+SearchScratch* createSearchScratch(int numVertices, int method);
+void beginSearch_Scratch(SearchScratch *scratch);
+void freeSearchScratch(SearchScratch *scratch);
+
+//utility function prototypes
+int compareIntegers(const void *a, const void *b);
+int compareKeys64(const void *a, const void *b);
+int countTrailingZeros64(uint64_t word);
+int countLeadingZeros64(uint64_t word);
+int countSetBits64(uint64_t word);
+int* reconstructPath(int *parentVertices, int ID2, int *pathLength);
+double getWallClockTime();
+int getNumProcessors();
+uint64_t nextRandom64(uint64_t *state);
+int randomBelow(uint64_t *state, int bound);
+
+//edge file reader function prototypes
+EdgeFileReader* openEdgeFile(char *fileString);
+EdgeFileReader* openEdgeStream(FILE *fp, bool hasHeader, int maxID);
+bool readEdge(EdgeFileReader *reader, int *ID1, int *ID2);
+bool rewindEdgeFile(EdgeFileReader *reader);
+void printEdgeFileStats(EdgeFileReader *reader);
+void printEdgeFileWarnings(EdgeFileReader *reader);
+void closeEdgeFile(EdgeFileReader *reader);
+
+//graph validation function prototypes
+void validateCSRGraph(CSRGraph *graph, GraphValidation *report);
+void repairCSRGraph(CSRGraph *graph, GraphValidation *report);
+int normalizeAdjacencyList(singlyNode **adjList, int numVertices);
+CSRGraph* loadValidatedCSRGraph(EdgeFileReader *reader, char *fileString, int numThreads, GraphValidation *report, int *numVertices, int *numEdges);
+void printGraphValidation(GraphValidation *report);
+
+//graph snapshot function prototypes
+void getSnapshotPath(char *fileString, char *snapshotPath, size_t size);
+bool saveGraphSnapshot(CSRGraph *graph, int numEdges, char *snapshotPath, char *fileString);
+CSRGraph* loadGraphSnapshot(char *snapshotPath, char *fileString, int *numVertices, int *numEdges);
+void* mapFile_Snapshot(char *path, size_t *mappedSize);
+void unmapGraphSnapshot(void *mappedData, size_t mappedSize);
+
+//parallel graph loader function prototypes
+CSRGraph* loadSortedCSRGraphParallel(EdgeFileReader *reader, char *fileString, int numThreads, int *numVertices, int *numEdges);
+CSRGraph* loadCSRGraphParallel(EdgeFileReader *reader, char *fileString, int numThreads, int *numVertices, int *numEdges);
+
+//.mat file reader function prototypes
+unsigned char* inflateZlib(const unsigned char *in, size_t inLength, size_t *outLength);
+bool isMatFile(char *fileString);
+CSRGraph* loadCSRGraphFromMatFile(char *fileString, int *numVertices, int *numEdges);
+
+//graph update function prototypes
+EdgeIndex* getEdgeIndex_AdjList(singlyNode** adjList, int numVertices);
+void freeEdgeIndex(EdgeIndex *index);
+bool addFriendship_AdjList(singlyNode** adjList, int numVertices, int *numEdges, int ID1, int ID2);
+bool removeFriendship_AdjList(singlyNode** adjList, int numVertices, int *numEdges, int ID1, int ID2);
+singlyNode** addVertex_AdjList(singlyNode** adjList, int *numVertices);
+bool addFriendship_AdjMatrix(bool** adjMatrix, int numVertices, int *numEdges, int ID1, int ID2);
+bool removeFriendship_AdjMatrix(bool** adjMatrix, int numVertices, int *numEdges, int ID1, int ID2);
+bool** addVertex_AdjMatrix(bool** adjMatrix, int *numVertices, int *capacity);
+void getDeltaLogPath(char *fileString, char *logPath, size_t size);
+FILE* openDeltaLog(char *logPath);
+void writeDeltaLog(FILE *log, char operation, int ID1, int ID2);
+CSRGraph* replayDeltaLog(CSRGraph *graph, char *logPath, int *numVertices, int *numEdges);
+
+//edge stream function prototypes
+singlyNode** loadAdjacencyListFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges);
+CSRGraph* loadCSRGraphFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges);
+bool** loadAdjMatrixFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges);
+BitMatrix* loadBitMatrixFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges);
+
+//vertex ordering function prototypes
+int* computeVertexOrder(CSRGraph *graph, int ordering);
+CSRGraph* relabelCSRGraph(CSRGraph *graph, int *newToOld, int *oldToNew);
+bool reorderGraphHandle(GraphHandle *handle, int ordering);
+
+//mutual friends function prototypes
+int intersectSorted_Scalar(const int *a, int countA, const int *b, int countB, int *common);
+int intersectSorted_Vector(const int *a, int countA, const int *b, int countB, int *common);
+int findMutualFriends_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *common, int *friends, bool useVector);
+int findMutualFriends_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int *common, bool useVector);
+int findMutualFriends_CSR(CSRGraph *graph, int ID1, int ID2, int *common, bool useVector);
+int findMutualFriends_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *common);
+int findMutualFriends_GraphHandle(GraphHandle *handle, int ID1, int ID2, int *common, int *friends, bool useVector);
+void printMutualFriends(int ID1, int ID2, int *common, int count);
+
+//triangle counting function prototypes
+void countTriangles_GraphHandle(GraphHandle *handle, int method, int numThreads, ClusteringStatistics *stats);
+void freeClusteringStatistics(ClusteringStatistics *stats);
+void printClusteringStatistics(ClusteringStatistics *stats);
+bool writeLocalClustering(ClusteringStatistics *stats, GraphHandle *handle, char *outputPath);
+
+//graph handle function prototypes
+int findNameIndex(char *name, char **names, int numNames);
+bool loadGraphHandle(char *fileString, int format, bool useSnapshot, int numThreads, GraphHandle *handle);
+bool loadStreamedGraphHandle(FILE *fp, bool hasHeader, int maxID, int format, GraphHandle *handle);
+int* findConnections_GraphHandle(GraphHandle *handle, int method, int ID1, int ID2, int *pathLength);
+int* findConnectionsWithScratch_GraphHandle(GraphHandle *handle, int method, int ID1, int ID2, int *pathLength, SearchScratch *scratch);
+long long countEdgesExamined_GraphHandle(GraphHandle *handle, bool allowBottomUp, int ID1, int ID2);
+int collectGraphNeighbors_GraphHandle(GraphHandle *handle, int vertex, int *buffer);
+int collectNeighbors_GraphHandle(GraphHandle *handle, int vertex, int *buffer);
+void freeGraphHandle(GraphHandle *handle);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,402 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Direction-optimizing BFS, as described by Beamer et al.
+
+    The search runs level by level. A top-down step expands every vertex of the current frontier and looks at all of its neighbors,
+    which is what findConnections_BFS_* do. A bottom-up step instead goes through every unvisited vertex and looks for any neighbor
+    in the frontier, stopping at the first one it finds. On social graphs the middle levels of a search cover most of the graph,
+    so most edges examined by a top-down step lead to vertices that are already visited. A bottom-up step skips most of that work.
+
+    The search switches to bottom-up when the edges leaving the frontier outnumber the edges of the unvisited vertices divided by
+    DOBFS_ALPHA, and switches back to top-down once the frontier holds fewer than numVertices / DOBFS_BETA vertices.
+    Both steps only ever give a vertex a parent from the previous level, so the returned path is always a shortest path,
+    with the same length as the one from findConnections_BFS_*.
+*/
+#define DOBFS_ALPHA 14
+#define DOBFS_BETA 24
+
+/*
+    The state shared by the steps of a direction-optimizing BFS.
+    frontier holds the vertices of the current level and frontierBits holds the same vertices as a bit set,
+    which lets a bottom-up step check whether a neighbor is in the frontier in O(1).
+*/
+typedef struct DOBFSStateTag {
+    int numVertices;
+    int *parentVertices;
+    uint64_t *visitedBits;
+    uint64_t *frontierBits;
+    int *frontier;
+    int frontierSize;
+    int *nextFrontier;
+    int nextSize;
+    long long edgesExamined;
+} DOBFSState;
+
+typedef void (*DOBFSDegreeFunction)(void *graph, int numVertices, int *degrees);
+typedef void (*DOBFSStepFunction)(void *graph, DOBFSState *state);
+
+#define DOBFS_TEST_BIT(words, i) (((words)[(i) / 64] >> ((i) % 64)) & 1)
+#define DOBFS_SET_BIT(words, i) ((words)[(i) / 64] |= (uint64_t)1 << ((i) % 64))
+
+/*
+    This function marks vertex i as discovered from parent and adds it to the next frontier.
+*/
+void visitVertex_DOBFS(DOBFSState *state, int i, int parent)
+{
+    DOBFS_SET_BIT(state->visitedBits, i);
+    state->parentVertices[i] = parent;
+    state->nextFrontier[state->nextSize++] = i;
+}
+
+/*
+    This function runs a direction-optimizing BFS from ID1 until ID2 is reached, on any graph format.
+    The format-specific parts, i.e., counting degrees and the top-down and bottom-up steps, are passed in as functions.
+    When allowBottomUp is false, every level is expanded top-down, which gives the number of edges a plain BFS would examine.
+    If edgesExamined is not NULL, the number of neighbor checks done by the search is stored in it.
+    The arrays of the search come from scratch, made by createSearchScratch for SEARCH_DOBFS on this graph, whose degrees are
+    only counted by its first search; if scratch is NULL, they are allocated for this search alone.
+    Returns an array of integers that represents the path between the two IDs if a connection is found, and NULL otherwise.
+*/
+int* findConnections_DOBFS(void *graph, int numVertices, int ID1, int ID2, int *pathLength, long long *edgesExamined,
+                           DOBFSDegreeFunction computeDegrees, DOBFSStepFunction topDownStep, DOBFSStepFunction bottomUpStep, bool allowBottomUp,
+                           SearchScratch *scratch)
+{
+    if (edgesExamined != NULL) {
+        *edgesExamined = 0;
+    }
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+
+    int i, numWords = (numVertices + 63) / 64;
+    long long frontierEdges, unvisitedEdges;
+    bool bottomUp = false;
+    DOBFSState state;
+    SearchScratch *ownScratch = NULL;
+
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_DOBFS); //check data_structures.c for the implementation of createSearchScratch
+    }
+    state.numVertices = numVertices;
+    state.parentVertices = scratch->parentVertices[0]; //only read for visited vertices, so it is not cleared
+    state.frontier = scratch->frontier[0];
+    state.nextFrontier = scratch->nextFrontier;
+    state.visitedBits = scratch->visitedBits;
+    state.frontierBits = scratch->frontierBits;
+    int *degrees = scratch->degrees;
+    memset(state.visitedBits, 0, numWords * sizeof(uint64_t));
+    memset(state.frontierBits, 0, numWords * sizeof(uint64_t));
+    state.parentVertices[ID1] = -1;
+    state.edgesExamined = 0;
+
+    if (scratch->totalDegree < 0) {
+        computeDegrees(graph, numVertices, degrees);
+        scratch->totalDegree = 0;
+        for (i = 0; i < numVertices; i++) {
+            scratch->totalDegree += degrees[i];
+        }
+    }
+    unvisitedEdges = scratch->totalDegree;
+
+    //the first level only holds the source vertex
+    DOBFS_SET_BIT(state.visitedBits, ID1);
+    DOBFS_SET_BIT(state.frontierBits, ID1);
+    state.frontier[0] = ID1;
+    state.frontierSize = 1;
+    frontierEdges = degrees[ID1];
+    unvisitedEdges -= degrees[ID1];
+
+    while (state.frontierSize > 0 && !DOBFS_TEST_BIT(state.visitedBits, ID2)) {
+        //decide the direction of the next step
+        if (allowBottomUp) {
+            if (!bottomUp && frontierEdges > unvisitedEdges / DOBFS_ALPHA) {
+                bottomUp = true;
+            } else if (bottomUp && state.frontierSize < numVertices / DOBFS_BETA) {
+                bottomUp = false;
+            }
+        }
+
+        state.nextSize = 0;
+        if (bottomUp) {
+            bottomUpStep(graph, &state);
+        } else {
+            topDownStep(graph, &state);
+        }
+
+        //the next frontier becomes the current one
+        for (i = 0; i < state.frontierSize; i++) {
+            state.frontierBits[state.frontier[i] / 64] = 0;
+        }
+        int *temp = state.frontier;
+        state.frontier = state.nextFrontier;
+        state.nextFrontier = temp;
+        state.frontierSize = state.nextSize;
+        frontierEdges = 0;
+        for (i = 0; i < state.frontierSize; i++) {
+            DOBFS_SET_BIT(state.frontierBits, state.frontier[i]);
+            frontierEdges += degrees[state.frontier[i]];
+        }
+        unvisitedEdges -= frontierEdges;
+    }
+
+    int *path = NULL;
+    if (DOBFS_TEST_BIT(state.visitedBits, ID2)) {
+        path = reconstructPath(state.parentVertices, ID2, pathLength); //check data_structures.c for the implementation of reconstructPath
+    }
+    if (edgesExamined != NULL) {
+        *edgesExamined = state.edgesExamined;
+    }
+
+    freeSearchScratch(ownScratch);
+    return path;
+}
+
+/*
+    Steps for the adjacency list. In a verifiedSymmetric list, the list of an unvisited vertex is also the list of vertices
+    that could have discovered it; otherwise, an entry only counts as an edge if it is listed back (isMutual_AdjList).
+*/
+void computeDegrees_DOBFS_AdjList(void *graph, int numVertices, int *degrees)
+{
+    singlyNode **adjList = graph;
+    singlyNode *temp;
+    int i;
+    for (i = 0; i < numVertices; i++) {
+        degrees[i] = 0;
+        for (temp = adjList[i]; temp != NULL; temp = temp->nextNode) {
+            degrees[i]++;
+        }
+    }
+}
+
+void topDownStep_DOBFS_AdjList(void *graph, DOBFSState *state)
+{
+    singlyNode **adjList = graph;
+    singlyNode *temp;
+    int f, u;
+    for (f = 0; f < state->frontierSize; f++) {
+        u = state->frontier[f];
+        for (temp = adjList[u]; temp != NULL; temp = temp->nextNode) {
+            state->edgesExamined++;
+            if (!DOBFS_TEST_BIT(state->visitedBits, temp->data) && isMutual_AdjList(adjList, u, temp->data)) { //check adjacencyList.c for the implementation of isMutual_AdjList
+                visitVertex_DOBFS(state, temp->data, u);
+            }
+        }
+    }
+}
+
+void bottomUpStep_DOBFS_AdjList(void *graph, DOBFSState *state)
+{
+    singlyNode **adjList = graph;
+    singlyNode *temp;
+    int v;
+    for (v = 0; v < state->numVertices; v++) {
+        if (DOBFS_TEST_BIT(state->visitedBits, v)) {
+            continue;
+        }
+        for (temp = adjList[v]; temp != NULL; temp = temp->nextNode) {
+            state->edgesExamined++;
+            if (DOBFS_TEST_BIT(state->frontierBits, temp->data) && isMutual_AdjList(adjList, v, temp->data)) { //stop at the first neighbor found in the frontier
+                visitVertex_DOBFS(state, v, temp->data);
+                break;
+            }
+        }
+    }
+}
+
+/*
+    Steps for the adjacency matrix. Only set cells whose mirrored cell is also set count as edges, same as hasEdge_AdjMatrix.
+*/
+void computeDegrees_DOBFS_AdjMatrix(void *graph, int numVertices, int *degrees)
+{
+    bool **adjMatrix = graph;
+    int i, j;
+    for (i = 0; i < numVertices; i++) {
+        degrees[i] = 0;
+        for (j = 0; j < numVertices; j++) {
+            degrees[i] += adjMatrix[i][j];
+        }
+    }
+}
+
+void topDownStep_DOBFS_AdjMatrix(void *graph, DOBFSState *state)
+{
+    bool **adjMatrix = graph;
+    int f, u, i;
+    for (f = 0; f < state->frontierSize; f++) {
+        u = state->frontier[f];
+        for (i = 0; i < state->numVertices; i++) {
+            if (adjMatrix[u][i]) {
+                state->edgesExamined++;
+                if (!DOBFS_TEST_BIT(state->visitedBits, i) && adjMatrix[i][u] && i != u) {
+                    visitVertex_DOBFS(state, i, u);
+                }
+            }
+        }
+    }
+}
+
+void bottomUpStep_DOBFS_AdjMatrix(void *graph, DOBFSState *state)
+{
+    bool **adjMatrix = graph;
+    int v, i;
+    for (v = 0; v < state->numVertices; v++) {
+        if (DOBFS_TEST_BIT(state->visitedBits, v)) {
+            continue;
+        }
+        for (i = 0; i < state->numVertices; i++) {
+            if (adjMatrix[v][i]) {
+                state->edgesExamined++;
+                if (DOBFS_TEST_BIT(state->frontierBits, i) && adjMatrix[i][v] && i != v) { //stop at the first neighbor found in the frontier
+                    visitVertex_DOBFS(state, v, i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/*
+    Steps for the CSR graph, which read each vertex's neighbors from one contiguous slice.
+*/
+void computeDegrees_DOBFS_CSR(void *graph, int numVertices, int *degrees)
+{
+    CSRGraph *csrGraph = graph;
+    int i;
+    for (i = 0; i < numVertices; i++) {
+        degrees[i] = csrGraph->offsets[i + 1] - csrGraph->offsets[i];
+    }
+}
+
+void topDownStep_DOBFS_CSR(void *graph, DOBFSState *state)
+{
+    CSRGraph *csrGraph = graph;
+    int f, k, u, i;
+    for (f = 0; f < state->frontierSize; f++) {
+        u = state->frontier[f];
+        for (k = csrGraph->offsets[u]; k < csrGraph->offsets[u + 1]; k++) {
+            state->edgesExamined++;
+            i = csrGraph->neighbors[k];
+            if (!DOBFS_TEST_BIT(state->visitedBits, i)) {
+                visitVertex_DOBFS(state, i, u);
+            }
+        }
+    }
+}
+
+void bottomUpStep_DOBFS_CSR(void *graph, DOBFSState *state)
+{
+    CSRGraph *csrGraph = graph;
+    int v, k;
+    for (v = 0; v < state->numVertices; v++) {
+        if (DOBFS_TEST_BIT(state->visitedBits, v)) {
+            continue;
+        }
+        for (k = csrGraph->offsets[v]; k < csrGraph->offsets[v + 1]; k++) {
+            state->edgesExamined++;
+            if (DOBFS_TEST_BIT(state->frontierBits, csrGraph->neighbors[k])) { //stop at the first neighbor found in the frontier
+                visitVertex_DOBFS(state, v, csrGraph->neighbors[k]);
+                break;
+            }
+        }
+    }
+}
+
+/*
+    Steps for the bit matrix. A bottom-up step ANDs each word of an unvisited vertex's row with the frontier bits,
+    so 64 possible parents are checked at once.
+*/
+void computeDegrees_DOBFS_BitMatrix(void *graph, int numVertices, int *degrees)
+{
+    BitMatrix *bitMatrix = graph;
+    int i, w;
+    for (i = 0; i < numVertices; i++) {
+        degrees[i] = 0;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            degrees[i] += countSetBits64(bitMatrix->bits[(size_t)i * bitMatrix->wordsPerRow + w]);
+        }
+    }
+}
+
+void topDownStep_DOBFS_BitMatrix(void *graph, DOBFSState *state)
+{
+    BitMatrix *bitMatrix = graph;
+    int f, w, u, i;
+    uint64_t candidates;
+    for (f = 0; f < state->frontierSize; f++) {
+        u = state->frontier[f];
+        uint64_t *row = bitMatrix->bits + (size_t)u * bitMatrix->wordsPerRow;
+        for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+            state->edgesExamined += countSetBits64(row[w]);
+            candidates = row[w] & ~state->visitedBits[w];
+            while (candidates != 0) {
+                i = w * 64 + countTrailingZeros64(candidates);
+                if (bitMatrix->verifiedSymmetric || (i != u && getBit_BitMatrix(bitMatrix, i, u))) {
+                    visitVertex_DOBFS(state, i, u);
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+}
+
+void bottomUpStep_DOBFS_BitMatrix(void *graph, DOBFSState *state)
+{
+    BitMatrix *bitMatrix = graph;
+    int v, w, i;
+    bool found;
+    uint64_t candidates;
+    for (v = 0; v < state->numVertices; v++) {
+        if (DOBFS_TEST_BIT(state->visitedBits, v)) {
+            continue;
+        }
+        uint64_t *row = bitMatrix->bits + (size_t)v * bitMatrix->wordsPerRow;
+        found = false;
+        for (w = 0; w < bitMatrix->wordsPerRow && !found; w++) {
+            state->edgesExamined += countSetBits64(row[w]);
+            candidates = row[w] & state->frontierBits[w];
+            while (candidates != 0 && !found) {
+                i = w * 64 + countTrailingZeros64(candidates);
+                if (bitMatrix->verifiedSymmetric || (i != v && getBit_BitMatrix(bitMatrix, i, v))) { //stop at the first neighbor found in the frontier
+                    visitVertex_DOBFS(state, v, i);
+                    found = true;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+}
+
+/*
+    These functions run the direction-optimizing BFS on each graph format. They return the path between ID1 and ID2 if a connection
+    is found and NULL otherwise, and store the number of neighbor checks done in edgesExamined if it is not NULL.
+    scratch is passed on to findConnections_DOBFS, and may be NULL.
+*/
+int* findConnections_DOBFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *pathLength, long long *edgesExamined, SearchScratch *scratch)
+{
+    return findConnections_DOBFS(adjList, numVertices, ID1, ID2, pathLength, edgesExamined,
+                                 computeDegrees_DOBFS_AdjList, topDownStep_DOBFS_AdjList, bottomUpStep_DOBFS_AdjList, true, scratch);
+}
+
+int* findConnections_DOBFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int *pathLength, long long *edgesExamined, SearchScratch *scratch)
+{
+    return findConnections_DOBFS(adjMatrix, numVertices, ID1, ID2, pathLength, edgesExamined,
+                                 computeDegrees_DOBFS_AdjMatrix, topDownStep_DOBFS_AdjMatrix, bottomUpStep_DOBFS_AdjMatrix, true, scratch);
+}
+
+int* findConnections_DOBFS_CSR(CSRGraph *graph, int ID1, int ID2, int *pathLength, long long *edgesExamined, SearchScratch *scratch)
+{
+    return findConnections_DOBFS(graph, graph->numVertices, ID1, ID2, pathLength, edgesExamined,
+                                 computeDegrees_DOBFS_CSR, topDownStep_DOBFS_CSR, bottomUpStep_DOBFS_CSR, true, scratch);
+}
+
+int* findConnections_DOBFS_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *pathLength, long long *edgesExamined, SearchScratch *scratch)
+{
+    return findConnections_DOBFS(bitMatrix, bitMatrix->numVertices, ID1, ID2, pathLength, edgesExamined,
+                                 computeDegrees_DOBFS_BitMatrix, topDownStep_DOBFS_BitMatrix, bottomUpStep_DOBFS_BitMatrix, true, scratch);
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data_structures.h"
+
+#define EDGE_READER_BLOCK_SIZE (1 << 20) //bytes read from the file at a time
+
+/*
+    This function reads the next block of the file into the reader's buffer.
+    A reader without a file, whose buffer already holds all of its bytes (check parallelGraphLoader.c), has no next block.
+    Returns false if there is nothing left to read.
+*/
+bool refillEdgeFileBuffer(EdgeFileReader *reader) {
+    if (reader->fp == NULL) {
+        return false;
+    }
+    reader->length = fread(reader->buffer, 1, EDGE_READER_BLOCK_SIZE, reader->fp);
+    reader->position = 0;
+    reader->bytesRead += reader->length;
+    return reader->length > 0;
+}
+
+/*
+    This function parses the next integer in the file, skipping any whitespace before it.
+    It stops at the first byte that is not a digit, reading a new block whenever the current one runs out,
+    so a number split across two blocks is still read correctly.
+    Returns 1 if an integer was read, 0 at the end of the file, and -1 if the next token is not an integer.
+*/
+int readNextInteger(EdgeFileReader *reader, int *value) {
+    int c;
+    long long number = 0;
+    int digits = 0;
+    bool negative = false;
+
+    //skip whitespace
+    do {
+        if (reader->position == reader->length && !refillEdgeFileBuffer(reader)) {
+            return 0;
+        }
+        c = (unsigned char)reader->buffer[reader->position++];
+    } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+
+    if (c == '-') {
+        negative = true;
+        if (reader->position == reader->length && !refillEdgeFileBuffer(reader)) {
+            return -1;
+        }
+        c = (unsigned char)reader->buffer[reader->position++];
+    }
+
+    //read the digits
+    while (c >= '0' && c <= '9') {
+        if (number <= 0x7fffffff) { //keep reading past overflow, but do not let number wrap around
+            number = number * 10 + (c - '0');
+        }
+        digits++;
+        if (reader->position == reader->length && !refillEdgeFileBuffer(reader)) {
+            break;
+        }
+        c = (unsigned char)reader->buffer[reader->position++];
+    }
+
+    if (digits == 0 || number > 0x7fffffff) {
+        return -1;
+    }
+    *value = negative ? -(int)number : (int)number;
+    return 1;
+}
+
+/*
+    This function creates a reader for an opened file, positioned at its first byte.
+*/
+EdgeFileReader* createEdgeFileReader(FILE *fp) {
+    EdgeFileReader *reader = malloc(sizeof(EdgeFileReader));
+    if (reader == NULL) {
+        printf("Memory allocation for edge file reader has failed. Terminating program...\n");
+        fclose(fp);
+        exit(-1);
+    }
+    reader->buffer = malloc(EDGE_READER_BLOCK_SIZE);
+    if (reader->buffer == NULL) {
+        printf("Memory allocation for edge file reader has failed. Terminating program...\n");
+        free(reader);
+        fclose(fp);
+        exit(-1);
+    }
+    reader->fp = fp;
+    reader->length = 0;
+    reader->position = 0;
+    reader->bytesRead = 0;
+    reader->edgesRead = 0;
+    reader->edgesRejected = 0;
+    reader->passes = 1;
+    reader->stoppedEarly = false;
+    reader->stopOffset = 0;
+    reader->startTime = getWallClockTime();
+    reader->numVertices = 0;
+    reader->numEdges = 0;
+    reader->growVertices = false;
+    reader->maxID = 0x7ffffffe;
+    reader->ownsFile = true;
+    return reader;
+}
+
+/*
+    This function opens a social graph .txt file and reads its header, i.e., the number of vertices and edges on the first line.
+    This is the only place the header is checked, so the caller should keep the reader and load the graph from it.
+    Returns a pointer to the reader, or NULL if the file does not exist or its header is invalid.
+*/
+EdgeFileReader* openEdgeFile(char *fileString) {
+    FILE *fp = fopen(fileString, "rb");
+    if (fp == NULL) {
+        printf("File not found. Please try again.\n");
+        return NULL;
+    }
+
+    EdgeFileReader *reader = createEdgeFileReader(fp);
+    if (readNextInteger(reader, &reader->numVertices) != 1 || readNextInteger(reader, &reader->numEdges) != 1 || reader->numVertices <= 0) {
+        printf("Invalid file format. Please try again.\n");
+        closeEdgeFile(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+/*
+    This function starts reading the edges of a social graph from an already opened stream, e.g., stdin or a pipe, which is read
+    once from front to back in EDGE_READER_BLOCK_SIZE blocks and is never rewound.
+    The number of vertices comes from the IDs read: it grows to one more than the highest ID so far, so the stream does not need
+    a header. Edges with an ID above maxID are rejected instead, since every format allocates memory for each vertex up to the
+    highest ID. If hasHeader is true, the first two numbers are read as the usual header, and only give the expected sizes.
+    Returns a pointer to the reader, or NULL if hasHeader is true and the header is invalid. The stream is not closed by closeEdgeFile.
+*/
+EdgeFileReader* openEdgeStream(FILE *fp, bool hasHeader, int maxID) {
+    EdgeFileReader *reader = createEdgeFileReader(fp);
+    reader->growVertices = true;
+    reader->maxID = maxID;
+    reader->ownsFile = false;
+    if (hasHeader && (readNextInteger(reader, &reader->numVertices) != 1 || readNextInteger(reader, &reader->numEdges) != 1
+                      || reader->numVertices < 0 || reader->numVertices - 1 > maxID || reader->numEdges < 0)) {
+        printf("Invalid header in the edge stream.\n");
+        closeEdgeFile(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+/*
+    This function reads the next edge of the file.
+    Edges with an ID outside 0 to numVertices - 1 are counted as rejected and skipped, so callers can index their arrays with the IDs directly.
+    For a stream, only negative IDs and IDs above maxID are rejected, and numVertices grows to fit the others.
+    Returns true if an edge was read, and false at the end of the file or at the first token that is not a number, in which case
+    reader->stoppedEarly is set and reader->stopOffset is the byte the token ends at.
+*/
+bool readEdge(EdgeFileReader *reader, int *ID1, int *ID2) {
+    int first;
+    while ((first = readNextInteger(reader, ID1)) == 1 && readNextInteger(reader, ID2) == 1) {
+        if (*ID1 >= 0 && *ID1 < reader->numVertices && *ID2 >= 0 && *ID2 < reader->numVertices) {
+            reader->edgesRead++;
+            return true;
+        }
+        if (reader->growVertices && *ID1 >= 0 && *ID2 >= 0 && *ID1 <= reader->maxID && *ID2 <= reader->maxID) {
+            reader->numVertices = (*ID1 > *ID2 ? *ID1 : *ID2) + 1;
+            reader->edgesRead++;
+            return true;
+        }
+        reader->edgesRejected++;
+    }
+    reader->stoppedEarly = first != 0; //either the first ID is not a number, or the second one is missing or not a number
+    if (reader->stoppedEarly) {
+        reader->stopOffset = reader->bytesRead - (long long)(reader->length - reader->position) - 1; //the byte the parsing stopped at
+    }
+    return false;
+}
+
+/*
+    This function goes back to the first edge of the file, for loaders that need to read the edges twice.
+    The byte and edge counts start over, so they describe the file rather than how often it was read, and the passes are counted
+    instead, so that printEdgeFileStats can still report the parsing work of all of them.
+    Returns false if the file cannot be rewound, e.g., when it is a pipe.
+*/
+bool rewindEdgeFile(EdgeFileReader *reader) {
+    int numVertices, numEdges;
+    if (reader->growVertices || fseek(reader->fp, 0, SEEK_SET) != 0) {
+        return false;
+    }
+    reader->length = 0;
+    reader->position = 0;
+    reader->bytesRead = 0;
+    reader->edgesRead = 0;
+    reader->edgesRejected = 0;
+    reader->passes++;
+    return readNextInteger(reader, &numVertices) == 1 && readNextInteger(reader, &numEdges) == 1;
+}
+
+/*
+    This function prints the size of the file and its number of edges, and how fast they were parsed, in megabytes and edges per
+    second over all the passes, followed by the warnings of printEdgeFileWarnings.
+*/
+void printEdgeFileStats(EdgeFileReader *reader) {
+    double seconds = getWallClockTime() - reader->startTime;
+    double megabytes = reader->bytesRead / (1024.0 * 1024.0);
+    if (seconds <= 0) {
+        seconds = 1e-9;
+    }
+    printf("Parsed %.2f MB and %lld edges in %.3f s", megabytes, reader->edgesRead, seconds);
+    if (reader->passes > 1) {
+        printf(", reading the file %d times", reader->passes);
+    }
+    printf(" (%.1f MB/s, %.0f edges/s).\n", megabytes * reader->passes / seconds, (double)reader->edgesRead * reader->passes / seconds);
+    printEdgeFileWarnings(reader);
+}
+
+/*
+    This function warns about the edges that were skipped and about the rest of the file if readEdge stopped before its end,
+    e.g., at a line with a letter in it, so that a graph missing most of its edges is not taken for the whole file.
+    The header count is only given for a file or stream that has a header.
+*/
+void printEdgeFileWarnings(EdgeFileReader *reader) {
+    if (reader->stoppedEarly && reader->numEdges > 0) {
+        printf("Warning: reading stopped at byte %lld, at a token that is not a number or an ID without its pair, "
+               "after %lld of the %d edges in the header. The rest of the file was not read.\n",
+               reader->stopOffset, reader->edgesRead + reader->edgesRejected, reader->numEdges);
+    } else if (reader->stoppedEarly) {
+        printf("Warning: reading stopped at byte %lld, at a token that is not a number or an ID without its pair, "
+               "after %lld edges. The rest of the stream was not read.\n", reader->stopOffset, reader->edgesRead + reader->edgesRejected);
+    }
+    if (reader->edgesRejected > 0 && reader->growVertices) {
+        printf("Warning: %lld edges were skipped because an ID is negative or above %d.\n", reader->edgesRejected, reader->maxID);
+    } else if (reader->edgesRejected > 0) {
+        printf("Warning: %lld edges were skipped because an ID is outside 0 to %d.\n", reader->edgesRejected, reader->numVertices - 1);
+    }
+}
+
+/*
+    This function closes the file and frees the memory allocated for the reader.
+    A stream opened by openEdgeStream is left open for its owner.
+*/
+void closeEdgeFile(EdgeFileReader *reader) {
+    if (reader != NULL) {
+        if (reader->ownsFile) {
+            fclose(reader->fp);
+        }
+        free(reader->buffer);
+        free(reader);
+    }
+}
@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Streaming ingestion of a social graph from stdin or a pipe, e.g., the edge list written by another tool, without staging it
+    in a file first.
+
+    A stream can only be read once and may have no header, so the loaders in adjacencyList.c and adjacencyCSR.c, which size
+    everything from the header and read the CSR edges twice, cannot be used. Here the vertex space grows with the highest ID read,
+    up to the maxID given to openEdgeStream in edgeFileReader.c, so one stray ID cannot make every per-vertex array huge, and:
+        list       the edges are appended to an adjacency list as they arrive. The heads grow by doubling and the nodes come from
+                   the node pool in slabs, so no edge is ever copied. The list is then normalized as in loadAdjacencyListFromReader,
+                   which needs a sorted CSR copy of it for a moment.
+        csr        a single pass cannot place an edge before the degrees are known, so the ID pairs are kept in one array that
+                   grows by doubling, and the degrees are counted as they arrive. The pairs are then moved into the slots of their
+                   first ID by swapping them in place, first into ranges of vertices and then by vertex, and the second IDs are packed into the front of the same array, which is
+                   shrunk to become the neighbors. Besides the final graph, this only takes the other half of the pairs, 4 bytes
+                   per edge, until the shrink, instead of a second copy of every edge.
+        matrix     the rows grow by doubling (addVertex_AdjMatrix in graphUpdates.c) and the cells are set as the edges arrive;
+                   the cells past the last vertex are given back at the end.
+        bitmatrix  the same with the bits, in one array whose capacity grows by an eighth and whose rows are laid out again
+                   in place each time, and once more at the end to fit the number of vertices exactly.
+    Every format then drops the duplicates, self-loops and one-way entries, as the loaders of a file do.
+    The input itself is read EDGE_READER_BLOCK_SIZE bytes at a time, so only the edges kept, not the text, take memory.
+*/
+
+#define EDGE_STREAM_FIRST_EDGES (1 << 16) //room for edges set aside first when the stream has no header to size it
+#define EDGE_STREAM_BUCKETS 256 //ranges of vertices the CSR stream moves its pairs into before sorting them by vertex
+
+/*
+    This function reads the edges of a stream opened by openEdgeStream and stores them in an adjacency list, growing the heads as
+    higher IDs arrive. The friends of each vertex stay in the order of the stream, and duplicates, self-loops and one-way entries
+    are then dropped by normalizeAdjacencyList, as in loadAdjacencyListFromReader.
+*/
+singlyNode** loadAdjacencyListFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges)
+{
+    int ID1, ID2, tailCapacity;
+    singlyNode *newNode;
+
+    *numVertices = 0;
+    singlyNode **adjList = createAdjacencyList(0, reader->numEdges > 0 ? reader->numEdges : EDGE_STREAM_FIRST_EDGES);
+    tailCapacity = reader->numVertices > 16 ? reader->numVertices : 16;
+    singlyNode **tails = malloc(tailCapacity * sizeof(singlyNode*)); //tails[i] is the last node of list i, or NULL if it is empty
+    if (tails == NULL) {
+        printf("Memory allocation for adjacency list has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    while (readEdge(reader, &ID1, &ID2)) {
+        if (reader->numVertices > tailCapacity) {
+            while (reader->numVertices > tailCapacity) {
+                tailCapacity *= 2;
+            }
+            tails = realloc(tails, tailCapacity * sizeof(singlyNode*));
+            if (tails == NULL) {
+                printf("Memory allocation for adjacency list has failed. Terminating program...\n");
+                exit(-1);
+            }
+        }
+        while (*numVertices < reader->numVertices) {
+            tails[*numVertices] = NULL;
+            adjList = addVertex_AdjList(adjList, numVertices); //check graphUpdates.c for the implementation of addVertex_AdjList
+        }
+
+        newNode = allocateNode(getNodePool_AdjList(adjList), ID2); //check data_structures.c for the implementation of allocateNode
+        if (tails[ID1] == NULL) {
+            adjList[ID1] = newNode;
+        } else {
+            tails[ID1]->nextNode = newNode;
+        }
+        tails[ID1] = newNode;
+    }
+    while (*numVertices < reader->numVertices) { //vertices of the header that no edge mentions
+        adjList = addVertex_AdjList(adjList, numVertices);
+    }
+    *numEdges = (int)reader->edgesRead;
+    free(tails);
+    normalizeAdjacencyList(adjList, *numVertices); //check graphValidation.c for the implementation of normalizeAdjacencyList
+    return adjList;
+}
+
+/*
+    This function sorts the pairs of vertices first to last - 1, which start at offsets[first], into buckets of 2^shift vertices
+    in place. cursors[b] is the first slot of bucket b on entry and its end on return. The pair taken out of the first free slot
+    of a bucket is carried from slot to slot, each time swapped with the pair in the slot of the bucket it belongs to, until a
+    pair of that bucket comes back, so every pair is moved once and no second array is needed.
+*/
+void movePairsToBuckets_Stream(int *pairs, int *offsets, int first, int last, int shift, int *cursors)
+{
+    int b, c, v, ID2, temp, end;
+    size_t slot;
+    for (b = 0; first + (b << shift) < last; b++) {
+        end = offsets[first + ((b + 1) << shift) < last ? first + ((b + 1) << shift) : last];
+        while (cursors[b] < end) {
+            slot = 2 * (size_t)cursors[b];
+            v = pairs[slot];
+            ID2 = pairs[slot + 1];
+            while ((c = (v - first) >> shift) != b) {
+                slot = 2 * (size_t)cursors[c]++;
+                temp = pairs[slot];
+                pairs[slot] = v;
+                v = temp;
+                temp = pairs[slot + 1];
+                pairs[slot + 1] = ID2;
+                ID2 = temp;
+            }
+            slot = 2 * (size_t)cursors[b]++;
+            pairs[slot] = v;
+            pairs[slot + 1] = ID2;
+        }
+    }
+}
+
+/*
+    This function reads the edges of a stream opened by openEdgeStream into a graph in CSR form.
+    The pairs are read into one array and the degrees counted, which replaces the counting pass of loadSortedCSRGraphFromReader.
+    The pairs are then sorted by their first ID in place with movePairsToBuckets_Stream, and their second IDs packed into the neighbors. The neighbors are then made unique and mutual with normalizeNeighbors_CSR, as in loadCSRGraphFromReader.
+*/
+CSRGraph* loadCSRGraphFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges)
+{
+    int ID1, ID2, i, shift, degreeCapacity;
+    int cursors[EDGE_STREAM_BUCKETS];
+    size_t k, count = 0;
+    size_t capacity = reader->numEdges > 0 ? (size_t)reader->numEdges : EDGE_STREAM_FIRST_EDGES;
+    int *pairs = malloc(2 * capacity * sizeof(int)); //ID1 and ID2 of each edge, one after the other
+    degreeCapacity = reader->numVertices > 16 ? reader->numVertices : 16;
+    int *degrees = calloc(degreeCapacity, sizeof(int));
+    if (pairs == NULL || degrees == NULL) {
+        printf("Memory allocation for the edge stream has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    while (readEdge(reader, &ID1, &ID2)) {
+        if (count == capacity) {
+            capacity *= 2;
+            pairs = realloc(pairs, 2 * capacity * sizeof(int));
+        }
+        if (reader->numVertices > degreeCapacity) {
+            i = degreeCapacity;
+            while (reader->numVertices > degreeCapacity) {
+                degreeCapacity *= 2;
+            }
+            degrees = realloc(degrees, degreeCapacity * sizeof(int));
+            if (degrees != NULL) {
+                memset(degrees + i, 0, (degreeCapacity - i) * sizeof(int));
+            }
+        }
+        if (pairs == NULL || degrees == NULL) {
+            printf("Memory allocation for the edge stream has failed. Terminating program...\n");
+            exit(-1);
+        }
+        pairs[2 * count] = ID1;
+        pairs[2 * count + 1] = ID2;
+        degrees[ID1]++;
+        count++;
+    }
+    *numVertices = reader->numVertices;
+    *numEdges = (int)count;
+    CSRGraph *graph = createCSRGraph(*numVertices, *numEdges); //check adjacencyCSR.c for the implementation of createCSRGraph
+    free(graph->neighbors); //the pairs become the neighbors below
+    for (i = 0; i < *numVertices; i++) {
+        graph->offsets[i + 1] = graph->offsets[i] + degrees[i];
+        degrees[i] = graph->offsets[i]; //from here on, the next slot of vertex i that does not hold one of its pairs yet
+    }
+
+    //move the pairs into at most 256 ranges of vertices first, whose free slots stay in cache, then each range by vertex,
+    //which only touches the slots of that range
+    shift = 0;
+    while (((long long)*numVertices - 1) >> shift >= EDGE_STREAM_BUCKETS) {
+        shift++;
+    }
+    for (i = 0; i < *numVertices; i += 1 << shift) {
+        cursors[i >> shift] = graph->offsets[i];
+    }
+    movePairsToBuckets_Stream(pairs, graph->offsets, 0, *numVertices, shift, cursors);
+    for (i = 0; i < *numVertices; i += 1 << shift) {
+        movePairsToBuckets_Stream(pairs, graph->offsets, i, (i + (1 << shift) < *numVertices ? i + (1 << shift) : *numVertices), 0, degrees + i);
+    }
+    free(degrees);
+
+    //keep the second ID of every pair; slot k is written after pair k, which covers it, has been read
+    for (k = 0; k < count; k++) {
+        pairs[k] = pairs[2 * k + 1];
+    }
+    graph->neighbors = realloc(pairs, (count > 0 ? count : 1) * sizeof(int));
+    if (graph->neighbors == NULL) {
+        printf("Memory allocation for CSR neighbors has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < *numVertices; i++) {
+        qsort(graph->neighbors + graph->offsets[i], graph->offsets[i + 1] - graph->offsets[i], sizeof(int), compareIntegers);
+    }
+    normalizeNeighbors_CSR(graph); //check adjacencyCSR.c for the implementation of normalizeNeighbors_CSR
+    return graph;
+}
+
+/*
+    This function reads the edges of a stream opened by openEdgeStream into an adjacency matrix, adding rows and columns with
+    addVertex_AdjMatrix as higher IDs arrive. The rows are then shrunk to the number of vertices, and the cells are made mutual
+    by normalizeAdjMatrix, as in loadAdjMatrixFromReader.
+*/
+bool** loadAdjMatrixFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges)
+{
+    int i, ID1, ID2, capacity = 0;
+    bool **adjMatrix = NULL;
+
+    *numVertices = 0;
+    while (readEdge(reader, &ID1, &ID2)) {
+        while (*numVertices < reader->numVertices) {
+            adjMatrix = addVertex_AdjMatrix(adjMatrix, numVertices, &capacity); //check graphUpdates.c for the implementation of addVertex_AdjMatrix
+        }
+        adjMatrix[ID1][ID2] = true;
+    }
+    while (*numVertices < reader->numVertices) { //vertices of the header that no edge mentions
+        adjMatrix = addVertex_AdjMatrix(adjMatrix, numVertices, &capacity);
+    }
+    if (adjMatrix == NULL) { //an empty stream still gives a matrix, with no rows
+        adjMatrix = malloc(sizeof(bool*));
+        if (adjMatrix == NULL) {
+            printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    for (i = 0; i < *numVertices && *numVertices < capacity; i++) {
+        adjMatrix[i] = realloc(adjMatrix[i], *numVertices * sizeof(bool));
+        if (adjMatrix[i] == NULL) {
+            printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    *numEdges = (int)reader->edgesRead;
+    normalizeAdjMatrix(adjMatrix, *numVertices); //check adjacencyMatrix.c for the implementation of normalizeAdjMatrix
+    return adjMatrix;
+}
+
+/*
+    This function lays the rows of a bit matrix out again for numVertices vertices, keeping the bits of the rows and columns
+    that both layouts have. The array is resized with realloc and the rows moved within it, towards the start from the first
+    row when it shrinks and towards the end from the last row when it grows, so the old and new layouts are never both held.
+*/
+void resizeBitMatrix_Stream(BitMatrix *bitMatrix, int numVertices)
+{
+    int i;
+    int wordsPerRow = (numVertices + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    int numRows = numVertices < bitMatrix->numVertices ? numVertices : bitMatrix->numVertices;
+    size_t size = (size_t)numVertices * wordsPerRow;
+    uint64_t *bits;
+
+    if (numVertices <= bitMatrix->numVertices) {
+        for (i = 0; i < numRows; i++) {
+            memmove(bitMatrix->bits + (size_t)i * wordsPerRow, bitMatrix->bits + (size_t)i * bitMatrix->wordsPerRow, wordsPerRow * sizeof(uint64_t));
+        }
+        bits = realloc(bitMatrix->bits, (size > 0 ? size : 1) * sizeof(uint64_t));
+    } else {
+        bits = realloc(bitMatrix->bits, size * sizeof(uint64_t));
+        if (bits != NULL) {
+            memset(bits + (size_t)numRows * wordsPerRow, 0, (size - (size_t)numRows * wordsPerRow) * sizeof(uint64_t));
+            for (i = numRows - 1; i >= 0; i--) {
+                memmove(bits + (size_t)i * wordsPerRow, bits + (size_t)i * bitMatrix->wordsPerRow, bitMatrix->wordsPerRow * sizeof(uint64_t));
+                memset(bits + (size_t)i * wordsPerRow + bitMatrix->wordsPerRow, 0, (wordsPerRow - bitMatrix->wordsPerRow) * sizeof(uint64_t));
+            }
+        }
+    }
+    if (bits == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    bitMatrix->bits = bits;
+    bitMatrix->numVertices = numVertices;
+    bitMatrix->wordsPerRow = wordsPerRow;
+}
+
+/*
+    This function reads the edges of a stream opened by openEdgeStream into a bit matrix. Room is kept for a capacity of vertices,
+    which grows by an eighth, or up to the new ID, whenever an ID does not fit; the matrix takes the square of it, so doubling
+    could take four times the final size. The bits are then laid out for the number of vertices read and made mutual
+    by normalizeBitMatrix, as in loadBitMatrixFromReader.
+*/
+BitMatrix* loadBitMatrixFromStream(EdgeFileReader *reader, int *numVertices, int *numEdges)
+{
+    int ID1, ID2, capacity = reader->numVertices > BITS_PER_WORD ? reader->numVertices : BITS_PER_WORD;
+    BitMatrix *bitMatrix = malloc(sizeof(BitMatrix));
+    if (bitMatrix == NULL) {
+        printf("Memory allocation for bit matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    bitMatrix->numVertices = 0; //while loading, the number of rows laid out, i.e., the capacity
+    bitMatrix->wordsPerRow = 0;
+    bitMatrix->bits = NULL;
+    bitMatrix->verifiedSymmetric = false;
+    resizeBitMatrix_Stream(bitMatrix, capacity);
+
+    while (readEdge(reader, &ID1, &ID2)) {
+        if (reader->numVertices > capacity) {
+            capacity += capacity / 8;
+            if (reader->numVertices > capacity) {
+                capacity = reader->numVertices;
+            }
+            resizeBitMatrix_Stream(bitMatrix, capacity);
+        }
+        bitMatrix->bits[(size_t)ID1 * bitMatrix->wordsPerRow + ID2 / BITS_PER_WORD] |= (uint64_t)1 << (ID2 % BITS_PER_WORD);
+    }
+    *numVertices = reader->numVertices;
+    *numEdges = (int)reader->edgesRead;
+    resizeBitMatrix_Stream(bitMatrix, *numVertices);
+    normalizeBitMatrix(bitMatrix); //check adjacencyBitMatrix.c for the implementation of normalizeBitMatrix
+    return bitMatrix;
+}
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Format-independent access to a loaded social graph, used by the benchmark and the batch query mode.
+    The interactive menu in main.c keeps working on the format pointers directly.
+*/
+
+char *graphFormatNames[GRAPH_NUM_FORMATS] = {"list", "matrix", "csr", "bitmatrix"};
+char *searchMethodNames[SEARCH_NUM_METHODS] = {"bfs", "dfs", "dobfs", "bibfs", "pbfs"};
+
+/*
+    This function returns the index of name in names, or -1 if it is not there.
+*/
+int findNameIndex(char *name, char **names, int numNames)
+{
+    int i;
+    for (i = 0; i < numNames; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+    This function loads the social graph in fileString, which can be a .txt or a .mat file, into the given format.
+    If useSnapshot is true and there is an up-to-date snapshot of the file, it is loaded instead.
+    A snapshot or .mat file is read into a CSR graph first and then converted to the format.
+    The updates in the delta log of the file, if there is one, are replayed on top of a snapshot (check graphUpdates.c).
+    A .txt file is loaded into CSR form by numThreads threads, or one per processor if numThreads is 0 or less (check parallelGraphLoader.c).
+    If its edges could not be read to the end of the file, a warning is printed and handle->stoppedEarly is set.
+    Returns false if the file cannot be loaded.
+*/
+bool loadGraphHandle(char *fileString, int format, bool useSnapshot, int numThreads, GraphHandle *handle)
+{
+    char snapshotPath[600];
+    CSRGraph *csrGraph = NULL;
+    EdgeFileReader *reader;
+
+    memset(handle, 0, sizeof(GraphHandle));
+    handle->format = format;
+
+    if (useSnapshot) {
+        getSnapshotPath(fileString, snapshotPath, sizeof(snapshotPath));
+        csrGraph = loadGraphSnapshot(snapshotPath, fileString, &handle->numVertices, &handle->numEdges);
+        if (csrGraph != NULL) {
+            getDeltaLogPath(fileString, snapshotPath, sizeof(snapshotPath));
+            csrGraph = replayDeltaLog(csrGraph, snapshotPath, &handle->numVertices, &handle->numEdges);
+        }
+    }
+    if (csrGraph == NULL && isMatFile(fileString)) {
+        csrGraph = loadCSRGraphFromMatFile(fileString, &handle->numVertices, &handle->numEdges);
+        if (csrGraph == NULL) {
+            return false;
+        }
+    }
+
+    if (csrGraph != NULL) {
+        if (format == GRAPH_FORMAT_CSR) {
+            handle->csrGraph = csrGraph;
+            return true;
+        } else if (format == GRAPH_FORMAT_LIST) {
+            handle->adjList = convertCSRToAdjList(csrGraph);
+        } else if (format == GRAPH_FORMAT_MATRIX) {
+            handle->adjMatrix = convertCSRToAdjMatrix(csrGraph);
+        } else {
+            handle->bitMatrix = convertCSRToBitMatrix(csrGraph);
+        }
+        freeCSRGraph(csrGraph);
+        return true;
+    }
+
+    reader = openEdgeFile(fileString);
+    if (reader == NULL) {
+        return false;
+    }
+    if (format == GRAPH_FORMAT_LIST) {
+        handle->adjList = loadAdjacencyListFromReader(reader, &handle->numVertices, &handle->numEdges);
+    } else if (format == GRAPH_FORMAT_MATRIX) {
+        handle->adjMatrix = loadAdjMatrixFromReader(reader, &handle->numVertices, &handle->numEdges);
+    } else if (format == GRAPH_FORMAT_CSR) {
+        handle->csrGraph = loadCSRGraphParallel(reader, fileString, numThreads, &handle->numVertices, &handle->numEdges);
+    } else {
+        handle->bitMatrix = loadBitMatrixFromReader(reader, &handle->numVertices, &handle->numEdges);
+    }
+    printEdgeFileWarnings(reader); //check edgeFileReader.c for the implementation of printEdgeFileWarnings
+    handle->stoppedEarly = reader->stoppedEarly;
+    closeEdgeFile(reader);
+    return handle->adjList != NULL || handle->adjMatrix != NULL || handle->csrGraph != NULL || handle->bitMatrix != NULL;
+}
+
+/*
+    This function loads a social graph streamed through fp, e.g., stdin, into the given format, growing the number of vertices
+    to fit the IDs read, up to maxID. If hasHeader is true, the stream starts with the usual header line.
+    Check edgeStream.c for how each format is built.
+    If the edges could not be read to the end of the stream, handle->stoppedEarly is set.
+    Returns false if the header is invalid.
+*/
+bool loadStreamedGraphHandle(FILE *fp, bool hasHeader, int maxID, int format, GraphHandle *handle)
+{
+    EdgeFileReader *reader = openEdgeStream(fp, hasHeader, maxID); //check edgeFileReader.c for the implementation of openEdgeStream
+
+    memset(handle, 0, sizeof(GraphHandle));
+    handle->format = format;
+    if (reader == NULL) {
+        return false;
+    }
+    if (format == GRAPH_FORMAT_LIST) {
+        handle->adjList = loadAdjacencyListFromStream(reader, &handle->numVertices, &handle->numEdges);
+    } else if (format == GRAPH_FORMAT_MATRIX) {
+        handle->adjMatrix = loadAdjMatrixFromStream(reader, &handle->numVertices, &handle->numEdges);
+    } else if (format == GRAPH_FORMAT_CSR) {
+        handle->csrGraph = loadCSRGraphFromStream(reader, &handle->numVertices, &handle->numEdges);
+    } else {
+        handle->bitMatrix = loadBitMatrixFromStream(reader, &handle->numVertices, &handle->numEdges);
+    }
+    printEdgeFileStats(reader);
+    handle->stoppedEarly = reader->stoppedEarly;
+    closeEdgeFile(reader);
+    return true;
+}
+
+/*
+    This function runs one connection search with the given method on a graph of any format, with the IDs of the graph,
+    which differ from those of the file if the graph was reordered.
+    SEARCH_PARALLEL_BFS uses handle->numThreads threads. Every method but SEARCH_BFS takes its arrays from scratch, made by
+    createSearchScratch for that method on this graph, or allocates them for this search alone if scratch is NULL.
+    Returns the path found, or NULL if there is no connection.
+*/
+int* searchGraph_GraphHandle(GraphHandle *handle, int method, int ID1, int ID2, int *pathLength, SearchScratch *scratch)
+{
+    int n = handle->numVertices;
+    if (method == SEARCH_PARALLEL_BFS) {
+        switch (handle->format) {
+            case GRAPH_FORMAT_LIST: return findConnections_ParallelBFS_AdjList(handle->adjList, n, ID1, ID2, pathLength, handle->numThreads, scratch);
+            case GRAPH_FORMAT_MATRIX: return findConnections_ParallelBFS_AdjMatrix(handle->adjMatrix, n, ID1, ID2, pathLength, handle->numThreads, scratch);
+            case GRAPH_FORMAT_CSR: return findConnections_ParallelBFS_CSR(handle->csrGraph, ID1, ID2, pathLength, handle->numThreads, scratch);
+            default: return findConnections_ParallelBFS_BitMatrix(handle->bitMatrix, ID1, ID2, pathLength, handle->numThreads, scratch);
+        }
+    }
+    switch (handle->format * SEARCH_PARALLEL_BFS + method) { //SEARCH_PARALLEL_BFS is the number of serial methods
+        case 0: return findConnections_BFS_AdjList(handle->adjList, n, ID1, ID2, pathLength);
+        case 1: return findConnections_DFS_AdjList(handle->adjList, n, ID1, ID2, pathLength, scratch);
+        case 2: return findConnections_DOBFS_AdjList(handle->adjList, n, ID1, ID2, pathLength, NULL, scratch);
+        case 3: return findConnections_BiBFS_AdjList(handle->adjList, n, ID1, ID2, pathLength, NULL, scratch);
+        case 4: return findConnections_BFS_AdjMatrix(handle->adjMatrix, n, ID1, ID2, pathLength);
+        case 5: return findConnections_DFS_AdjMatrix(handle->adjMatrix, n, ID1, ID2, pathLength, scratch);
+        case 6: return findConnections_DOBFS_AdjMatrix(handle->adjMatrix, n, ID1, ID2, pathLength, NULL, scratch);
+        case 7: return findConnections_BiBFS_AdjMatrix(handle->adjMatrix, n, ID1, ID2, pathLength, NULL, scratch);
+        case 8: return findConnections_BFS_CSR(handle->csrGraph, ID1, ID2, pathLength);
+        case 9: return findConnections_DFS_CSR(handle->csrGraph, ID1, ID2, pathLength, scratch);
+        case 10: return findConnections_DOBFS_CSR(handle->csrGraph, ID1, ID2, pathLength, NULL, scratch);
+        case 11: return findConnections_BiBFS_CSR(handle->csrGraph, ID1, ID2, pathLength, NULL, scratch);
+        case 12: return findConnections_BFS_BitMatrix(handle->bitMatrix, ID1, ID2, pathLength);
+        case 13: return findConnections_DFS_BitMatrix(handle->bitMatrix, ID1, ID2, pathLength, scratch);
+        case 14: return findConnections_DOBFS_BitMatrix(handle->bitMatrix, ID1, ID2, pathLength, NULL, scratch);
+        default: return findConnections_BiBFS_BitMatrix(handle->bitMatrix, ID1, ID2, pathLength, NULL, scratch);
+    }
+}
+
+/*
+    This function runs one connection search with the given method on a graph of any format.
+    ID1, ID2 and the returned path use the IDs of the file, even if the graph was reordered by reorderGraphHandle.
+    Returns the path found, or NULL if there is no connection.
+*/
+int* findConnections_GraphHandle(GraphHandle *handle, int method, int ID1, int ID2, int *pathLength)
+{
+    return findConnectionsWithScratch_GraphHandle(handle, method, ID1, ID2, pathLength, NULL);
+}
+
+/*
+    This function runs one connection search like findConnections_GraphHandle, with the arrays of the search taken from scratch,
+    which is made by createSearchScratch for the method on this graph and reused by every search given it, or NULL.
+*/
+int* findConnectionsWithScratch_GraphHandle(GraphHandle *handle, int method, int ID1, int ID2, int *pathLength, SearchScratch *scratch)
+{
+    int i;
+    int *path;
+    if (handle->oldToNew == NULL) {
+        return searchGraph_GraphHandle(handle, method, ID1, ID2, pathLength, scratch);
+    }
+    if (ID1 < 0 || ID1 >= handle->numVertices || ID2 < 0 || ID2 >= handle->numVertices) {
+        return NULL; //every search returns NULL for an out-of-range ID, which cannot be mapped
+    }
+    path = searchGraph_GraphHandle(handle, method, handle->oldToNew[ID1], handle->oldToNew[ID2], pathLength, scratch);
+    if (path != NULL) {
+        for (i = 0; i < *pathLength; i++) {
+            path[i] = handle->newToOld[path[i]];
+        }
+    }
+    return path;
+}
+
+/*
+    This function returns the number of neighbor checks the direction-optimizing BFS does between ID1 and ID2, which use the IDs of the file.
+    With allowBottomUp false every level is expanded top-down, which gives the checks of a plain level-by-level BFS.
+    Returns 0 if an ID is out of range.
+*/
+long long countEdgesExamined_GraphHandle(GraphHandle *handle, bool allowBottomUp, int ID1, int ID2)
+{
+    int pathLength, n = handle->numVertices;
+    int *path;
+    long long edgesExamined = 0;
+
+    if (ID1 < 0 || ID1 >= n || ID2 < 0 || ID2 >= n || ID1 == ID2) {
+        return 0;
+    }
+    if (handle->oldToNew != NULL) {
+        ID1 = handle->oldToNew[ID1];
+        ID2 = handle->oldToNew[ID2];
+    }
+    switch (handle->format) {
+        case GRAPH_FORMAT_LIST:
+            path = findConnections_DOBFS(handle->adjList, n, ID1, ID2, &pathLength, &edgesExamined, computeDegrees_DOBFS_AdjList,
+                                         topDownStep_DOBFS_AdjList, bottomUpStep_DOBFS_AdjList, allowBottomUp, NULL);
+            break;
+        case GRAPH_FORMAT_MATRIX:
+            path = findConnections_DOBFS(handle->adjMatrix, n, ID1, ID2, &pathLength, &edgesExamined, computeDegrees_DOBFS_AdjMatrix,
+                                         topDownStep_DOBFS_AdjMatrix, bottomUpStep_DOBFS_AdjMatrix, allowBottomUp, NULL);
+            break;
+        case GRAPH_FORMAT_CSR:
+            path = findConnections_DOBFS(handle->csrGraph, n, ID1, ID2, &pathLength, &edgesExamined, computeDegrees_DOBFS_CSR,
+                                         topDownStep_DOBFS_CSR, bottomUpStep_DOBFS_CSR, allowBottomUp, NULL);
+            break;
+        default:
+            path = findConnections_DOBFS(handle->bitMatrix, n, ID1, ID2, &pathLength, &edgesExamined, computeDegrees_DOBFS_BitMatrix,
+                                         topDownStep_DOBFS_BitMatrix, bottomUpStep_DOBFS_BitMatrix, allowBottomUp, NULL);
+            break;
+    }
+    free(path);
+    return edgesExamined;
+}
+
+/*
+    This function stores the friends of vertex in buffer, which has room for numVertices entries, in ascending order,
+    i.e., the order in which findConnections_BFS_* visits them. Vertex and friends use the IDs of the graph, which are the new
+    IDs if the vertices were relabeled, so that searches can run on them and only map the IDs of their answers back.
+    Returns the number of friends.
+*/
+int collectGraphNeighbors_GraphHandle(GraphHandle *handle, int vertex, int *buffer)
+{
+    int i, count;
+    BiBFSMatrix matrix;
+
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        count = collectNeighbors_BiBFS_AdjList(handle->adjList, vertex, buffer);
+        for (i = 1; i < count; i++) {
+            if (buffer[i - 1] > buffer[i]) { //lists keep the order of the file, unless they were rebuilt from a CSR graph
+                qsort(buffer, count, sizeof(int), compareIntegers);
+                break;
+            }
+        }
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        matrix.adjMatrix = handle->adjMatrix;
+        matrix.numVertices = handle->numVertices;
+        count = collectNeighbors_BiBFS_AdjMatrix(&matrix, vertex, buffer);
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        count = collectNeighbors_BiBFS_CSR(handle->csrGraph, vertex, buffer);
+    } else {
+        count = collectNeighbors_BiBFS_BitMatrix(handle->bitMatrix, vertex, buffer);
+    }
+    return count;
+}
+
+/*
+    This function stores the friends of vertex in buffer, which has room for numVertices entries, in ascending order.
+    Vertex and friends use the IDs of the file. Returns the number of friends.
+*/
+int collectNeighbors_GraphHandle(GraphHandle *handle, int vertex, int *buffer)
+{
+    int i, count;
+
+    if (handle->oldToNew == NULL) {
+        return collectGraphNeighbors_GraphHandle(handle, vertex, buffer);
+    }
+    count = collectGraphNeighbors_GraphHandle(handle, handle->oldToNew[vertex], buffer);
+    for (i = 0; i < count; i++) {
+        buffer[i] = handle->newToOld[buffer[i]];
+    }
+    qsort(buffer, count, sizeof(int), compareIntegers); //ascending in the new IDs is not ascending in those of the file
+    return count;
+}
+
+/*
+    This function frees the graph of a handle loaded by loadGraphHandle, and its vertex ordering if it has one.
+*/
+void freeGraphHandle(GraphHandle *handle)
+{
+    if (handle->adjList != NULL) {
+        freeAdjacencyList(handle->adjList, handle->numVertices);
+    } else if (handle->adjMatrix != NULL) {
+        freeAdjMatrix(handle->adjMatrix, handle->numVertices);
+    } else if (handle->csrGraph != NULL) {
+        freeCSRGraph(handle->csrGraph);
+    } else if (handle->bitMatrix != NULL) {
+        freeBitMatrix(handle->bitMatrix);
+    }
+    free(handle->oldToNew);
+    free(handle->newToOld);
+    memset(handle, 0, sizeof(GraphHandle));
+}
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "data_structures.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+    Binary graph snapshots for near-instant startup.
+
+    A snapshot is a graph in CSR form written straight to disk: a 64-byte header followed by the raw offsets array
+    (numVertices + 1 ints) and the raw neighbors array (numEdges ints). Loading one maps the file into memory and points
+    a CSRGraph at it, so there is no text to parse and no allocation per edge.
+    The header records the size and modification time of the .txt file the graph came from, and the snapshot is refused
+    if that file has changed since, as well as if the version, byte order, size or checksum do not match.
+*/
+
+#define SNAPSHOT_MAGIC "MCO2SNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304u //reads back differently on a machine with the other byte order
+#define SNAPSHOT_FLAG_SORTED 1u //each vertex's neighbors are in ascending order
+#define SNAPSHOT_FLAG_MUTUAL 2u //the graph was verifiedSymmetric, i.e., its neighbors are unique and every edge is stored both ways
+
+typedef struct GraphSnapshotHeaderTag {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t byteOrder;
+    int32_t numVertices;
+    int64_t numEntries; //entries in the neighbors array
+    int64_t numEdges; //number of edges on the first line of the .txt file
+    int64_t sourceSize; //size of the .txt file in bytes
+    int64_t sourceModifiedTime; //modification time of the .txt file
+    uint64_t checksum; //FNV-1a over the offsets and neighbors arrays
+} GraphSnapshotHeader;
+
+/*
+    This function computes a 64-bit FNV-1a hash over an array of integers, continuing from hash.
+*/
+uint64_t hashIntegers_Snapshot(uint64_t hash, const int32_t *values, int64_t count)
+{
+    int64_t i;
+    for (i = 0; i < count; i++) {
+        hash ^= (uint32_t)values[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+    This function stores the path of the snapshot for a .txt file in snapshotPath, which is the .txt path with ".snap" added.
+*/
+void getSnapshotPath(char *fileString, char *snapshotPath, size_t size)
+{
+    snprintf(snapshotPath, size, "%s.snap", fileString);
+}
+
+/*
+    This function stores the size and modification time of a file, and returns false if the file cannot be found.
+*/
+bool getSourceFileInfo_Snapshot(char *fileString, int64_t *size, int64_t *modifiedTime)
+{
+    struct stat info;
+    if (fileString == NULL || stat(fileString, &info) != 0) {
+        return false;
+    }
+    *size = (int64_t)info.st_size;
+    *modifiedTime = (int64_t)info.st_mtime;
+    return true;
+}
+
+/*
+    This function writes a graph in CSR form to a snapshot file.
+    numEdges is the edge count from the header of the .txt file at fileString, which is also used to tell later if the snapshot is stale.
+    Returns true if the snapshot was written.
+*/
+bool saveGraphSnapshot(CSRGraph *graph, int numEdges, char *snapshotPath, char *fileString)
+{
+    GraphSnapshotHeader header;
+    int i, k;
+    uint32_t flags = SNAPSHOT_FLAG_SORTED;
+
+    for (i = 0; i < graph->numVertices; i++) {
+        for (k = graph->offsets[i] + 1; k < graph->offsets[i + 1]; k++) {
+            if (graph->neighbors[k - 1] > graph->neighbors[k]) {
+                flags &= ~SNAPSHOT_FLAG_SORTED;
+            }
+        }
+    }
+
+    if (graph->verifiedSymmetric && (flags & SNAPSHOT_FLAG_SORTED)) {
+        flags |= SNAPSHOT_FLAG_MUTUAL;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = flags;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.numVertices = graph->numVertices;
+    header.numEntries = graph->numEdges;
+    header.numEdges = numEdges;
+    if (!getSourceFileInfo_Snapshot(fileString, &header.sourceSize, &header.sourceModifiedTime)) {
+        printf("Could not find %s to record in the snapshot.\n", fileString);
+        return false;
+    }
+    header.checksum = hashIntegers_Snapshot(14695981039346656037ULL, graph->offsets, (int64_t)graph->numVertices + 1);
+    header.checksum = hashIntegers_Snapshot(header.checksum, graph->neighbors, graph->numEdges);
+
+    FILE *fp = fopen(snapshotPath, "wb");
+    if (fp == NULL) {
+        printf("Could not create %s.\n", snapshotPath);
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1
+                && fwrite(graph->offsets, sizeof(int), graph->numVertices + 1, fp) == (size_t)graph->numVertices + 1
+                && fwrite(graph->neighbors, sizeof(int), graph->numEdges, fp) == (size_t)graph->numEdges;
+    if (fclose(fp) != 0) {
+        written = false;
+    }
+    if (!written) {
+        printf("Could not write %s.\n", snapshotPath);
+        remove(snapshotPath);
+    }
+    return written;
+}
+
+/*
+    This function maps a whole file into memory, read-only, and stores its size in mappedSize.
+    Returns a pointer to the mapped memory, or NULL if the file cannot be opened or mapped.
+*/
+void* mapFile_Snapshot(char *path, size_t *mappedSize)
+{
+    void *data = NULL;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); //the view keeps the mapping alive
+        }
+        *mappedSize = (size_t)size.QuadPart;
+    }
+    CloseHandle(file);
+#else
+    struct stat info;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            data = NULL;
+        }
+        *mappedSize = (size_t)info.st_size;
+    }
+    close(fd); //the mapping stays valid after the file is closed
+#endif
+    return data;
+}
+
+/*
+    This function unmaps a snapshot mapped by loadGraphSnapshot. It is called by freeCSRGraph.
+*/
+void unmapGraphSnapshot(void *mappedData, size_t mappedSize)
+{
+#if defined(_WIN32)
+    (void)mappedSize;
+    UnmapViewOfFile(mappedData);
+#else
+    munmap(mappedData, mappedSize);
+#endif
+}
+
+/*
+    This function loads a graph in CSR form from the snapshot file at snapshotPath.
+    If fileString is not NULL, the snapshot is only used if the .txt file there has the same size and modification time as when the snapshot was saved.
+    The offsets and neighbors of the returned graph point into the mapped file, so the graph must be freed with freeCSRGraph, which unmaps it.
+    A snapshot that was not saved verifiedSymmetric is instead copied out of the mapping and normalized with normalizeNeighbors_CSR,
+    since the CSR searches trust the stored neighbors.
+    Returns a pointer to the graph and stores its size in numVertices and numEdges, or returns NULL if there is no usable snapshot.
+*/
+CSRGraph* loadGraphSnapshot(char *snapshotPath, char *fileString, int *numVertices, int *numEdges)
+{
+    size_t mappedSize = 0;
+    void *data = mapFile_Snapshot(snapshotPath, &mappedSize);
+    if (data == NULL) {
+        return NULL; //no snapshot yet, which is not an error
+    }
+
+    GraphSnapshotHeader *header = data;
+    char *reason = NULL;
+    int64_t sourceSize, sourceModifiedTime, i;
+
+    if (mappedSize < sizeof(GraphSnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        reason = "it is not a graph snapshot";
+    } else if (header->version != SNAPSHOT_VERSION) {
+        reason = "it was saved by a different version of the program";
+    } else if (header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        reason = "it was saved on a machine with a different byte order";
+    } else if (header->numVertices <= 0 || header->numEntries < 0 || header->numEntries > INT32_MAX
+               || mappedSize != sizeof(GraphSnapshotHeader) + ((uint64_t)header->numVertices + 1 + (uint64_t)header->numEntries) * sizeof(int32_t)) {
+        reason = "its size does not match its header";
+    } else if (fileString != NULL && (!getSourceFileInfo_Snapshot(fileString, &sourceSize, &sourceModifiedTime)
+               || sourceSize != header->sourceSize || sourceModifiedTime != header->sourceModifiedTime)) {
+        reason = "the .txt file has changed since it was saved";
+    }
+
+    int32_t *offsets = (int32_t *)((char *)data + sizeof(GraphSnapshotHeader));
+    int32_t *neighbors = offsets + (reason == NULL ? header->numVertices + 1 : 0);
+    if (reason == NULL) {
+        uint64_t checksum = hashIntegers_Snapshot(14695981039346656037ULL, offsets, (int64_t)header->numVertices + 1);
+        checksum = hashIntegers_Snapshot(checksum, neighbors, header->numEntries);
+        if (checksum != header->checksum) {
+            reason = "its checksum does not match, so it may be corrupted";
+        }
+    }
+    if (reason == NULL) {
+        //the searches index arrays with these values directly, so make sure they are in range
+        bool valid = offsets[0] == 0 && offsets[header->numVertices] == header->numEntries;
+        for (i = 0; valid && i < header->numVertices; i++) {
+            valid = offsets[i] <= offsets[i + 1];
+        }
+        for (i = 0; valid && i < header->numEntries; i++) {
+            valid = neighbors[i] >= 0 && neighbors[i] < header->numVertices;
+        }
+        if (!valid) {
+            reason = "it contains an invalid vertex ID or offset";
+        }
+    }
+    if (reason != NULL) {
+        printf("Ignoring snapshot %s because %s.\n", snapshotPath, reason);
+        unmapGraphSnapshot(data, mappedSize);
+        return NULL;
+    }
+
+    *numVertices = header->numVertices;
+    *numEdges = (int)header->numEdges;
+    if (!(header->flags & SNAPSHOT_FLAG_MUTUAL)) {
+        CSRGraph *copy = createCSRGraph(header->numVertices, (int)header->numEntries); //check adjacencyCSR.c for the implementation of createCSRGraph
+        memcpy(copy->offsets, offsets, ((size_t)header->numVertices + 1) * sizeof(int));
+        memcpy(copy->neighbors, neighbors, (size_t)header->numEntries * sizeof(int));
+        for (i = 0; i < header->numVertices && !(header->flags & SNAPSHOT_FLAG_SORTED); i++) {
+            qsort(copy->neighbors + copy->offsets[i], copy->offsets[i + 1] - copy->offsets[i], sizeof(int), compareIntegers);
+        }
+        unmapGraphSnapshot(data, mappedSize);
+        normalizeNeighbors_CSR(copy); //check adjacencyCSR.c for the implementation of normalizeNeighbors_CSR
+        return copy;
+    }
+
+    CSRGraph *graph = malloc(sizeof(CSRGraph));
+    if (graph == NULL) {
+        printf("Memory allocation for CSR graph has failed. Terminating program...\n");
+        exit(-1);
+    }
+    graph->numVertices = header->numVertices;
+    graph->numEdges = (int)header->numEntries;
+    graph->offsets = offsets;
+    graph->neighbors = neighbors;
+    graph->mappedData = data;
+    graph->mappedSize = mappedSize;
+    graph->verifiedSymmetric = true;
+    return graph;
+}
@@ -0,0 +1,437 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "data_structures.h"
+
+/*
+    Degrees-of-separation statistics over a whole graph: connected components, the distance distribution, the mean separation
+    and the effective diameter, i.e., the distance within which 90% of the connected pairs are.
+
+    The components are counted with one BFS per component, in linear time. The distances are then measured in one of three ways:
+        exact     a multi-source BFS from every vertex (check multiSourceBFS.c), which takes time proportional to the number
+                  of vertices times the number of edges divided by MSBFS_LANES.
+        sample    the same, from a random sample of vertices. The counts are scaled up to the whole graph, and the mean
+                  separation comes with a 95% confidence interval from the spread between the sampled vertices.
+        hyperanf  HyperANF: every vertex keeps a HyperLogLog counter of the vertices within distance t of it, and each round
+                  merges the counters of its friends into it, so round t estimates the number of pairs within distance t.
+                  It takes one pass over the edges per distance level, with HYPERANF_REGISTERS bytes per vertex, and the pair
+                  counts have a relative standard error of about 1.04 / sqrt(HYPERANF_REGISTERS).
+    The auto method runs the multi-source BFS pass after pass, MSBFS_LANES sources at a time, until either every vertex has
+    been a source, which gives the exact numbers, or the passes so far show that this would go over the time budget. Then the
+    sample stops at STATS_SAMPLE_SHARE of the budget, and HyperANF, whose cost does not grow with the number of sources, gets
+    what is left of it, so the two together stay within the one budget.
+    This file uses log and sqrt, so on Linux the program has to be linked with -lm, e.g., gcc -O2 -pthread main.c -lm.
+*/
+
+#define HYPERANF_LOG2_REGISTERS 7
+#define HYPERANF_REGISTERS (1 << HYPERANF_LOG2_REGISTERS) //registers of one HyperLogLog counter
+#define STATS_SEED 12345 //seed of the sample of sources, so that a run can be repeated
+#define STATS_EFFECTIVE_DIAMETER_SHARE 0.9
+#define STATS_SAMPLE_SHARE 0.5 //share of the budget of the auto method that the sample may use when HyperANF has to run too
+
+char *statsMethodNames[STATS_NUM_METHODS] = {"auto", "exact", "sample", "hyperanf"};
+
+/*
+    This function counts the connected components of a graph of any format, with one BFS per component.
+    The friends of a vertex are listed by collectNeighbors.
+*/
+void countComponents(void *graph, int numVertices, BiBFSNeighborFunction collectNeighbors, ComponentStatistics *components)
+{
+    int i, k, count, head, tail, size;
+    double startTime = getWallClockTime();
+    bool *visited = calloc(numVertices > 0 ? numVertices : 1, sizeof(bool));
+    int *queue = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    int *neighbors = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    if (visited == NULL || queue == NULL || neighbors == NULL) {
+        printf("Memory allocation for the graph statistics has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    memset(components, 0, sizeof(ComponentStatistics));
+    for (i = 0; i < numVertices; i++) {
+        if (visited[i]) {
+            continue;
+        }
+        visited[i] = true;
+        queue[0] = i;
+        head = 0;
+        tail = 1;
+        while (head < tail) {
+            count = collectNeighbors(graph, queue[head++], neighbors);
+            for (k = 0; k < count; k++) {
+                if (!visited[neighbors[k]]) {
+                    visited[neighbors[k]] = true;
+                    queue[tail++] = neighbors[k];
+                }
+            }
+        }
+        size = tail; //the queue is not reused between components, so its length is the size of the component
+        components->numComponents++;
+        if (size > components->largestSize) {
+            components->largestSize = size;
+        }
+        if (size == 1) {
+            components->isolatedVertices++;
+        }
+    }
+    components->seconds = getWallClockTime() - startTime;
+    free(visited);
+    free(queue);
+    free(neighbors);
+}
+
+/*
+    This function computes the number of connected pairs, the highest distance, the mean separation and the effective diameter
+    of a distance distribution from its pair counts.
+*/
+void summarizeDistances(DistanceStatistics *stats, int numVertices)
+{
+    int d;
+    double weightedSum = 0, cumulative = 0, target;
+
+    stats->connectedPairs = 0;
+    stats->maxDistance = 0;
+    for (d = 1; d < numVertices; d++) {
+        if (stats->pairs[d] > 0) {
+            stats->connectedPairs += stats->pairs[d];
+            weightedSum += d * stats->pairs[d];
+            stats->maxDistance = d;
+        }
+    }
+    stats->meanSeparation = stats->connectedPairs > 0 ? weightedSum / stats->connectedPairs : 0;
+
+    //the effective diameter is interpolated between the last distance below the share of pairs and the first one at or above it
+    stats->effectiveDiameter = 0;
+    target = STATS_EFFECTIVE_DIAMETER_SHARE * stats->connectedPairs;
+    for (d = 1; d <= stats->maxDistance; d++) {
+        if (cumulative + stats->pairs[d] >= target) {
+            stats->effectiveDiameter = d - 1 + (stats->pairs[d] > 0 ? (target - cumulative) / stats->pairs[d] : 0);
+            break;
+        }
+        cumulative += stats->pairs[d];
+    }
+}
+
+/*
+    This function measures the distance distribution of a graph of any format with a multi-source BFS from up to maxSources
+    vertices, taken in a random order, MSBFS_LANES at a time. If budgetSeconds is more than 0, no further pass is started once
+    it would end after the budget, but at least one pass is always run. Once the passes so far show that the remaining sources
+    would not fit in the budget, the passes stop at sampleSeconds instead, so that the rest of the budget is left for HyperANF.
+    If every vertex ended up as a source, the numbers are exact and stats->method is STATS_METHOD_EXACT. Otherwise the counts
+    are scaled up from the sample and stats->method is STATS_METHOD_SAMPLE.
+    stats->pairs is allocated here and has to be freed by the caller.
+*/
+void measureDistances_MSBFS(void *graph, int numVertices, BiBFSNeighborFunction collectNeighbors, int maxSources,
+                            double budgetSeconds, double sampleSeconds, DistanceStatistics *stats)
+{
+    int i, j, d, swap, chunk, numSources = 0;
+    uint64_t state = STATS_SEED;
+    double startTime = getWallClockTime(), elapsed, secondsPerSource;
+    MultiSourceBFSResult result;
+
+    if (maxSources <= 0 || maxSources > numVertices) {
+        maxSources = numVertices;
+    }
+    memset(stats, 0, sizeof(DistanceStatistics));
+    stats->pairs = calloc(numVertices > 0 ? numVertices : 1, sizeof(double));
+    int *sources = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    int *reachable = malloc((maxSources > 0 ? maxSources : 1) * sizeof(int));
+    long long *distanceSums = malloc((maxSources > 0 ? maxSources : 1) * sizeof(long long));
+    long long *histogram = malloc((numVertices > 0 ? numVertices : 1) * sizeof(long long));
+    if (stats->pairs == NULL || sources == NULL || reachable == NULL || distanceSums == NULL || histogram == NULL) {
+        printf("Memory allocation for the graph statistics has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    //shuffle the vertices so that any prefix of them is a uniform sample without repeats
+    for (i = 0; i < numVertices; i++) {
+        sources[i] = i;
+    }
+    for (i = numVertices - 1; i > 0; i--) {
+        j = randomBelow(&state, i + 1);
+        swap = sources[i];
+        sources[i] = sources[j];
+        sources[j] = swap;
+    }
+
+    memset(&result, 0, sizeof(MultiSourceBFSResult));
+    result.histogram = histogram;
+    while (numSources < maxSources) {
+        chunk = maxSources - numSources < MSBFS_LANES ? maxSources - numSources : MSBFS_LANES;
+        result.sourceReachable = reachable + numSources;
+        result.sourceDistanceSums = distanceSums + numSources;
+        runMultiSourceBFS(graph, numVertices, sources + numSources, chunk, collectNeighbors, &result);
+        for (d = 1; d < numVertices; d++) {
+            stats->pairs[d] += histogram[d];
+        }
+        numSources += chunk;
+        elapsed = getWallClockTime() - startTime;
+        secondsPerSource = elapsed / numSources;
+        if (budgetSeconds > 0 && secondsPerSource * maxSources > budgetSeconds) {
+            budgetSeconds = sampleSeconds; //the exact numbers are out of reach, so only a sample is taken
+        }
+        if (budgetSeconds > 0 && elapsed + secondsPerSource * MSBFS_LANES > budgetSeconds) {
+            break;
+        }
+    }
+
+    stats->numSources = numSources;
+    stats->method = numSources == numVertices ? STATS_METHOD_EXACT : STATS_METHOD_SAMPLE;
+    if (stats->method == STATS_METHOD_SAMPLE) {
+        for (d = 1; d < numVertices; d++) {
+            stats->pairs[d] *= (double)numVertices / numSources;
+        }
+    }
+    summarizeDistances(stats, numVertices);
+
+    /*
+        The mean separation of a sample is a ratio estimate, sum of distances over number of pairs, so its standard error comes
+        from the residuals distanceSums[i] - mean * reachable[i] of the sampled sources, with the finite population correction.
+    */
+    if (stats->method == STATS_METHOD_SAMPLE && numSources > 1 && stats->connectedPairs > 0) {
+        double meanReachable = 0, residuals = 0, reachableSpread = 0, correction = 1.0 - (double)numSources / numVertices;
+        for (i = 0; i < numSources; i++) {
+            meanReachable += reachable[i];
+        }
+        meanReachable /= numSources;
+        for (i = 0; i < numSources; i++) {
+            residuals += (distanceSums[i] - stats->meanSeparation * reachable[i]) * (distanceSums[i] - stats->meanSeparation * reachable[i]);
+            reachableSpread += (reachable[i] - meanReachable) * (reachable[i] - meanReachable);
+        }
+        if (meanReachable > 0) {
+            stats->meanSeparationError = 1.96 * sqrt(residuals / (numSources - 1) / numSources * correction) / meanReachable;
+            stats->pairsRelativeError = sqrt(reachableSpread / (numSources - 1) / numSources * correction) / meanReachable;
+        }
+    }
+    stats->seconds = getWallClockTime() - startTime;
+    free(sources);
+    free(reachable);
+    free(distanceSums);
+    free(histogram);
+}
+
+/*
+    This function returns the HyperLogLog estimate of the number of distinct vertices added to a counter.
+    powers[r] must hold 2^-r.
+*/
+double estimateCounter_HyperANF(uint8_t *registers, double *powers)
+{
+    int j, zeros = 0;
+    double sum = 0, estimate;
+    double m = HYPERANF_REGISTERS;
+    double alpha = 0.7213 / (1.0 + 1.079 / m); //bias correction for 128 registers or more
+
+    for (j = 0; j < HYPERANF_REGISTERS; j++) {
+        sum += powers[registers[j]];
+        zeros += registers[j] == 0;
+    }
+    estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / zeros); //linear counting is more accurate while most registers are still empty
+    }
+    return estimate;
+}
+
+/*
+    This function estimates the distance distribution of a graph of any format with HyperANF. Round t merges the counter of
+    every friend of a vertex into the vertex's counter, so the counter then holds the vertices within distance t, and the
+    pairs at distance t are estimated as the growth of the sum of all counters. The rounds stop when no counter changes, or, if
+    budgetSeconds is more than 0, before a round that would end after the budget, judging by the slowest round so far; then
+    stats->stoppedAtBudget is set and the pairs further apart are missing. At least one round is always run.
+    stats->pairs is allocated here and has to be freed by the caller.
+*/
+void estimateDistances_HyperANF(void *graph, int numVertices, BiBFSNeighborFunction collectNeighbors, double budgetSeconds,
+                                DistanceStatistics *stats)
+{
+    int v, k, j, count, bucket, distance;
+    uint64_t hash, state;
+    bool anyChanged;
+    double total, previousTotal = 0, powers[66];
+    double startTime = getWallClockTime(), roundStart, slowestRound = 0;
+    size_t size = (size_t)(numVertices > 0 ? numVertices : 1) * HYPERANF_REGISTERS;
+    uint8_t *counters = calloc(size, 1);
+    uint8_t *nextCounters = malloc(size);
+    uint8_t *mine, *theirs;
+    double *estimates = malloc((numVertices > 0 ? numVertices : 1) * sizeof(double));
+    int *neighbors = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+
+    memset(stats, 0, sizeof(DistanceStatistics));
+    stats->pairs = calloc(numVertices > 0 ? numVertices : 1, sizeof(double));
+    if (counters == NULL || nextCounters == NULL || estimates == NULL || neighbors == NULL || stats->pairs == NULL) {
+        printf("Memory allocation for the graph statistics has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (k = 0; k < 66; k++) {
+        powers[k] = ldexp(1.0, -k);
+    }
+
+    //round 0: every counter holds its own vertex
+    for (v = 0; v < numVertices; v++) {
+        state = (uint64_t)v;
+        hash = nextRandom64(&state); //splitmix64 mixes the bits of the ID well enough to serve as the hash
+        bucket = (int)(hash >> (64 - HYPERANF_LOG2_REGISTERS));
+        hash <<= HYPERANF_LOG2_REGISTERS;
+        counters[(size_t)v * HYPERANF_REGISTERS + bucket] = hash == 0 ? 64 - HYPERANF_LOG2_REGISTERS + 1 : countLeadingZeros64(hash) + 1;
+        estimates[v] = estimateCounter_HyperANF(counters + (size_t)v * HYPERANF_REGISTERS, powers);
+        previousTotal += estimates[v];
+    }
+
+    for (distance = 1; distance < numVertices; distance++) {
+        roundStart = getWallClockTime();
+        if (budgetSeconds > 0 && distance > 1 && roundStart + slowestRound - startTime > budgetSeconds) {
+            stats->stoppedAtBudget = true;
+            break;
+        }
+        anyChanged = false;
+        total = 0;
+        for (v = 0; v < numVertices; v++) {
+            mine = nextCounters + (size_t)v * HYPERANF_REGISTERS;
+            memcpy(mine, counters + (size_t)v * HYPERANF_REGISTERS, HYPERANF_REGISTERS);
+            count = collectNeighbors(graph, v, neighbors);
+            for (k = 0; k < count; k++) {
+                theirs = counters + (size_t)neighbors[k] * HYPERANF_REGISTERS;
+                for (j = 0; j < HYPERANF_REGISTERS; j++) { //the union of two counters is their register-wise maximum
+                    mine[j] = theirs[j] > mine[j] ? theirs[j] : mine[j];
+                }
+            }
+            if (memcmp(mine, counters + (size_t)v * HYPERANF_REGISTERS, HYPERANF_REGISTERS) != 0) {
+                estimates[v] = estimateCounter_HyperANF(mine, powers); //only the counters that grew need a new estimate
+                anyChanged = true;
+            }
+            total += estimates[v];
+        }
+        if (!anyChanged) {
+            break;
+        }
+        stats->pairs[distance] = total > previousTotal ? total - previousTotal : 0;
+        previousTotal = total;
+        uint8_t *swap = counters;
+        counters = nextCounters;
+        nextCounters = swap;
+        if (getWallClockTime() - roundStart > slowestRound) {
+            slowestRound = getWallClockTime() - roundStart;
+        }
+    }
+
+    stats->method = STATS_METHOD_HYPERANF;
+    stats->numSources = HYPERANF_REGISTERS;
+    stats->pairsRelativeError = 1.04 / sqrt((double)HYPERANF_REGISTERS);
+    summarizeDistances(stats, numVertices);
+    stats->seconds = getWallClockTime() - startTime;
+    free(counters);
+    free(nextCounters);
+    free(estimates);
+    free(neighbors);
+}
+
+void printComponentStatistics(ComponentStatistics *components, int numVertices)
+{
+    printf("Connected components: %d, the largest with %d vertices (%.2f%%), %d isolated vertices. Took %.3f s.\n",
+           components->numComponents, components->largestSize, numVertices > 0 ? 100.0 * components->largestSize / numVertices : 0,
+           components->isolatedVertices, components->seconds);
+}
+
+/*
+    This function prints a distance distribution with the accuracy of the method that computed it and the time it took.
+*/
+void printDistanceStatistics(DistanceStatistics *stats, int numVertices, double budgetSeconds)
+{
+    int d;
+
+    if (stats->method == STATS_METHOD_EXACT) {
+        printf("\nExact distances, from all %d vertices:\n", stats->numSources);
+    } else if (stats->method == STATS_METHOD_SAMPLE) {
+        printf("\nSampled distances, from %d of %d vertices:\n", stats->numSources, numVertices);
+    } else {
+        printf("\nHyperANF estimate, with %d registers per counter:\n", stats->numSources);
+    }
+    printf("Distance  Pairs\n");
+    for (d = 1; d <= stats->maxDistance; d++) {
+        printf("%8d  %.0f\n", d, stats->pairs[d]);
+    }
+    printf("Connected pairs: %.0f", stats->connectedPairs);
+    if (stats->pairsRelativeError > 0) {
+        printf(" (relative standard error %.2f%%)", 100 * stats->pairsRelativeError);
+    }
+    printf("\nMean separation: %.4f", stats->meanSeparation);
+    if (stats->method == STATS_METHOD_SAMPLE) {
+        printf(" +/- %.4f (95%% confidence)", stats->meanSeparationError);
+    }
+    printf("\nEffective diameter: %.3f. Highest distance: %d%s.\n", stats->effectiveDiameter, stats->maxDistance,
+           stats->method == STATS_METHOD_EXACT ? "" : " (a lower bound)");
+    if (stats->stoppedAtBudget) {
+        printf("Stopped at the budget, so the pairs further apart than %d are missing and the numbers above are too low.\n",
+               stats->maxDistance);
+    }
+    if (budgetSeconds > 0 && stats->method != STATS_METHOD_HYPERANF) {
+        printf("Took %.3f s of a budget of %.3f s.\n", stats->seconds, budgetSeconds);
+    } else {
+        printf("Took %.3f s.\n", stats->seconds);
+    }
+}
+
+/*
+    This function computes and prints the statistics of a loaded graph of any format: its connected components, then its
+    distance distribution with the given STATS_METHOD_*. numSamples is the number of sources of STATS_METHOD_SAMPLE, and
+    budgetSeconds the time STATS_METHOD_AUTO may spend on the distances, i.e., on the multi-source BFS and, if it settles for
+    a sample, on HyperANF after it.
+*/
+void printGraphStatistics_GraphHandle(GraphHandle *handle, int method, double budgetSeconds, int numSamples)
+{
+    void *graph;
+    BiBFSNeighborFunction collectNeighbors;
+    BiBFSMatrix matrix = {handle->adjMatrix, handle->numVertices};
+    ComponentStatistics components;
+    DistanceStatistics stats;
+    int n = handle->numVertices;
+    double distanceStartTime, remainingSeconds;
+
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        graph = handle->adjList;
+        collectNeighbors = collectNeighbors_BiBFS_AdjList;
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        graph = &matrix;
+        collectNeighbors = collectNeighbors_BiBFS_AdjMatrix;
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        graph = handle->csrGraph;
+        collectNeighbors = collectNeighbors_BiBFS_CSR;
+    } else {
+        graph = handle->bitMatrix;
+        collectNeighbors = collectNeighbors_BiBFS_BitMatrix;
+    }
+
+    printf("\n\t=== GRAPH STATISTICS ===\n");
+    printf("Vertices: %d, edges: %d.\n", n, handle->numEdges);
+    countComponents(graph, n, collectNeighbors, &components);
+    printComponentStatistics(&components, n);
+
+    distanceStartTime = getWallClockTime();
+    if (method != STATS_METHOD_HYPERANF) {
+        if (method == STATS_METHOD_AUTO) {
+            measureDistances_MSBFS(graph, n, collectNeighbors, n, budgetSeconds, STATS_SAMPLE_SHARE * budgetSeconds, &stats);
+        } else if (method == STATS_METHOD_EXACT) {
+            measureDistances_MSBFS(graph, n, collectNeighbors, n, 0, 0, &stats);
+        } else {
+            measureDistances_MSBFS(graph, n, collectNeighbors, numSamples, 0, 0, &stats);
+        }
+        printDistanceStatistics(&stats, n, method == STATS_METHOD_AUTO ? budgetSeconds : 0);
+        if (method == STATS_METHOD_AUTO && stats.method == STATS_METHOD_SAMPLE) {
+            printf("Exact distances would take about %.1f s.\n", stats.seconds / stats.numSources * n);
+        }
+        free(stats.pairs);
+    }
+    if (method == STATS_METHOD_HYPERANF) {
+        estimateDistances_HyperANF(graph, n, collectNeighbors, 0, &stats);
+        printDistanceStatistics(&stats, n, 0);
+        free(stats.pairs);
+    } else if (method == STATS_METHOD_AUTO && stats.method == STATS_METHOD_SAMPLE) {
+        remainingSeconds = budgetSeconds - (getWallClockTime() - distanceStartTime);
+        estimateDistances_HyperANF(graph, n, collectNeighbors, remainingSeconds > 0 ? remainingSeconds : 1e-9, &stats);
+        printDistanceStatistics(&stats, n, 0);
+        printf("The sample and HyperANF took %.3f s of a budget of %.3f s.\n", getWallClockTime() - distanceStartTime, budgetSeconds);
+        free(stats.pairs);
+    }
+}
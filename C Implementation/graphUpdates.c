@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Incremental updates of a loaded graph: adding and removing friendships and adding people, without reloading the file.
+
+    Both directions of a friendship are added or removed together, so a verifiedSymmetric graph stays verified.
+    Adjacency lists: the first update builds an EdgeIndex over all of the lists' nodes. A friendship is then added by pushing
+    a node to the head of each list, and removed by looking its node up, copying the head of the list into it and unlinking
+    the head, so both take expected O(1) time. Removed nodes go back to the list's node pool for the next additions.
+    A new person gets the next ID; the heads array doubles when it is full, so adding people takes amortized O(1) time.
+    Adjacency matrices: a friendship is two cells, so it is added or removed in O(1). A new person needs a new row, so adding
+    one takes O(V) time; the rows are widened to double the capacity when a column no longer fits, which is amortized O(V).
+    The CSR graph and the bit matrix are packed for fast searches and are not updated in place.
+
+    Delta log: every update made from the menu is appended as one line to FILE.delta, next to the snapshot FILE.snap:
+        A ID1 ID2    add the friendship between ID1 and ID2
+        R ID1 ID2    remove it
+        V            add a person, with the next ID
+    The log holds the updates made since the snapshot was saved, so at startup it is replayed on top of the snapshot, and it is
+    emptied when a new snapshot is saved, since the snapshot then contains the updates.
+*/
+
+#define EDGE_INDEX_EMPTY UINT64_MAX
+#define EDGE_INDEX_FIRST_CAPACITY 1024
+
+#define DELTA_ADD_FRIENDSHIP 'A'
+#define DELTA_REMOVE_FRIENDSHIP 'R'
+#define DELTA_ADD_VERTEX 'V'
+
+uint64_t makeKey_EdgeIndex(int ID1, int ID2)
+{
+    return (uint64_t)(uint32_t)ID1 << 32 | (uint32_t)ID2;
+}
+
+/*
+    This function returns the slot where a key is stored or would be stored, probing linearly from its hash.
+*/
+size_t findSlot_EdgeIndex(EdgeIndex *index, uint64_t key)
+{
+    uint64_t state = key;
+    size_t slot = nextRandom64(&state) & (index->capacity - 1); //splitmix64 spreads neighboring IDs over the table
+    while (index->keys[slot] != EDGE_INDEX_EMPTY && index->keys[slot] != key) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return slot;
+}
+
+EdgeIndex* createEdgeIndex(size_t capacity)
+{
+    EdgeIndex *index = malloc(sizeof(EdgeIndex));
+    if (index != NULL) {
+        index->capacity = capacity;
+        index->count = 0;
+        index->keys = malloc(capacity * sizeof(uint64_t));
+        index->nodes = malloc(capacity * sizeof(singlyNode*));
+    }
+    if (index == NULL || index->keys == NULL || index->nodes == NULL) {
+        printf("Memory allocation for the edge index has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memset(index->keys, 0xff, capacity * sizeof(uint64_t)); //every slot EDGE_INDEX_EMPTY
+    return index;
+}
+
+/*
+    This function stores the node of a key, replacing the one stored before if there is one, and doubles the table first
+    if it would become more than half full.
+*/
+void setNode_EdgeIndex(EdgeIndex *index, uint64_t key, singlyNode *node)
+{
+    size_t i, slot;
+    if (2 * (index->count + 1) > index->capacity) {
+        EdgeIndex *larger = createEdgeIndex(index->capacity * 2);
+        for (i = 0; i < index->capacity; i++) {
+            if (index->keys[i] != EDGE_INDEX_EMPTY) {
+                slot = findSlot_EdgeIndex(larger, index->keys[i]);
+                larger->keys[slot] = index->keys[i];
+                larger->nodes[slot] = index->nodes[i];
+            }
+        }
+        free(index->keys);
+        free(index->nodes);
+        index->keys = larger->keys;
+        index->nodes = larger->nodes;
+        index->capacity = larger->capacity;
+        free(larger);
+    }
+    slot = findSlot_EdgeIndex(index, key);
+    if (index->keys[slot] == EDGE_INDEX_EMPTY) {
+        index->keys[slot] = key;
+        index->count++;
+    }
+    index->nodes[slot] = node;
+}
+
+/*
+    This function returns the node of a key, or NULL if the key is not in the table.
+*/
+singlyNode* getNode_EdgeIndex(EdgeIndex *index, uint64_t key)
+{
+    size_t slot = findSlot_EdgeIndex(index, key);
+    return index->keys[slot] == key ? index->nodes[slot] : NULL;
+}
+
+/*
+    This function removes a key from the table. The keys after it in its probe sequence are shifted back into the gap,
+    so lookups never have to skip over deleted slots.
+*/
+void removeKey_EdgeIndex(EdgeIndex *index, uint64_t key)
+{
+    size_t gap = findSlot_EdgeIndex(index, key), slot, home;
+    uint64_t state;
+    if (index->keys[gap] != key) {
+        return;
+    }
+    index->count--;
+    for (slot = (gap + 1) & (index->capacity - 1); index->keys[slot] != EDGE_INDEX_EMPTY; slot = (slot + 1) & (index->capacity - 1)) {
+        state = index->keys[slot];
+        home = nextRandom64(&state) & (index->capacity - 1);
+        if (((slot - home) & (index->capacity - 1)) >= ((slot - gap) & (index->capacity - 1))) { //the key may move back to the gap
+            index->keys[gap] = index->keys[slot];
+            index->nodes[gap] = index->nodes[slot];
+            gap = slot;
+        }
+    }
+    index->keys[gap] = EDGE_INDEX_EMPTY;
+}
+
+void freeEdgeIndex(EdgeIndex *index)
+{
+    if (index != NULL) {
+        free(index->keys);
+        free(index->nodes);
+        free(index);
+    }
+}
+
+/*
+    This function returns the edge index of an adjacency list, and builds it from every node of the lists the first time.
+    If a list holds the same friend twice, only its first node is indexed.
+*/
+EdgeIndex* getEdgeIndex_AdjList(singlyNode** adjList, int numVertices)
+{
+    int i;
+    size_t capacity = EDGE_INDEX_FIRST_CAPACITY;
+    singlyNode *temp;
+    AdjListStorage *storage = getStorage_AdjList(adjList); //check adjacencyList.c for the implementation of AdjListStorage
+
+    if (storage->edgeIndex == NULL) {
+        while ((long long)capacity < 2 * storage->pool.nodesInUse + 2) {
+            capacity *= 2;
+        }
+        storage->edgeIndex = createEdgeIndex(capacity);
+        for (i = numVertices - 1; i >= 0; i--) {
+            for (temp = adjList[i]; temp != NULL; temp = temp->nextNode) {
+                if (getNode_EdgeIndex(storage->edgeIndex, makeKey_EdgeIndex(i, temp->data)) == NULL) {
+                    setNode_EdgeIndex(storage->edgeIndex, makeKey_EdgeIndex(i, temp->data), temp);
+                }
+            }
+        }
+    }
+    return storage->edgeIndex;
+}
+
+/*
+    This function adds ID2 to the list of ID1 unless it is already there. Returns true if it was added.
+*/
+bool insertEntry_AdjList(singlyNode** adjList, EdgeIndex *index, int ID1, int ID2)
+{
+    uint64_t key = makeKey_EdgeIndex(ID1, ID2);
+    if (getNode_EdgeIndex(index, key) != NULL) {
+        return false;
+    }
+    singlyNode *node = allocateNode(getNodePool_AdjList(adjList), ID2); //check data_structures.c for the implementation of allocateNode
+    node->nextNode = adjList[ID1];
+    adjList[ID1] = node;
+    setNode_EdgeIndex(index, key, node);
+    return true;
+}
+
+/*
+    This function removes ID2 from the list of ID1 if it is there, without walking the list: the data of the head node
+    is moved into the removed node and the head is unlinked instead. Returns true if it was removed.
+*/
+bool deleteEntry_AdjList(singlyNode** adjList, EdgeIndex *index, int ID1, int ID2)
+{
+    uint64_t key = makeKey_EdgeIndex(ID1, ID2);
+    singlyNode *node = getNode_EdgeIndex(index, key);
+    singlyNode *head = adjList[ID1];
+    if (node == NULL) {
+        return false;
+    }
+    removeKey_EdgeIndex(index, key);
+    if (node != head) {
+        node->data = head->data;
+        setNode_EdgeIndex(index, makeKey_EdgeIndex(ID1, head->data), node);
+    }
+    adjList[ID1] = head->nextNode;
+    releaseNode(getNodePool_AdjList(adjList), head); //check data_structures.c for the implementation of releaseNode
+    return true;
+}
+
+/*
+    This function adds the friendship between ID1 and ID2 to an adjacency list, i.e., ID2 to the list of ID1 and ID1 to
+    the list of ID2, in expected O(1) time. numEdges counts both directions, like the first line of a .txt file.
+    Returns true if the friendship was not there before, and false if it was or the IDs are invalid.
+*/
+bool addFriendship_AdjList(singlyNode** adjList, int numVertices, int *numEdges, int ID1, int ID2)
+{
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return false;
+    }
+    EdgeIndex *index = getEdgeIndex_AdjList(adjList, numVertices);
+    int added = insertEntry_AdjList(adjList, index, ID1, ID2) + insertEntry_AdjList(adjList, index, ID2, ID1);
+    *numEdges += added;
+    return added > 0;
+}
+
+/*
+    This function removes the friendship between ID1 and ID2 from an adjacency list in expected O(1) time.
+    Returns true if the friendship was there, and false if it was not or the IDs are invalid.
+*/
+bool removeFriendship_AdjList(singlyNode** adjList, int numVertices, int *numEdges, int ID1, int ID2)
+{
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return false;
+    }
+    EdgeIndex *index = getEdgeIndex_AdjList(adjList, numVertices);
+    int removed = deleteEntry_AdjList(adjList, index, ID1, ID2) + deleteEntry_AdjList(adjList, index, ID2, ID1);
+    *numEdges -= removed;
+    return removed > 0;
+}
+
+/*
+    This function adds a person with no friends to an adjacency list, with ID *numVertices, and increments *numVertices.
+    The heads array is doubled when it is full, which can move it, so the returned pointer replaces adjList.
+*/
+singlyNode** addVertex_AdjList(singlyNode** adjList, int *numVertices)
+{
+    AdjListStorage *storage = getStorage_AdjList(adjList);
+    if (*numVertices == storage->capacity) {
+        int capacity = storage->capacity > 0 ? storage->capacity * 2 : 16;
+        storage = realloc(storage, sizeof(AdjListStorage) + (size_t)capacity * sizeof(singlyNode*));
+        if (storage == NULL) {
+            printf("Memory allocation for adjacency list has failed. Terminating program...\n");
+            exit(-1);
+        }
+        storage->capacity = capacity; //the nodes and the edge index point at nodes, not at the heads, so they stay valid
+    }
+    storage->heads[(*numVertices)++] = NULL;
+    return storage->heads;
+}
+
+/*
+    This function adds the friendship between ID1 and ID2 to an adjacency matrix by setting both of its cells.
+    Returns true if the friendship was not there before, and false if it was or the IDs are invalid.
+*/
+bool addFriendship_AdjMatrix(bool** adjMatrix, int numVertices, int *numEdges, int ID1, int ID2)
+{
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return false;
+    }
+    int added = !adjMatrix[ID1][ID2] + !adjMatrix[ID2][ID1];
+    adjMatrix[ID1][ID2] = true;
+    adjMatrix[ID2][ID1] = true;
+    *numEdges += added;
+    return added > 0;
+}
+
+/*
+    This function removes the friendship between ID1 and ID2 from an adjacency matrix by clearing both of its cells.
+    Returns true if the friendship was there, and false if it was not or the IDs are invalid.
+*/
+bool removeFriendship_AdjMatrix(bool** adjMatrix, int numVertices, int *numEdges, int ID1, int ID2)
+{
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return false;
+    }
+    int removed = adjMatrix[ID1][ID2] + adjMatrix[ID2][ID1];
+    adjMatrix[ID1][ID2] = false;
+    adjMatrix[ID2][ID1] = false;
+    *numEdges -= removed;
+    return removed > 0;
+}
+
+/*
+    This function adds a person with no friends to an adjacency matrix, with ID *numVertices, and increments *numVertices.
+    *capacity is the number of columns every row has room for, which is numVertices for a matrix that was just loaded.
+    When a new column does not fit, the rows are widened to twice the capacity, which can move them and the array of rows,
+    so the returned pointer replaces adjMatrix. freeAdjMatrix still frees it, since it only has numVertices rows.
+*/
+bool** addVertex_AdjMatrix(bool** adjMatrix, int *numVertices, int *capacity)
+{
+    int i;
+    if (*numVertices == *capacity) {
+        int newCapacity = *capacity > 0 ? *capacity * 2 : 16;
+        adjMatrix = realloc(adjMatrix, newCapacity * sizeof(bool*));
+        if (adjMatrix == NULL) {
+            printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+            exit(-1);
+        }
+        for (i = 0; i < *numVertices; i++) {
+            adjMatrix[i] = realloc(adjMatrix[i], newCapacity * sizeof(bool));
+            if (adjMatrix[i] == NULL) {
+                printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+                exit(-1);
+            }
+            memset(adjMatrix[i] + *capacity, 0, (newCapacity - *capacity) * sizeof(bool));
+        }
+        *capacity = newCapacity;
+    }
+    adjMatrix[*numVertices] = calloc(*capacity, sizeof(bool));
+    if (adjMatrix[*numVertices] == NULL) {
+        printf("Memory allocation for adjacency matrix has failed. Terminating program...\n");
+        exit(-1);
+    }
+    (*numVertices)++;
+    return adjMatrix;
+}
+
+/*
+    This function builds the path of the delta log of a social graph file, which is the file path with ".delta" added.
+*/
+void getDeltaLogPath(char *fileString, char *logPath, size_t size)
+{
+    snprintf(logPath, size, "%s.delta", fileString);
+}
+
+/*
+    This function opens the delta log at logPath for appending, creating it if needed.
+    Returns NULL if it cannot be opened.
+*/
+FILE* openDeltaLog(char *logPath)
+{
+    FILE *log = fopen(logPath, "a");
+    if (log == NULL) {
+        printf("Could not open the delta log %s. The updates will not be kept after the program exits.\n", logPath);
+    }
+    return log;
+}
+
+/*
+    This function appends one update to a delta log, and flushes it so that it is kept even if the program stops.
+    The IDs are ignored for DELTA_ADD_VERTEX.
+*/
+void writeDeltaLog(FILE *log, char operation, int ID1, int ID2)
+{
+    if (log == NULL) {
+        return;
+    }
+    if (operation == DELTA_ADD_VERTEX) {
+        fprintf(log, "%c\n", operation);
+    } else {
+        fprintf(log, "%c %d %d\n", operation, ID1, ID2);
+    }
+    fflush(log);
+}
+
+/*
+    This function applies the updates in the delta log at logPath to a graph in CSR form, e.g., one just loaded from a snapshot.
+    The graph is turned into an adjacency list, updated, and turned back, so the cost is O(V + E) plus O(1) per update.
+    Lines that cannot be read are skipped and counted.
+    Returns the updated graph, which replaces the one given, or the same graph if there is no delta log.
+*/
+CSRGraph* replayDeltaLog(CSRGraph *graph, char *logPath, int *numVertices, int *numEdges)
+{
+    char line[128], operation;
+    int ID1, ID2, applied = 0, skipped = 0;
+    FILE *log = fopen(logPath, "r");
+    if (log == NULL) {
+        return graph; //no updates since the snapshot
+    }
+
+    singlyNode **adjList = convertCSRToAdjList(graph); //check adjacencyList.c for the implementation of convertCSRToAdjList
+    freeCSRGraph(graph);
+    while (fgets(line, sizeof(line), log) != NULL) {
+        if (sscanf(line, " %c", &operation) != 1) {
+            continue; //blank line
+        }
+        if (operation == DELTA_ADD_VERTEX) {
+            adjList = addVertex_AdjList(adjList, numVertices);
+        } else if (sscanf(line, " %c %d %d", &operation, &ID1, &ID2) == 3 && operation == DELTA_ADD_FRIENDSHIP) {
+            addFriendship_AdjList(adjList, *numVertices, numEdges, ID1, ID2);
+        } else if (sscanf(line, " %c %d %d", &operation, &ID1, &ID2) == 3 && operation == DELTA_REMOVE_FRIENDSHIP) {
+            removeFriendship_AdjList(adjList, *numVertices, numEdges, ID1, ID2);
+        } else {
+            skipped++;
+            continue;
+        }
+        applied++;
+    }
+    fclose(log);
+
+    graph = convertAdjListToCSR(adjList, *numVertices); //keeps the flag of the list, since updates keep both directions in step
+    if (!graph->verifiedSymmetric) {
+        normalizeNeighbors_CSR(graph); //the CSR searches trust the neighbors, so one-way entries and duplicates are dropped
+    }
+    releaseAdjacencyList(adjList, *numVertices);
+    printf("Replayed %d updates from %s", applied, logPath);
+    if (skipped > 0) {
+        printf(", skipping %d unreadable lines", skipped);
+    }
+    printf(".\n");
+    return graph;
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Load-time validation of a social graph.
+
+    The edge files are meant to list both directions of every friendship exactly once, with no self-loops, and the formats
+    used to pay for that assumption on every call by checking the reverse direction of each edge they look at.
+    validateCSRGraph checks it once, in one pass over a graph in CSR form whose neighbors are sorted: a duplicate sits right
+    after its first copy, a self-loop is a vertex in its own neighbors, and a missing reverse edge is found with one galloping
+    search per entry. If nothing is wrong, the graph is marked verifiedSymmetric, and so is any format converted from it,
+    which lets hasEdge and the searches skip the reverse check. repairCSRGraph fixes a graph that is not, by adding the
+    missing reverse edges and dropping the duplicates and self-loops.
+*/
+
+/*
+    This function counts the duplicates, self-loops and edges without their reverse in a graph in CSR form, whose neighbors
+    must be sorted, and stores the counts in report. The graph is marked verifiedSymmetric if there are none.
+*/
+void validateCSRGraph(CSRGraph *graph, GraphValidation *report)
+{
+    int i, k, v, previous;
+
+    report->selfLoops = 0;
+    report->duplicates = 0;
+    report->missingReverse = 0;
+    report->repaired = false;
+    for (i = 0; i < graph->numVertices; i++) {
+        previous = -1;
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            v = graph->neighbors[k];
+            if (v == i) {
+                report->selfLoops++;
+            } else if (v == previous) {
+                report->duplicates++;
+            } else if (!containsNeighbor_CSR(graph->neighbors + graph->offsets[v], graph->offsets[v + 1] - graph->offsets[v], i)) {
+                report->missingReverse++; //check adjacencyCSR.c for the implementation of containsNeighbor_CSR
+            }
+            previous = v;
+        }
+    }
+    report->verifiedSymmetric = report->selfLoops == 0 && report->duplicates == 0 && report->missingReverse == 0;
+    graph->verifiedSymmetric = report->verifiedSymmetric;
+}
+
+/*
+    This function makes a graph in CSR form, whose neighbors must be sorted, symmetric: every edge whose reverse is missing
+    gets it added, and duplicates and self-loops are dropped. The graph gets new arrays, so it must not be a mapped snapshot.
+    The graph is then marked verifiedSymmetric, and so is report.
+*/
+void repairCSRGraph(CSRGraph *graph, GraphValidation *report)
+{
+    int i, k, v, previous, numEntries;
+    int numVertices = graph->numVertices;
+    int *offsets = calloc(numVertices + 1, sizeof(int));
+    int *cursor = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    if (offsets == NULL || cursor == NULL) {
+        printf("Memory allocation for the graph repair has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    //first pass: count the neighbors every vertex will have, one slot ahead for the prefix sum
+    for (i = 0; i < numVertices; i++) {
+        previous = -1;
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            v = graph->neighbors[k];
+            if (v != i && v != previous) {
+                offsets[i + 1]++;
+                if (!containsNeighbor_CSR(graph->neighbors + graph->offsets[v], graph->offsets[v + 1] - graph->offsets[v], i)) {
+                    offsets[v + 1]++; //v gets i added
+                }
+            }
+            previous = v;
+        }
+    }
+    for (i = 0; i < numVertices; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    numEntries = offsets[numVertices];
+
+    //second pass: copy the kept entries and add the missing reverse ones
+    int *neighbors = malloc((numEntries > 0 ? numEntries : 1) * sizeof(int));
+    if (neighbors == NULL) {
+        printf("Memory allocation for the graph repair has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memcpy(cursor, offsets, numVertices * sizeof(int));
+    for (i = 0; i < numVertices; i++) {
+        previous = -1;
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            v = graph->neighbors[k];
+            if (v != i && v != previous) {
+                neighbors[cursor[i]++] = v;
+                if (!containsNeighbor_CSR(graph->neighbors + graph->offsets[v], graph->offsets[v + 1] - graph->offsets[v], i)) {
+                    neighbors[cursor[v]++] = i;
+                }
+            }
+            previous = v;
+        }
+    }
+    for (i = 0; i < numVertices; i++) { //the added entries were appended, so the rows that got some are sorted again
+        qsort(neighbors + offsets[i], offsets[i + 1] - offsets[i], sizeof(int), compareIntegers);
+    }
+
+    free(cursor);
+    free(graph->offsets);
+    free(graph->neighbors);
+    graph->offsets = offsets;
+    graph->neighbors = neighbors;
+    graph->numEdges = numEntries;
+    graph->verifiedSymmetric = true;
+    report->repaired = true;
+    report->verifiedSymmetric = true;
+}
+
+/*
+    This function makes the friends of every vertex of an adjacency list unique and mutual, as normalizeNeighbors_CSR does for
+    a graph in CSR form, so the list traversals can skip the reverse check. Repeated friends and self-loops are dropped, then
+    every entry whose reverse is not listed, and their nodes go back to the node pool. The kept friends stay in list order.
+    Sets the verifiedSymmetric flag of the list and returns the number of entries removed.
+*/
+int normalizeAdjacencyList(singlyNode **adjList, int numVertices)
+{
+    int i, v, removed = 0;
+    singlyNode *temp, *previous, *next;
+    CSRGraph *sorted = convertAdjListToCSR(adjList, numVertices); //the lists with sorted neighbors, for the reverse lookups
+    int *lastListedBy = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int)); //lastListedBy[v] is the last vertex found to keep v
+    if (lastListedBy == NULL) {
+        printf("Memory allocation for the graph validation has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (i = 0; i < numVertices; i++) {
+        lastListedBy[i] = -1;
+    }
+
+    for (i = 0; i < numVertices; i++) {
+        previous = NULL;
+        for (temp = adjList[i]; temp != NULL; temp = next) {
+            next = temp->nextNode;
+            v = temp->data;
+            if (v != i && lastListedBy[v] != i
+                && containsNeighbor_CSR(sorted->neighbors + sorted->offsets[v], sorted->offsets[v + 1] - sorted->offsets[v], i)) {
+                lastListedBy[v] = i;
+                previous = temp;
+                continue;
+            }
+            if (previous == NULL) {
+                adjList[i] = next;
+            } else {
+                previous->nextNode = next;
+            }
+            releaseNode(getNodePool_AdjList(adjList), temp); //check data_structures.c for the implementation of releaseNode
+            removed++;
+        }
+    }
+    getStorage_AdjList(adjList)->verifiedSymmetric = true;
+
+    if (removed > 0) {
+        printf("Removed %d duplicate, self-loop or one-way neighbor entries.\n", removed);
+    }
+    free(lastListedBy);
+    free(sorted->offsets); //freed directly, since freeCSRGraph reports it as if the graph of the user was freed
+    free(sorted->neighbors);
+    free(sorted);
+    return removed;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file into a graph in CSR form, keeping every line of the file,
+    and validates it. The counts are stored in report, together with the number of lines skipped because of an out-of-range ID.
+    The file is parsed by numThreads threads, or one per processor if numThreads is 0 or less; fileString is its path.
+    Returns NULL if the file cannot be loaded.
+*/
+CSRGraph* loadValidatedCSRGraph(EdgeFileReader *reader, char *fileString, int numThreads, GraphValidation *report, int *numVertices, int *numEdges)
+{
+    CSRGraph *graph = loadSortedCSRGraphParallel(reader, fileString, numThreads, numVertices, numEdges); //check parallelGraphLoader.c for its implementation
+    if (graph == NULL) {
+        return NULL;
+    }
+    report->outOfRange = reader->edgesRejected;
+    validateCSRGraph(graph, report);
+    return graph;
+}
+
+/*
+    This function prints the counts of a validation report, and whether the graph is verified symmetric.
+*/
+void printGraphValidation(GraphValidation *report)
+{
+    printf("Validation: %lld self-loops, %lld duplicate edges, %lld edges without their reverse, %lld edges with an out-of-range ID.\n",
+           report->selfLoops, report->duplicates, report->missingReverse, report->outOfRange);
+    if (report->repaired) {
+        printf("The graph was repaired and is now symmetric, with no duplicates or self-loops.\n");
+    } else if (report->verifiedSymmetric) {
+        printf("The graph is symmetric, with no duplicates or self-loops.\n");
+    }
+}
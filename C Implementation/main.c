@@ -5,61 +5,435 @@
 
 #include "adjacencyMatrix.c"
 #include "adjacencyList.c"
+#include "adjacencyCSR.c"
+#include "adjacencyBitMatrix.c"
+#include "directionOptimizingBFS.c"
+#include "bidirectionalBFS.c"
+#include "parallelBFS.c"
+#include "multiSourceBFS.c"
+#include "edgeFileReader.c"
+#include "graphValidation.c"
+#include "graphSnapshot.c"
+#include "parallelGraphLoader.c"
+#include "matFileReader.c"
+#include "graphUpdates.c"
+#include "edgeStream.c"
+#include "graphHandle.c"
+#include "vertexOrdering.c"
+#include "mutualFriends.c"
+#include "triangleCounting.c"
+#include "graphStatistics.c"
+#include "batchQueries.c"
 #include "data_structures.c"
 
-int main()
+/*
+    This function prints the result of a connection search between ID1 and ID2, then frees the path.
+    If path is NULL, no connection was found.
+*/
+void printConnectionPath(int* path, int pathLength, int ID1, int ID2)
 {
-    int i, ID1, ID2, status = 0, pathLength = 0; 
+    int i;
+    if (path == NULL) {
+        printf("No connection found between ID %d and ID %d.\n", ID1, ID2);
+    } else {
+        printf("Connection found between ID %d and ID %d.\n", ID1, ID2);
+        for (i = 0; i < pathLength - 1; i++) {
+            printf("%d is friends with %d\n", path[i], path[i + 1]);
+        }
+        printf("\n");
+        free(path);
+    }
+}
+
+/*
+    This function saves the graph of the chosen format as a binary snapshot at snapshotPath.
+    The snapshot stores the graph in CSR form, so the other formats are converted first. A converted graph that is not
+    verifiedSymmetric is normalized before it is saved, since the CSR searches trust the neighbors of a loaded snapshot.
+    Returns true if the snapshot was saved.
+*/
+bool saveSnapshotOfGraph(singlyNode** adjList, bool** adjMatrix, CSRGraph* csrGraph, BitMatrix* bitMatrix, int graphChoice,
+                         int numVertices, int numEdges, char *snapshotPath, char *fileString)
+{
+    bool saved;
+    CSRGraph *savedGraph = NULL;
+
+    if (graphChoice == 1) {
+        savedGraph = convertAdjListToCSR(adjList, numVertices);
+    } else if (graphChoice == 2) {
+        savedGraph = convertAdjMatrixToCSR(adjMatrix, numVertices);
+    } else if (graphChoice == 3) {
+        savedGraph = csrGraph;
+    } else if (graphChoice == 4) {
+        savedGraph = convertBitMatrixToCSR(bitMatrix);
+    }
+    if (savedGraph != csrGraph && !savedGraph->verifiedSymmetric) {
+        normalizeNeighbors_CSR(savedGraph); //the converted neighbors are sorted, as normalizeNeighbors_CSR needs
+    }
+    saved = saveGraphSnapshot(savedGraph, numEdges, snapshotPath, fileString); //check graphSnapshot.c for the implementation of saveGraphSnapshot
+    if (savedGraph != csrGraph) {
+        freeCSRGraph(savedGraph);
+    }
+    return saved;
+}
+
+/*
+    This function runs a multi-source BFS from numSources random IDs, or from every ID if numSources is 0 or less,
+    on the graph of the chosen format, and prints the distance histogram and the average separation.
+*/
+void runDistanceStatistics(singlyNode** adjList, bool** adjMatrix, CSRGraph* csrGraph, BitMatrix* bitMatrix, int graphChoice,
+                           int numVertices, int numSources)
+{
+    int i;
+    uint64_t state = 12345;
+    double startTime;
+    MultiSourceBFSResult result;
+
+    if (numSources <= 0 || numSources > numVertices) {
+        numSources = numVertices;
+    }
+    memset(&result, 0, sizeof(MultiSourceBFSResult));
+    int *sources = malloc((numSources > 0 ? numSources : 1) * sizeof(int));
+    result.histogram = malloc((numVertices > 0 ? numVertices : 1) * sizeof(long long));
+    if (sources == NULL || result.histogram == NULL) {
+        printf("Memory allocation for the multi-source BFS has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (i = 0; i < numSources; i++) {
+        sources[i] = numSources == numVertices ? i : randomBelow(&state, numVertices);
+    }
+
+    printf("\nPerforming Multi-Source Breadth First Search from %d IDs, %d at a time...\n", numSources, MSBFS_LANES);
+    startTime = getWallClockTime();
+    if (graphChoice == 1) {
+        runMultiSourceBFS_AdjList(adjList, numVertices, sources, numSources, &result);
+    } else if (graphChoice == 2) {
+        runMultiSourceBFS_AdjMatrix(adjMatrix, numVertices, sources, numSources, &result);
+    } else if (graphChoice == 3) {
+        runMultiSourceBFS_CSR(csrGraph, sources, numSources, &result);
+    } else if (graphChoice == 4) {
+        runMultiSourceBFS_BitMatrix(bitMatrix, sources, numSources, &result);
+    }
+    printMultiSourceBFS(&result, numSources, numVertices); //check multiSourceBFS.c for the implementation of printMultiSourceBFS
+    printf("Done in %.3f s.\n", getWallClockTime() - startTime);
+    free(sources);
+    free(result.histogram);
+}
+
+char *headerChoiceNames[2] = {"no", "yes"};
+
+/*
+    This function loads the graph of the batch and statistics modes from GRAPHFILE with loadGraphHandle, using numThreads threads
+    to parse it, or, if GRAPHFILE is "-", from the edges piped into stdin, which start with the usual header line only if
+    hasHeader is true, and whose edges with an ID above maxID are skipped (check edgeStream.c).
+    Returns false if the graph cannot be loaded, or if its edges could not be read to the end, since the answers of a graph
+    missing the rest of its edges would look valid; the modes then exit with a nonzero code.
+*/
+bool loadGraphForMode(char *graphFile, bool hasHeader, int maxID, int format, int numThreads, GraphHandle *handle)
+{
+    bool loaded;
+    if (strcmp(graphFile, "-") == 0) {
+        loaded = loadStreamedGraphHandle(stdin, hasHeader, maxID, format, handle); //check graphHandle.c for the implementation of loadStreamedGraphHandle
+    } else {
+        loaded = loadGraphHandle(graphFile, format, true, numThreads, handle); //check graphHandle.c for the implementation of loadGraphHandle
+    }
+    if (loaded && handle->stoppedEarly) {
+        printf("The edges of %s could not all be read. Please fix the line at the byte above and try again.\n",
+               strcmp(graphFile, "-") == 0 ? "stdin" : graphFile);
+        freeGraphHandle(handle);
+        return false;
+    }
+    return loaded;
+}
+
+/*
+    This function runs the batch query mode, for when the program is started with arguments instead of the menu:
+        main --batch GRAPHFILE QUERYFILE OUTPUTFILE [--format list|matrix|csr|bitmatrix] [--method bfs|dfs|dobfs|bibfs|pbfs] [--threads N] [--order none|rcm|degree|bfs] [--header yes|no] [--max-id N]
+    The graph is loaded from GRAPHFILE (.txt or .mat, or its snapshot if it has an up-to-date one), and every query in QUERYFILE is answered.
+    A GRAPHFILE of "-" reads the edges from stdin instead, e.g., piped from another tool; --header no reads them without a header line,
+    and --max-id skips the edges with an ID above N (EDGE_STREAM_MAX_ID by default), which would otherwise all get memory.
+    The queries are answered by N worker threads, by default one per processor, and a .txt GRAPHFILE is parsed by as many.
+    With pbfs, the queries are answered one at a time instead, and the N threads share each search.
+    With --order, the vertices are relabeled for cache locality before the queries are answered (check vertexOrdering.c);
+    the queries and the paths written still use the IDs of GRAPHFILE. The BFS-family methods still write a shortest path, but
+    dfs may write a different path than without --order, since it follows the friends in the order of the new IDs.
+    Check batchQueries.c for the formats of QUERYFILE and OUTPUTFILE.
+    Returns the exit code of the program.
+*/
+int runBatchMode(int argc, char *argv[])
+{
+    int i, format = GRAPH_FORMAT_CSR, method = SEARCH_BFS, ordering = GRAPH_ORDER_NONE, numThreads = getNumProcessors(), hasHeader = 1, maxID = EDGE_STREAM_MAX_ID;
+    GraphHandle handle;
+    bool success;
+
+    if (argc < 5 || strcmp(argv[1], "--batch") != 0) {
+        printf("Usage: %s --batch GRAPHFILE QUERYFILE OUTPUTFILE [--format list|matrix|csr|bitmatrix] [--method bfs|dfs|dobfs|bibfs|pbfs] [--threads N] [--order none|rcm|degree|bfs] [--header yes|no] [--max-id N]\n", argv[0]);
+        return 1;
+    }
+    for (i = 5; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--format") == 0) {
+            format = findNameIndex(argv[i + 1], graphFormatNames, GRAPH_NUM_FORMATS);
+        } else if (strcmp(argv[i], "--method") == 0) {
+            method = findNameIndex(argv[i + 1], searchMethodNames, SEARCH_NUM_METHODS);
+        } else if (strcmp(argv[i], "--threads") == 0 && atoi(argv[i + 1]) > 0) {
+            numThreads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--order") == 0) {
+            ordering = findNameIndex(argv[i + 1], vertexOrderNames, GRAPH_NUM_ORDERS);
+        } else if (strcmp(argv[i], "--header") == 0) {
+            hasHeader = findNameIndex(argv[i + 1], headerChoiceNames, 2);
+        } else if (strcmp(argv[i], "--max-id") == 0 && atoi(argv[i + 1]) > 0) {
+            maxID = atoi(argv[i + 1]);
+        } else {
+            format = -1;
+        }
+    }
+    if (format == -1 || method == -1 || ordering == -1 || hasHeader == -1 || i != argc) {
+        printf("Invalid option. Usage: %s --batch GRAPHFILE QUERYFILE OUTPUTFILE [--format list|matrix|csr|bitmatrix] [--method bfs|dfs|dobfs|bibfs|pbfs] [--threads N] [--order none|rcm|degree|bfs] [--header yes|no] [--max-id N]\n", argv[0]);
+        return 1;
+    }
+
+    if (!loadGraphForMode(argv[2], hasHeader, maxID, format, numThreads, &handle)) {
+        return 1;
+    }
+    reorderGraphHandle(&handle, ordering); //check vertexOrdering.c for the implementation of reorderGraphHandle
+    if (method == SEARCH_PARALLEL_BFS) {
+        handle.numThreads = numThreads;
+        numThreads = 1;
+    }
+    success = runBatchQueries(&handle, method, numThreads, argv[3], argv[4]); //check batchQueries.c for the implementation of runBatchQueries
+    freeGraphHandle(&handle);
+    return success ? 0 : 1;
+}
+
+/*
+    This function runs the statistics mode, for when the program is started with:
+        main --stats GRAPHFILE [--format list|matrix|csr|bitmatrix] [--method auto|exact|sample|hyperanf] [--budget SECONDS] [--samples N] [--header yes|no] [--max-id N]
+    The graph is loaded from GRAPHFILE (.txt or .mat, or its snapshot if it has an up-to-date one, or stdin if it is "-", as in
+    runBatchMode), and its connected components and distance statistics are printed. auto, the default, measures the distances
+    exactly if that fits in the budget (10 s by default), and otherwise from a sample plus HyperANF. sample uses N random sources
+    (1000 by default).
+    Check graphStatistics.c for the methods.
+    Returns the exit code of the program.
+*/
+int runStatsMode(int argc, char *argv[])
+{
+    int i, format = GRAPH_FORMAT_CSR, method = STATS_METHOD_AUTO, numSamples = 1000, hasHeader = 1, maxID = EDGE_STREAM_MAX_ID;
+    double budgetSeconds = 10;
+    GraphHandle handle;
+
+    for (i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--format") == 0) {
+            format = findNameIndex(argv[i + 1], graphFormatNames, GRAPH_NUM_FORMATS);
+        } else if (strcmp(argv[i], "--method") == 0) {
+            method = findNameIndex(argv[i + 1], statsMethodNames, STATS_NUM_METHODS);
+        } else if (strcmp(argv[i], "--budget") == 0 && atof(argv[i + 1]) > 0) {
+            budgetSeconds = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--samples") == 0 && atoi(argv[i + 1]) > 0) {
+            numSamples = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--header") == 0) {
+            hasHeader = findNameIndex(argv[i + 1], headerChoiceNames, 2);
+        } else if (strcmp(argv[i], "--max-id") == 0 && atoi(argv[i + 1]) > 0) {
+            maxID = atoi(argv[i + 1]);
+        } else {
+            format = -1;
+        }
+    }
+    if (argc < 3 || format == -1 || method == -1 || hasHeader == -1 || i != argc) {
+        printf("Usage: %s --stats GRAPHFILE [--format list|matrix|csr|bitmatrix] [--method auto|exact|sample|hyperanf] [--budget SECONDS] [--samples N] [--header yes|no] [--max-id N]\n", argv[0]);
+        return 1;
+    }
+
+    if (!loadGraphForMode(argv[2], hasHeader, maxID, format, 0, &handle)) {
+        return 1;
+    }
+    printGraphStatistics_GraphHandle(&handle, method, budgetSeconds, numSamples); //check graphStatistics.c for its implementation
+    freeGraphHandle(&handle);
+    return 0;
+}
+
+/*
+    This function runs the clustering mode, for when the program is started with:
+        main --clustering GRAPHFILE [--format list|matrix|csr|bitmatrix] [--method auto|merge|bitset] [--threads N] [--output FILE] [--header yes|no] [--max-id N]
+    The graph is loaded from GRAPHFILE as in runStatsMode, its triangles are counted by N threads, by default one per processor,
+    and its global transitivity and average clustering are printed. With --output, the local clustering of every person is
+    written to FILE, one "ID degree triangles clustering" line per person.
+    Check triangleCounting.c for the methods.
+    Returns the exit code of the program.
+*/
+int runClusteringMode(int argc, char *argv[])
+{
+    int i, format = GRAPH_FORMAT_CSR, method = TRIANGLE_METHOD_AUTO, numThreads = 0, hasHeader = 1, maxID = EDGE_STREAM_MAX_ID;
+    char *outputPath = NULL;
+    bool success = true;
+    GraphHandle handle;
+    ClusteringStatistics stats;
+
+    for (i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--format") == 0) {
+            format = findNameIndex(argv[i + 1], graphFormatNames, GRAPH_NUM_FORMATS);
+        } else if (strcmp(argv[i], "--method") == 0) {
+            method = findNameIndex(argv[i + 1], triangleMethodNames, TRIANGLE_NUM_METHODS);
+        } else if (strcmp(argv[i], "--threads") == 0 && atoi(argv[i + 1]) > 0) {
+            numThreads = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--output") == 0) {
+            outputPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--header") == 0) {
+            hasHeader = findNameIndex(argv[i + 1], headerChoiceNames, 2);
+        } else if (strcmp(argv[i], "--max-id") == 0 && atoi(argv[i + 1]) > 0) {
+            maxID = atoi(argv[i + 1]);
+        } else {
+            format = -1;
+        }
+    }
+    if (argc < 3 || format == -1 || method == -1 || hasHeader == -1 || i != argc) {
+        printf("Usage: %s --clustering GRAPHFILE [--format list|matrix|csr|bitmatrix] [--method auto|merge|bitset] [--threads N] [--output FILE] [--header yes|no] [--max-id N]\n", argv[0]);
+        return 1;
+    }
+
+    if (!loadGraphForMode(argv[2], hasHeader, maxID, format, numThreads, &handle)) {
+        return 1;
+    }
+    countTriangles_GraphHandle(&handle, method, numThreads, &stats); //check triangleCounting.c for its implementation
+    printClusteringStatistics(&stats);
+    if (outputPath != NULL) {
+        success = writeLocalClustering(&stats, &handle, outputPath);
+        if (success) {
+            printf("Local clustering of every person written to %s.\n", outputPath);
+        }
+    }
+    freeClusteringStatistics(&stats);
+    freeGraphHandle(&handle);
+    return success ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    int ID1, ID2, pathLength = 0;
+    long long edgesExamined = 0, verticesVisited = 0;
     int numVertices = 0, numEdges = 0;
-    int menuChoice = 0, graphChoice = 0, searchChoice = 0;
+    int menuChoice = 0, graphChoice = 0, searchChoice = 0, numThreads = 0, numSources = 0, updateChoice = 0, matrixCapacity = 0, mutualCount = 0;
     char fileString[500]; //the file path or file name of the .txt file containing the social graph data
-    bool fileFound = false; 
+    char snapshotPath[510]; //the file path of the binary snapshot of the social graph, i.e., fileString with ".snap" added
+    char clusteringPath[500]; //the file the local clustering of every person is written to
+    char deltaLogPath[510]; //the file path of the log of the updates made since the snapshot, i.e., fileString with ".delta" added
+    FILE *deltaLog = NULL;
+    bool snapshotIsBase = false; //true once the snapshot holds the graph that the delta log starts from
+    double loadStartTime, budgetSeconds = 0;
+    bool matFile = false, parseText = false;
+    char repairChoice = 'n';
+    GraphValidation validation;
+    ClusteringStatistics clustering;
+    GraphHandle statsGraph; //a view of the loaded graph for the statistics, which work on any format
     singlyNode** adjList = NULL;
     bool** adjMatrix = NULL;
-    FILE *fp;
+    CSRGraph* csrGraph = NULL;
+    BitMatrix* bitMatrix = NULL;
+    EdgeFileReader* reader = NULL;
+    CSRGraph* preloadedGraph = NULL; //a graph already in CSR form, read from a snapshot or a .mat file, that the chosen format is built from
+
+    if (argc > 1 && strcmp(argv[1], "--stats") == 0) { //statistics mode, no menu
+        return runStatsMode(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--clustering") == 0) { //clustering mode, no menu
+        return runClusteringMode(argc, argv);
+    }
+    if (argc > 1) { //batch mode, no menu
+        return runBatchMode(argc, argv);
+    }
 
     /*
         This part of the code asks for the file path or file name of the .txt file containing the social graph data.
         It checks first if file exists, then also checks if the file is of valid format, i.e, first line contains two integers.
+        The header is only read once, by openEdgeFile, and the same reader is used to load the graph afterwards.
+        A MATLAB .mat file from the Facebook100 data set can also be given instead of a .txt file.
 
         By Aaron Barcelita.
     */ 
-    while (fileFound == false) {
+    while (reader == NULL && !matFile) {
         printf("\n\t=== LOAD GRAPH DATA===\n");
-        printf("Please indicate the ABSOLUTE file path or file name of the .txt file containing the social graph data.\n");
+        printf("Please indicate the ABSOLUTE file path or file name of the .txt or .mat file containing the social graph data.\n");
         printf("If entering the file name, please ensure that the file is in the same directory as the program.\n");
         printf("Enter the file path or file name: ");
         fgets(fileString, 500, stdin);
         fileString[strcspn(fileString, "\n")] = '\0'; //removes the newline character at the end of the string
-        fp = fopen(fileString, "r"); 
-        if (fp == NULL) { //if file does not exist
-            printf("File not found. Please try again.\n");
-        } else {
-           if (fscanf(fp, "%d %d", &numVertices, &numEdges) == 2) { //if the first line contains two integers
-                fileFound = true;
-                printf("File found and is also valid.\n");
-                fclose(fp);
+        matFile = isMatFile(fileString); //check matFileReader.c for the implementation of isMatFile
+        if (!matFile) {
+            reader = openEdgeFile(fileString); //prints why the file cannot be used, check edgeFileReader.c for its implementation
+        }
+        if (reader != NULL || matFile) {
+            printf("File found and is also valid.\n");
+        }
+    }
+
+    /*
+        If the graph was saved as a binary snapshot before and the .txt or .mat file has not changed since, the snapshot is loaded instead of parsing the file.
+        Otherwise, a .mat file is read whole into a CSR graph here, and a .txt file is read into a CSR graph and validated.
+        If the .txt file has self-loops, duplicates or edges without their reverse, the user can have them repaired, i.e., the
+        missing reverse edges are added. Otherwise, the validated CSR graph is freed and the file is parsed again straight into
+        the chosen format below. Every format's loader still drops the self-loops and duplicates, and it drops the one-way entries
+        instead of completing them, so declining keeps only the friendships listed in both directions.
+        The chosen graph format is then built from the snapshot, the .mat file or the validated graph.
+    */
+    getSnapshotPath(fileString, snapshotPath, sizeof(snapshotPath));
+    getDeltaLogPath(fileString, deltaLogPath, sizeof(deltaLogPath)); //check graphUpdates.c for the implementation of the delta log
+    loadStartTime = getWallClockTime();
+    preloadedGraph = loadGraphSnapshot(snapshotPath, fileString, &numVertices, &numEdges); //check graphSnapshot.c for the implementation of loadGraphSnapshot
+    if (preloadedGraph != NULL) {
+        printf("Snapshot found at %s, loaded in %.3f s.\n", snapshotPath, getWallClockTime() - loadStartTime);
+        preloadedGraph = replayDeltaLog(preloadedGraph, deltaLogPath, &numVertices, &numEdges); //the updates made since the snapshot was saved
+        snapshotIsBase = true;
+    } else if ((deltaLog = fopen(deltaLogPath, "r")) != NULL) {
+        fclose(deltaLog);
+        deltaLog = NULL;
+        printf("%s was not replayed, since there is no up-to-date snapshot for it to start from.\n", deltaLogPath);
+    }
+    if (preloadedGraph != NULL) {
+        //loaded from the snapshot
+    } else if (matFile) {
+        preloadedGraph = loadCSRGraphFromMatFile(fileString, &numVertices, &numEdges); //check matFileReader.c for the implementation of loadCSRGraphFromMatFile
+        if (preloadedGraph == NULL) {
+            printf("Terminating program...\n");
+            exit(-1);
+        }
+    } else {
+        parseText = true;
+        preloadedGraph = loadValidatedCSRGraph(reader, fileString, 0, &validation, &numVertices, &numEdges); //check graphValidation.c for the implementation of loadValidatedCSRGraph
+        if (preloadedGraph == NULL) {
+            printf("Terminating program...\n");
+            exit(-1);
+        }
+        printGraphValidation(&validation);
+        if (!validation.verifiedSymmetric) {
+            printf("Repair the graph, i.e., add the missing reverse edges and remove the duplicates and self-loops? [y/n]: ");
+            scanf(" %c", &repairChoice);
+            while (getchar() != '\n');
+            if (repairChoice == 'y' || repairChoice == 'Y') {
+                repairCSRGraph(preloadedGraph, &validation);
+                printGraphValidation(&validation);
             } else {
-                printf("Invalid file format. Please try again.\n");
-                fclose(fp);
+                freeCSRGraph(preloadedGraph);
+                preloadedGraph = NULL;
+                rewindEdgeFile(reader); //check edgeFileReader.c for the implementation of rewindEdgeFile
             }
         }
+    }
 
     /*
         This part of the code asks the user to choose the format of the social graph.
-        The user can choose between an adjacency list or an adjacency matrix.
+        The user can choose between an adjacency list, an adjacency matrix, a compressed sparse row (CSR) graph, or a bit-packed adjacency matrix.
         
-        The program will only proceed if the user chooses a valid option, i.e., 1 or 2.
+        The program will only proceed if the user chooses a valid option, i.e., 1 to 4.
         If the user chooses an invalid option, the program will prompt the user to choose again.
         However, if the user inputs an input type that is not a number, the program will terminate.
         
         By Aaron Barcelita.
     */
-    while (graphChoice != 1 && graphChoice != 2) {
+    while (graphChoice < 1 || graphChoice > 4) {
         printf("\n\t=== GRAPH SELECTION ===\n");
         printf("Please choose the format of the social graph.\n");
         printf("[1] Adjacency List.\n");
         printf("[2] Adjacency Matrix.\n");
+        printf("[3] Compressed Sparse Row (CSR).\n");
+        printf("[4] Bit-Packed Adjacency Matrix.\n");
         printf("Enter your choice: ");
         scanf("%d", &graphChoice);
         while (getchar() != '\n');
@@ -68,32 +442,62 @@ int main()
             case 1:
                 printf("Adjacency List selected.\n");
                 //create the adj list
-                adjList = loadAdjacencyList(fileString, &numVertices, &numEdges);
+                adjList = preloadedGraph != NULL ? convertCSRToAdjList(preloadedGraph) : loadAdjacencyListFromReader(reader, &numVertices, &numEdges);
                 printf("Adjacency List created.\n");
+                printNodePoolStats(getNodePool_AdjList(adjList), "Adjacency list nodes");
                 // printAdjList(adjList, numVertices);
                 break;
             case 2:
                 printf("Adjacency Matrix selected.\n");
                 //create the adj matrix
-                adjMatrix = loadAdjMatrix(fileString, &numVertices, &numEdges);
+                adjMatrix = preloadedGraph != NULL ? convertCSRToAdjMatrix(preloadedGraph) : loadAdjMatrixFromReader(reader, &numVertices, &numEdges);
                 printf("Adjacency Matrix created.\n");
                 // printAdjMatrix(adjMatrix, numVertices);
                 break;
+            case 3:
+                printf("Compressed Sparse Row selected.\n");
+                //create the CSR graph
+                csrGraph = preloadedGraph != NULL ? preloadedGraph : loadCSRGraphParallel(reader, fileString, 0, &numVertices, &numEdges); //no conversion needed
+                preloadedGraph = NULL;
+                printf("CSR graph created.\n");
+                // printCSRGraph(csrGraph);
+                break;
+            case 4:
+                printf("Bit-Packed Adjacency Matrix selected.\n");
+                //create the bit matrix
+                bitMatrix = preloadedGraph != NULL ? convertCSRToBitMatrix(preloadedGraph) : loadBitMatrixFromReader(reader, &numVertices, &numEdges);
+                printf("Bit matrix created.\n");
+                // printBitMatrix(bitMatrix);
+                break;
             default:
                 printf("Invalid choice. Please try again.\n");
                 break;
         }
     }
+    if (parseText) {
+        printEdgeFileStats(reader);
+    }
+    if (preloadedGraph != NULL) {
+        freeCSRGraph(preloadedGraph);
+    }
+    closeEdgeFile(reader);
+    printf("Graph ready in %.3f s.\n", getWallClockTime() - loadStartTime);
 
     /*
         This part of the code is the main menu of the program.
         User can choose between different functionalities to perform on the social graph data.
     */
-    while (menuChoice != 3) {
+    while (menuChoice != 9) {
         printf("\n\t=== MAIN MENU ===\n");
         printf("[1] Display friend list of a certain ID.\n");
         printf("[2] Find connections between two IDs.\n");
-        printf("[3] Exit.\n");
+        printf("[3] Save binary snapshot of the graph.\n");
+        printf("[4] Distances from many IDs at once (multi-source BFS).\n");
+        printf("[5] Graph statistics (components, separation, effective diameter).\n");
+        printf("[6] Update the graph (add or remove friendships, add people).\n");
+        printf("[7] Mutual friends of two IDs.\n");
+        printf("[8] Clustering coefficients (triangles, transitivity).\n");
+        printf("[9] Exit.\n");
         printf("Enter your choice: ");
         scanf("%d", &menuChoice);
         while (getchar() != '\n');
@@ -106,6 +510,10 @@ int main()
                     printFriendList_AdjList(adjList, numVertices, ID1);
                 } else if (graphChoice == 2) {
                     printFriendList_adjMatrix(adjMatrix, numVertices, ID1);
+                } else if (graphChoice == 3) {
+                    printFriendList_CSR(csrGraph, ID1);
+                } else if (graphChoice == 4) {
+                    printFriendList_BitMatrix(bitMatrix, ID1);
                 }
                 break;
 
@@ -117,68 +525,268 @@ int main()
                 printf("\nChoose a search method to be executed: \n");
                 printf("[1] Breadth First Search.\n");
                 printf("[2] Depth First Search.\n");
+                printf("[3] Direction-Optimizing Breadth First Search.\n");
+                printf("[4] Bidirectional Breadth First Search.\n");
+                printf("[5] Parallel Breadth First Search.\n");
                 printf("Enter your choice: ");
                 scanf("%d", &searchChoice);
+                if (searchChoice == 5) {
+                    printf("Enter the number of threads (0 for one per processor): ");
+                    scanf("%d", &numThreads);
+                }
                 if (graphChoice == 1) {
                     if (searchChoice == 1) {
                         printf("\nPerforming Breadth First Search on the graph (adjacency list)...\n");
                         int* path = findConnections_BFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength);
-                        if (path == NULL) {
-                            printf("No connection found between ID %d and ID %d.\n", ID1, ID2);
-                        } else {
-                            printf("Connection found between ID %d and ID %d.\n", ID1, ID2);
-                            for (i = 0; i < pathLength - 1; i++) {
-                                printf("%d is friends with %d\n", path[i], path[i + 1]);
-                            }
-                            printf("\n");
-                        } 
+                        printConnectionPath(path, pathLength, ID1, ID2);
                     } else if (searchChoice == 2) {
                         printf("\nPerforming Depth First Search on the graph (adjacency list)...\n");
-                        int* path = findConnections_DFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength);
-                        if (path == NULL) {
-                            printf("No connection found between ID %d and ID %d.\n", ID1, ID2);
-                        } else {
-                            printf("Connection found between ID %d and ID %d.\n", ID1, ID2);
-                            for (i = 0; i < pathLength - 1; i++) {
-                                printf("%d is friends with %d\n", path[i], path[i + 1]);
-                            }
-                            printf("\n");
-                        }
+                        int* path = findConnections_DFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 3) {
+                        printf("\nPerforming Direction-Optimizing Breadth First Search on the graph (adjacency list)...\n");
+                        int* path = findConnections_DOBFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength, &edgesExamined, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Edges examined: %lld\n", edgesExamined);
+                    } else if (searchChoice == 4) {
+                        printf("\nPerforming Bidirectional Breadth First Search on the graph (adjacency list)...\n");
+                        int* path = findConnections_BiBFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength, &verticesVisited, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Vertices visited: %lld\n", verticesVisited);
+                    } else if (searchChoice == 5) {
+                        printf("\nPerforming Parallel Breadth First Search on the graph (adjacency list)...\n");
+                        int* path = findConnections_ParallelBFS_AdjList(adjList, numVertices, ID1, ID2, &pathLength, numThreads, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
                     }
                 } else if (graphChoice == 2) {
                     if (searchChoice == 1) {
                         printf("\nPerforming Breadth First Search on the graph (adjacency matrix)...\n");
                         int* path = findConnections_BFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength);
-                        if (path == NULL) {
-                            printf("No connection found between ID %d and ID %d.\n", ID1, ID2);
-                        } else {
-                            printf("Connection found between ID %d and ID %d.\n", ID1, ID2);
-                            for (i = 0; i < pathLength - 1; i++) {
-                                printf("%d is friends with %d\n", path[i], path[i + 1]);
-                            }
-                            printf("\n");
-                        } 
+                        printConnectionPath(path, pathLength, ID1, ID2);
                     } else if (searchChoice == 2) {
                         printf("\nPerforming Depth First Search on the graph (adjacency matrix)...\n");
-                        int* path = findConnections_DFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength);
-                        if (path == NULL) {
-                            printf("No connection found between ID %d and ID %d.\n", ID1, ID2);
-                        } else {
-                            printf("Connection found between ID %d and ID %d.\n", ID1, ID2);
-                            for (i = 0; i < pathLength - 1; i++) {
-                                printf("%d is friends with %d\n", path[i], path[i + 1]);
-                            }
-                            printf("\n");
-                        }
+                        int* path = findConnections_DFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 3) {
+                        printf("\nPerforming Direction-Optimizing Breadth First Search on the graph (adjacency matrix)...\n");
+                        int* path = findConnections_DOBFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength, &edgesExamined, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Edges examined: %lld\n", edgesExamined);
+                    } else if (searchChoice == 4) {
+                        printf("\nPerforming Bidirectional Breadth First Search on the graph (adjacency matrix)...\n");
+                        int* path = findConnections_BiBFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength, &verticesVisited, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Vertices visited: %lld\n", verticesVisited);
+                    } else if (searchChoice == 5) {
+                        printf("\nPerforming Parallel Breadth First Search on the graph (adjacency matrix)...\n");
+                        int* path = findConnections_ParallelBFS_AdjMatrix(adjMatrix, numVertices, ID1, ID2, &pathLength, numThreads, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    }
+                } else if (graphChoice == 3) {
+                    if (searchChoice == 1) {
+                        printf("\nPerforming Breadth First Search on the graph (CSR)...\n");
+                        int* path = findConnections_BFS_CSR(csrGraph, ID1, ID2, &pathLength);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 2) {
+                        printf("\nPerforming Depth First Search on the graph (CSR)...\n");
+                        int* path = findConnections_DFS_CSR(csrGraph, ID1, ID2, &pathLength, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 3) {
+                        printf("\nPerforming Direction-Optimizing Breadth First Search on the graph (CSR)...\n");
+                        int* path = findConnections_DOBFS_CSR(csrGraph, ID1, ID2, &pathLength, &edgesExamined, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Edges examined: %lld\n", edgesExamined);
+                    } else if (searchChoice == 4) {
+                        printf("\nPerforming Bidirectional Breadth First Search on the graph (CSR)...\n");
+                        int* path = findConnections_BiBFS_CSR(csrGraph, ID1, ID2, &pathLength, &verticesVisited, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Vertices visited: %lld\n", verticesVisited);
+                    } else if (searchChoice == 5) {
+                        printf("\nPerforming Parallel Breadth First Search on the graph (CSR)...\n");
+                        int* path = findConnections_ParallelBFS_CSR(csrGraph, ID1, ID2, &pathLength, numThreads, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    }
+                } else if (graphChoice == 4) {
+                    if (searchChoice == 1) {
+                        printf("\nPerforming Breadth First Search on the graph (bit matrix)...\n");
+                        int* path = findConnections_BFS_BitMatrix(bitMatrix, ID1, ID2, &pathLength);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 2) {
+                        printf("\nPerforming Depth First Search on the graph (bit matrix)...\n");
+                        int* path = findConnections_DFS_BitMatrix(bitMatrix, ID1, ID2, &pathLength, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                    } else if (searchChoice == 3) {
+                        printf("\nPerforming Direction-Optimizing Breadth First Search on the graph (bit matrix)...\n");
+                        int* path = findConnections_DOBFS_BitMatrix(bitMatrix, ID1, ID2, &pathLength, &edgesExamined, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Edges examined: %lld\n", edgesExamined);
+                    } else if (searchChoice == 4) {
+                        printf("\nPerforming Bidirectional Breadth First Search on the graph (bit matrix)...\n");
+                        int* path = findConnections_BiBFS_BitMatrix(bitMatrix, ID1, ID2, &pathLength, &verticesVisited, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
+                        printf("Vertices visited: %lld\n", verticesVisited);
+                    } else if (searchChoice == 5) {
+                        printf("\nPerforming Parallel Breadth First Search on the graph (bit matrix)...\n");
+                        int* path = findConnections_ParallelBFS_BitMatrix(bitMatrix, ID1, ID2, &pathLength, numThreads, NULL);
+                        printConnectionPath(path, pathLength, ID1, ID2);
                     }
                 }
                 break;
 
             case 3:
+                if (graphChoice == 3 && csrGraph->mappedData != NULL) {
+                    printf("The graph was loaded from %s, which is already up to date.\n", snapshotPath);
+                    break;
+                }
+                if (saveSnapshotOfGraph(adjList, adjMatrix, csrGraph, bitMatrix, graphChoice, numVertices, numEdges, snapshotPath, fileString)) {
+                    printf("Snapshot saved to %s. It will be loaded instead of %s next time.\n", snapshotPath, fileString);
+                    if (deltaLog != NULL) { //the snapshot now holds every update, so the log starts over
+                        fclose(deltaLog);
+                        deltaLog = NULL;
+                    }
+                    remove(deltaLogPath);
+                    snapshotIsBase = true;
+                }
+                break;
+
+            case 4:
+                printf("Enter the number of IDs to measure from, picked at random (0 for every ID): ");
+                scanf("%d", &numSources);
+                runDistanceStatistics(adjList, adjMatrix, csrGraph, bitMatrix, graphChoice, numVertices, numSources);
+                break;
+
+            case 5:
+                printf("Enter the time budget in seconds for measuring the distances: ");
+                scanf("%lf", &budgetSeconds);
+                memset(&statsGraph, 0, sizeof(GraphHandle));
+                statsGraph.format = graphChoice - 1; //graphChoice follows the order of GRAPH_FORMAT_*
+                statsGraph.numVertices = numVertices;
+                statsGraph.numEdges = numEdges;
+                statsGraph.adjList = adjList;
+                statsGraph.adjMatrix = adjMatrix;
+                statsGraph.csrGraph = csrGraph;
+                statsGraph.bitMatrix = bitMatrix;
+                printGraphStatistics_GraphHandle(&statsGraph, STATS_METHOD_AUTO, budgetSeconds, 0); //check graphStatistics.c for its implementation
+                break;
+
+            case 6:
+                if (graphChoice != 1 && graphChoice != 2) {
+                    printf("Only the adjacency list and the adjacency matrix can be updated. The CSR graph and the bit matrix are packed for searching.\n");
+                    break;
+                }
+                printf("[1] Add a friendship.\n");
+                printf("[2] Remove a friendship.\n");
+                printf("[3] Add a person.\n");
+                printf("Enter your choice: ");
+                scanf("%d", &updateChoice);
+                if (updateChoice == 1 || updateChoice == 2) {
+                    printf("Enter ID 1: ");
+                    scanf("%d", &ID1);
+                    printf("Enter ID 2: ");
+                    scanf("%d", &ID2);
+                } else if (updateChoice != 3) {
+                    printf("Invalid choice.\n");
+                    break;
+                }
+
+                //the delta log is replayed on top of the snapshot, so the first update of a graph without one saves it first
+                if (!snapshotIsBase) {
+                    if (!saveSnapshotOfGraph(adjList, adjMatrix, csrGraph, bitMatrix, graphChoice, numVertices, numEdges, snapshotPath, fileString)) {
+                        printf("The updates will not be kept after the program exits.\n");
+                    } else {
+                        printf("Snapshot saved to %s as the starting point of the updates.\n", snapshotPath);
+                        remove(deltaLogPath);
+                        snapshotIsBase = true;
+                    }
+                }
+                if (deltaLog == NULL && snapshotIsBase) {
+                    deltaLog = openDeltaLog(deltaLogPath);
+                }
+
+                if (updateChoice == 3) {
+                    if (graphChoice == 1) {
+                        adjList = addVertex_AdjList(adjList, &numVertices);
+                    } else {
+                        if (matrixCapacity < numVertices) {
+                            matrixCapacity = numVertices; //a loaded matrix has exactly numVertices columns
+                        }
+                        adjMatrix = addVertex_AdjMatrix(adjMatrix, &numVertices, &matrixCapacity);
+                    }
+                    writeDeltaLog(deltaLog, DELTA_ADD_VERTEX, 0, 0);
+                    printf("Added a person with ID %d.\n", numVertices - 1);
+                } else if (updateChoice == 1 && (graphChoice == 1 ? addFriendship_AdjList(adjList, numVertices, &numEdges, ID1, ID2)
+                                                                  : addFriendship_AdjMatrix(adjMatrix, numVertices, &numEdges, ID1, ID2))) {
+                    writeDeltaLog(deltaLog, DELTA_ADD_FRIENDSHIP, ID1, ID2);
+                    printf("%d and %d are now friends.\n", ID1, ID2);
+                } else if (updateChoice == 2 && (graphChoice == 1 ? removeFriendship_AdjList(adjList, numVertices, &numEdges, ID1, ID2)
+                                                                  : removeFriendship_AdjMatrix(adjMatrix, numVertices, &numEdges, ID1, ID2))) {
+                    writeDeltaLog(deltaLog, DELTA_REMOVE_FRIENDSHIP, ID1, ID2);
+                    printf("%d and %d are no longer friends.\n", ID1, ID2);
+                } else {
+                    printf("Nothing changed: the IDs are invalid, or the friendship %s.\n", updateChoice == 1 ? "already exists" : "does not exist");
+                }
+                break;
+
+            case 7:
+                printf("Enter ID 1: ");
+                scanf("%d", &ID1);
+                printf("Enter ID 2: ");
+                scanf("%d", &ID2);
+                memset(&statsGraph, 0, sizeof(GraphHandle));
+                statsGraph.format = graphChoice - 1;
+                statsGraph.numVertices = numVertices;
+                statsGraph.adjList = adjList;
+                statsGraph.adjMatrix = adjMatrix;
+                statsGraph.csrGraph = csrGraph;
+                statsGraph.bitMatrix = bitMatrix;
+                int *common = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+                int *friends = malloc((numVertices > 0 ? 2 * numVertices : 1) * sizeof(int)); //no one has more than numVertices friends
+                if (common == NULL || friends == NULL) {
+                    printf("Memory allocation for the mutual friends has failed. Terminating program...\n");
+                    exit(-1);
+                }
+                mutualCount = findMutualFriends_GraphHandle(&statsGraph, ID1, ID2, common, friends, true); //check mutualFriends.c for its implementation
+                if (mutualCount < 0) {
+                    printf("Invalid IDs. Please enter IDs between 0 and %d.\n", numVertices - 1);
+                } else {
+                    printMutualFriends(ID1, ID2, common, mutualCount);
+                }
+                free(common);
+                free(friends);
+                break;
+
+            case 8:
+                printf("Enter the number of threads (0 for one per processor): ");
+                scanf("%d", &numThreads);
+                printf("Enter the file to write the local clustering of every person to (- to skip): ");
+                scanf("%499s", clusteringPath);
+                memset(&statsGraph, 0, sizeof(GraphHandle));
+                statsGraph.format = graphChoice - 1;
+                statsGraph.numVertices = numVertices;
+                statsGraph.adjList = adjList;
+                statsGraph.adjMatrix = adjMatrix;
+                statsGraph.csrGraph = csrGraph;
+                statsGraph.bitMatrix = bitMatrix;
+                countTriangles_GraphHandle(&statsGraph, TRIANGLE_METHOD_AUTO, numThreads, &clustering); //check triangleCounting.c for its implementation
+                printClusteringStatistics(&clustering);
+                if (strcmp(clusteringPath, "-") != 0 && writeLocalClustering(&clustering, &statsGraph, clusteringPath)) {
+                    printf("Local clustering of every person written to %s.\n", clusteringPath);
+                }
+                freeClusteringStatistics(&clustering);
+                break;
+
+            case 9:
+                if (deltaLog != NULL) {
+                    fclose(deltaLog);
+                }
                 if (graphChoice == 1) {
                     freeAdjacencyList(adjList, numVertices);
                 } else if (graphChoice == 2) {
                     freeAdjMatrix(adjMatrix, numVertices);
+                } else if (graphChoice == 3) {
+                    freeCSRGraph(csrGraph);
+                } else if (graphChoice == 4) {
+                    freeBitMatrix(bitMatrix);
                 }
                 printf("Exiting program...\n");
                 break;
@@ -186,7 +794,6 @@ int main()
             default:
                 printf("Invalid choice. Please try again.\n");
                 break;
-            }
         }
     }
-}
\ No newline at end of file
+}
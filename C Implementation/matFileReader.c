@@ -0,0 +1,737 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Loader for the MATLAB Level-5 .mat files of the Facebook100 data set in data/data.
+
+    A .mat file is a 128-byte header followed by data elements, each being an 8-byte tag (type and size) and its data.
+    Every variable is a miMATRIX element, which MATLAB usually wraps in a miCOMPRESSED element holding it as a zlib stream.
+    The friendships are in the variable "A", a sparse matrix stored in compressed sparse column (CSC) form:
+    ir holds the row of every nonzero entry, jc holds where each column starts in ir, and pr holds the values.
+    Reading the columns of CSC in order gives a graph in CSR form with sorted neighbors, so the other formats can be built from it.
+
+    The zlib streams are decompressed by the inflate functions below so that the program does not need any library to be installed.
+*/
+
+#define MAT_HEADER_SIZE 128
+#define MI_INT8 1
+#define MI_UINT8 2
+#define MI_INT16 3
+#define MI_UINT16 4
+#define MI_INT32 5
+#define MI_UINT32 6
+#define MI_SINGLE 7
+#define MI_DOUBLE 9
+#define MI_INT64 12
+#define MI_UINT64 13
+#define MI_MATRIX 14
+#define MI_COMPRESSED 15
+#define MX_SPARSE_CLASS 5
+#define MAT_FLAG_COMPLEX 0x800
+
+#define HUFFMAN_MAX_BITS 15
+#define HUFFMAN_FAST_BITS 10 //codes up to this long are decoded with a single table lookup
+
+/*
+    State of a zlib stream being decompressed.
+    Bits are read least significant first, as deflate packs them, through a 32-bit buffer refilled a byte at a time.
+*/
+typedef struct InflateStateTag {
+    const unsigned char *in;
+    size_t inLength;
+    size_t inPosition;
+    uint32_t bitBuffer;
+    int bitCount;
+    int paddingBytes; //zero bytes added to the buffer after the end of the input
+    unsigned char *out;
+    size_t outLength;
+    size_t outCapacity;
+} InflateState;
+
+/*
+    A canonical Huffman code. fast maps the next HUFFMAN_FAST_BITS bits to (symbol << 4) | code length, or 0 if the code is longer,
+    in which case it is decoded one bit at a time with count (number of codes of each length) and symbol (symbols ordered by code).
+*/
+typedef struct HuffmanTableTag {
+    uint16_t fast[1 << HUFFMAN_FAST_BITS];
+    short count[HUFFMAN_MAX_BITS + 1];
+    short symbol[288];
+} HuffmanTable;
+
+/*
+    This function tops the bit buffer up to at least 25 bits, adding zero bytes once the input runs out.
+*/
+void refillBits_Inflate(InflateState *state)
+{
+    while (state->bitCount <= 24) {
+        if (state->inPosition < state->inLength) {
+            state->bitBuffer |= (uint32_t)state->in[state->inPosition++] << state->bitCount;
+        } else {
+            state->paddingBytes++;
+        }
+        state->bitCount += 8;
+    }
+}
+
+/*
+    This function reads the next count bits of the stream, where count is at most 16.
+*/
+int getBits_Inflate(InflateState *state, int count)
+{
+    int value;
+    if (state->bitCount < count) {
+        refillBits_Inflate(state);
+    }
+    value = state->bitBuffer & ((1u << count) - 1);
+    state->bitBuffer >>= count;
+    state->bitCount -= count;
+    return value;
+}
+
+/*
+    This function returns true if the stream ran past the end of its input, i.e., some of the zero bytes added by refillBits_Inflate were used.
+*/
+bool isTruncated_Inflate(InflateState *state)
+{
+    return state->bitCount < state->paddingBytes * 8;
+}
+
+/*
+    This function makes room for count more bytes of output, doubling the output buffer when it is full.
+*/
+void reserveOutput_Inflate(InflateState *state, size_t count)
+{
+    if (state->outLength + count > state->outCapacity) {
+        while (state->outLength + count > state->outCapacity) {
+            state->outCapacity *= 2;
+        }
+        state->out = realloc(state->out, state->outCapacity);
+        if (state->out == NULL) {
+            printf("Memory allocation for decompressing the .mat file has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+}
+
+/*
+    This function builds a canonical Huffman code from the code length of each of its numSymbols symbols.
+    Returns false if the lengths describe more codes than can exist.
+*/
+bool buildHuffmanTable_Inflate(HuffmanTable *table, const short *lengths, int numSymbols)
+{
+    int len, sym, left, i, code, reversed;
+    short offsets[HUFFMAN_MAX_BITS + 1];
+    int nextCode[HUFFMAN_MAX_BITS + 1];
+
+    memset(table->count, 0, sizeof(table->count));
+    for (sym = 0; sym < numSymbols; sym++) {
+        table->count[lengths[sym]]++;
+    }
+    table->count[0] = 0;
+
+    left = 1;
+    for (len = 1; len <= HUFFMAN_MAX_BITS; len++) {
+        left = (left << 1) - table->count[len];
+        if (left < 0) {
+            return false;
+        }
+    }
+
+    offsets[1] = 0;
+    nextCode[1] = 0;
+    for (len = 1; len < HUFFMAN_MAX_BITS; len++) {
+        offsets[len + 1] = offsets[len] + table->count[len];
+        nextCode[len + 1] = (nextCode[len] + table->count[len]) << 1;
+    }
+
+    memset(table->fast, 0, sizeof(table->fast));
+    for (sym = 0; sym < numSymbols; sym++) {
+        len = lengths[sym];
+        if (len == 0) {
+            continue;
+        }
+        table->symbol[offsets[len]++] = sym;
+        code = nextCode[len]++;
+        if (len <= HUFFMAN_FAST_BITS) {
+            //codes are sent most significant bit first, so the table is indexed by the code with its bits reversed
+            reversed = 0;
+            for (i = 0; i < len; i++) {
+                reversed = (reversed << 1) | ((code >> i) & 1);
+            }
+            for (i = reversed; i < (1 << HUFFMAN_FAST_BITS); i += 1 << len) {
+                table->fast[i] = (uint16_t)((sym << 4) | len);
+            }
+        }
+    }
+    return true;
+}
+
+/*
+    This function decodes the next symbol of the stream with a Huffman code.
+    Returns the symbol, or -1 if the bits do not match any code.
+*/
+int decodeSymbol_Inflate(InflateState *state, HuffmanTable *table)
+{
+    int len, code = 0, first = 0, index = 0, count;
+    uint16_t entry;
+
+    if (state->bitCount < HUFFMAN_MAX_BITS) {
+        refillBits_Inflate(state);
+    }
+    entry = table->fast[state->bitBuffer & ((1 << HUFFMAN_FAST_BITS) - 1)];
+    if (entry != 0) {
+        state->bitBuffer >>= entry & 15;
+        state->bitCount -= entry & 15;
+        return entry >> 4;
+    }
+
+    //longer code, read it one bit at a time
+    for (len = 1; len <= HUFFMAN_MAX_BITS; len++) {
+        code |= getBits_Inflate(state, 1);
+        count = table->count[len];
+        if (code - count < first) {
+            return table->symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+/*
+    This function decodes the literals and back-references of one compressed block until its end-of-block symbol.
+    Returns false if the block is invalid.
+*/
+bool inflateCodes_Inflate(InflateState *state, HuffmanTable *literals, HuffmanTable *distances)
+{
+    static const short lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const short lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                         1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const short distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    int sym, length, distance;
+    unsigned char *from, *to;
+
+    while (true) {
+        sym = decodeSymbol_Inflate(state, literals);
+        if (sym < 0 || isTruncated_Inflate(state)) {
+            return false;
+        }
+        if (sym < 256) {
+            reserveOutput_Inflate(state, 1);
+            state->out[state->outLength++] = (unsigned char)sym;
+        } else if (sym == 256) {
+            return true;
+        } else {
+            sym -= 257;
+            if (sym >= 29) {
+                return false;
+            }
+            length = lengthBase[sym] + getBits_Inflate(state, lengthExtra[sym]);
+            sym = decodeSymbol_Inflate(state, distances);
+            if (sym < 0 || sym >= 30) {
+                return false;
+            }
+            distance = distanceBase[sym] + getBits_Inflate(state, distanceExtra[sym]);
+            if ((size_t)distance > state->outLength) {
+                return false;
+            }
+            reserveOutput_Inflate(state, length);
+            //copy one byte at a time since the source and destination can overlap
+            to = state->out + state->outLength;
+            from = to - distance;
+            state->outLength += length;
+            while (length-- > 0) {
+                *to++ = *from++;
+            }
+        }
+    }
+}
+
+/*
+    This function reads the code lengths at the start of a block with dynamic Huffman codes and builds both codes from them.
+    Returns false if they are invalid.
+*/
+bool readDynamicTables_Inflate(InflateState *state, HuffmanTable *literals, HuffmanTable *distances)
+{
+    static const short order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    short lengths[320];
+    HuffmanTable lengthCode;
+    int numLiterals, numDistances, numCodeLengths, i, sym, repeat, previous;
+
+    numLiterals = getBits_Inflate(state, 5) + 257;
+    numDistances = getBits_Inflate(state, 5) + 1;
+    numCodeLengths = getBits_Inflate(state, 4) + 4;
+    if (numLiterals > 286 || numDistances > 30) {
+        return false;
+    }
+
+    memset(lengths, 0, sizeof(lengths));
+    for (i = 0; i < numCodeLengths; i++) {
+        lengths[order[i]] = getBits_Inflate(state, 3);
+    }
+    if (!buildHuffmanTable_Inflate(&lengthCode, lengths, 19)) {
+        return false;
+    }
+
+    i = 0;
+    while (i < numLiterals + numDistances) {
+        sym = decodeSymbol_Inflate(state, &lengthCode);
+        if (sym < 0 || isTruncated_Inflate(state)) {
+            return false;
+        }
+        if (sym < 16) {
+            lengths[i++] = sym;
+            continue;
+        }
+        previous = 0;
+        if (sym == 16) {
+            if (i == 0) {
+                return false;
+            }
+            previous = lengths[i - 1];
+            repeat = 3 + getBits_Inflate(state, 2);
+        } else if (sym == 17) {
+            repeat = 3 + getBits_Inflate(state, 3);
+        } else {
+            repeat = 11 + getBits_Inflate(state, 7);
+        }
+        if (i + repeat > numLiterals + numDistances) {
+            return false;
+        }
+        while (repeat-- > 0) {
+            lengths[i++] = previous;
+        }
+    }
+    if (lengths[256] == 0) { //a block must be able to end
+        return false;
+    }
+    return buildHuffmanTable_Inflate(literals, lengths, numLiterals)
+        && buildHuffmanTable_Inflate(distances, lengths + numLiterals, numDistances);
+}
+
+/*
+    This function computes the Adler-32 checksum that ends a zlib stream.
+*/
+uint32_t computeAdler32(const unsigned char *data, size_t length)
+{
+    uint32_t a = 1, b = 0;
+    size_t i, chunk;
+    while (length > 0) {
+        chunk = length < 5552 ? length : 5552; //largest chunk whose sums cannot overflow before the modulo
+        for (i = 0; i < chunk; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += chunk;
+        length -= chunk;
+    }
+    return (b << 16) | a;
+}
+
+/*
+    This function decompresses a zlib stream of inLength bytes.
+    Returns a newly allocated buffer holding the decompressed bytes and stores its size in outLength, or returns NULL if the stream is invalid.
+*/
+unsigned char* inflateZlib(const unsigned char *in, size_t inLength, size_t *outLength)
+{
+    InflateState state;
+    HuffmanTable literals, distances;
+    short lengths[320];
+    int final, type, i, length, complement;
+    bool valid = true;
+    uint32_t adler;
+
+    if (inLength < 6 || (in[0] & 0x0f) != 8 || ((in[0] << 8) | in[1]) % 31 != 0 || (in[1] & 0x20) != 0) {
+        return NULL; //not deflate, bad header check, or needs a preset dictionary
+    }
+
+    state.in = in;
+    state.inLength = inLength;
+    state.inPosition = 2;
+    state.bitBuffer = 0;
+    state.bitCount = 0;
+    state.paddingBytes = 0;
+    state.outLength = 0;
+    state.outCapacity = inLength * 4 + 64;
+    state.out = malloc(state.outCapacity);
+    if (state.out == NULL) {
+        printf("Memory allocation for decompressing the .mat file has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    do {
+        final = getBits_Inflate(&state, 1);
+        type = getBits_Inflate(&state, 2);
+        if (type == 0) {
+            //stored block: skip to the next byte, then copy LEN bytes as they are
+            getBits_Inflate(&state, state.bitCount & 7);
+            length = getBits_Inflate(&state, 16);
+            complement = getBits_Inflate(&state, 16);
+            if (length != (~complement & 0xffff) || isTruncated_Inflate(&state)) {
+                valid = false;
+                break;
+            }
+            reserveOutput_Inflate(&state, length);
+            while (length > 0 && state.bitCount >= 8) { //bytes already in the bit buffer
+                state.out[state.outLength++] = (unsigned char)getBits_Inflate(&state, 8);
+                length--;
+            }
+            if ((size_t)length > state.inLength - state.inPosition) {
+                valid = false;
+                break;
+            }
+            memcpy(state.out + state.outLength, state.in + state.inPosition, length);
+            state.outLength += length;
+            state.inPosition += length;
+        } else if (type == 1) {
+            //fixed Huffman codes defined by the deflate format
+            for (i = 0; i < 288; i++) {
+                lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+            }
+            buildHuffmanTable_Inflate(&literals, lengths, 288);
+            for (i = 0; i < 30; i++) {
+                lengths[i] = 5;
+            }
+            buildHuffmanTable_Inflate(&distances, lengths, 30);
+            valid = inflateCodes_Inflate(&state, &literals, &distances);
+        } else if (type == 2) {
+            valid = readDynamicTables_Inflate(&state, &literals, &distances) && inflateCodes_Inflate(&state, &literals, &distances);
+        } else {
+            valid = false;
+        }
+    } while (valid && !final);
+
+    if (valid) {
+        //the Adler-32 checksum of the output follows the last block, starting at the next byte, most significant byte first
+        getBits_Inflate(&state, state.bitCount & 7);
+        adler = 0;
+        for (i = 0; i < 4; i++) {
+            adler = (adler << 8) | getBits_Inflate(&state, 8);
+        }
+        valid = !isTruncated_Inflate(&state) && adler == computeAdler32(state.out, state.outLength);
+    }
+    if (!valid) {
+        free(state.out);
+        return NULL;
+    }
+    *outLength = state.outLength;
+    return state.out;
+}
+
+/*
+    A data element of a .mat file: its type, its size in bytes, and a pointer to its data.
+*/
+typedef struct MatElementTag {
+    uint32_t type;
+    uint32_t size;
+    const unsigned char *data;
+} MatElement;
+
+/*
+    This function reads a 32-bit unsigned integer, swapping its bytes if the file was written on a machine with the other byte order.
+*/
+uint32_t readUInt32_MatFile(const unsigned char *data, bool swapBytes)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    if (swapBytes) {
+        value = (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+    }
+    return value;
+}
+
+/*
+    This function reads the data element at position, then moves position to the element after it.
+    Elements with at most 4 bytes of data use the small format, which keeps the data inside the tag.
+    Returns false if the element does not fit in the buffer.
+*/
+bool readMatElement(const unsigned char *buffer, size_t length, size_t *position, bool swapBytes, MatElement *element)
+{
+    size_t padded;
+    if (length - *position < 8) {
+        return false;
+    }
+    element->type = readUInt32_MatFile(buffer + *position, swapBytes);
+    if ((element->type >> 16) != 0) {
+        element->size = element->type >> 16;
+        element->type &= 0xffff;
+        element->data = buffer + *position + 4;
+        *position += 8;
+        return element->size <= 4;
+    }
+    element->size = readUInt32_MatFile(buffer + *position + 4, swapBytes);
+    element->data = buffer + *position + 8;
+    //data is padded to a multiple of 8 bytes, except for compressed elements
+    padded = element->type == MI_COMPRESSED ? element->size : ((size_t)element->size + 7) / 8 * 8;
+    if (length - *position - 8 < element->size) {
+        return false;
+    }
+    *position += 8 + (padded < length - *position - 8 ? padded : length - *position - 8);
+    return true;
+}
+
+/*
+    This function returns the size in bytes of one value of a numeric data type, or 0 if the type is not numeric.
+*/
+int getTypeSize_MatFile(uint32_t type)
+{
+    switch (type) {
+        case MI_INT8: case MI_UINT8: return 1;
+        case MI_INT16: case MI_UINT16: return 2;
+        case MI_INT32: case MI_UINT32: case MI_SINGLE: return 4;
+        case MI_DOUBLE: case MI_INT64: case MI_UINT64: return 8;
+        default: return 0;
+    }
+}
+
+/*
+    This function returns the value at index of a numeric data element as a double.
+    MATLAB may store an array in a smaller type than its class when the values fit, e.g., the 1.0 entries of a double matrix as uint8, so any type has to be accepted.
+*/
+double getNumber_MatFile(MatElement *element, size_t index, bool swapBytes)
+{
+    unsigned char bytes[8];
+    int size = getTypeSize_MatFile(element->type), i;
+    int16_t i16; uint16_t u16; int32_t i32; uint32_t u32; float f32; double f64; int64_t i64; uint64_t u64;
+
+    for (i = 0; i < size; i++) {
+        bytes[i] = element->data[index * size + (swapBytes ? size - 1 - i : i)];
+    }
+    switch (element->type) {
+        case MI_INT8: return (int8_t)bytes[0];
+        case MI_UINT8: return bytes[0];
+        case MI_INT16: memcpy(&i16, bytes, 2); return i16;
+        case MI_UINT16: memcpy(&u16, bytes, 2); return u16;
+        case MI_INT32: memcpy(&i32, bytes, 4); return i32;
+        case MI_UINT32: memcpy(&u32, bytes, 4); return u32;
+        case MI_SINGLE: memcpy(&f32, bytes, 4); return f32;
+        case MI_DOUBLE: memcpy(&f64, bytes, 8); return f64;
+        case MI_INT64: memcpy(&i64, bytes, 8); return (double)i64;
+        case MI_UINT64: memcpy(&u64, bytes, 8); return (double)u64;
+        default: return 0;
+    }
+}
+
+/*
+    This function reads the ir, jc and pr arrays of a square sparse matrix and builds a graph in CSR form from them,
+    with an edge from vertex i to vertex j for every nonzero A(i, j). Entries stored with a value of 0 are skipped.
+    Since the columns are read in order, the neighbors of every vertex end up sorted.
+    Returns NULL if the arrays are inconsistent.
+*/
+CSRGraph* convertSparseMatrixToCSR_MatFile(int numVertices, MatElement *ir, MatElement *jc, MatElement *pr, bool swapBytes)
+{
+    size_t numEntries, k, start, end;
+    int i, j, numEdges = 0;
+    int *cursor;
+
+    if (getTypeSize_MatFile(ir->type) == 0 || getTypeSize_MatFile(jc->type) == 0 || (pr != NULL && getTypeSize_MatFile(pr->type) == 0)
+        || jc->size / getTypeSize_MatFile(jc->type) < (size_t)numVertices + 1) {
+        return NULL;
+    }
+    numEntries = ir->size / getTypeSize_MatFile(ir->type);
+    if (getNumber_MatFile(jc, 0, swapBytes) != 0 || getNumber_MatFile(jc, numVertices, swapBytes) > numEntries
+        || (pr != NULL && pr->size / getTypeSize_MatFile(pr->type) < (size_t)getNumber_MatFile(jc, numVertices, swapBytes))) {
+        return NULL;
+    }
+
+    //first pass: count the entries of every row
+    int *rowCounts = calloc(numVertices + 1, sizeof(int));
+    if (rowCounts == NULL) {
+        printf("Memory allocation for CSR graph has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (j = 0; j < numVertices; j++) {
+        start = (size_t)getNumber_MatFile(jc, j, swapBytes);
+        end = (size_t)getNumber_MatFile(jc, j + 1, swapBytes);
+        if (end < start) {
+            free(rowCounts);
+            return NULL;
+        }
+        for (k = start; k < end; k++) {
+            i = (int)getNumber_MatFile(ir, k, swapBytes);
+            if (i < 0 || i >= numVertices) {
+                free(rowCounts);
+                return NULL;
+            }
+            if (pr == NULL || getNumber_MatFile(pr, k, swapBytes) != 0) {
+                rowCounts[i + 1]++;
+                numEdges++;
+            }
+        }
+    }
+
+    //second pass: place column j in the neighbors of every row it has an entry in
+    CSRGraph *graph = createCSRGraph(numVertices, numEdges);
+    for (i = 0; i < numVertices; i++) {
+        graph->offsets[i + 1] = graph->offsets[i] + rowCounts[i + 1];
+    }
+    cursor = rowCounts;
+    memcpy(cursor, graph->offsets, numVertices * sizeof(int));
+    for (j = 0; j < numVertices; j++) {
+        start = (size_t)getNumber_MatFile(jc, j, swapBytes);
+        end = (size_t)getNumber_MatFile(jc, j + 1, swapBytes);
+        for (k = start; k < end; k++) {
+            if (pr == NULL || getNumber_MatFile(pr, k, swapBytes) != 0) {
+                i = (int)getNumber_MatFile(ir, k, swapBytes);
+                graph->neighbors[cursor[i]++] = j;
+            }
+        }
+    }
+    free(rowCounts);
+    return graph;
+}
+
+/*
+    This function reads a miMATRIX element and, if it is a square real sparse matrix, builds a graph in CSR form from it.
+    The name of the variable is copied into name, which has room for nameSize characters.
+    Returns NULL if the variable is not a square real sparse matrix or is invalid.
+*/
+CSRGraph* readSparseMatrix_MatFile(MatElement *matrix, bool swapBytes, char *name, size_t nameSize)
+{
+    MatElement flags, dimensions, arrayName, ir, jc, pr;
+    size_t position = 0;
+    int rows, columns;
+    bool hasValues;
+
+    name[0] = '\0';
+    if (!readMatElement(matrix->data, matrix->size, &position, swapBytes, &flags) || flags.size < 8
+        || !readMatElement(matrix->data, matrix->size, &position, swapBytes, &dimensions) || dimensions.size != 8
+        || !readMatElement(matrix->data, matrix->size, &position, swapBytes, &arrayName)) {
+        return NULL;
+    }
+    snprintf(name, nameSize, "%.*s", (int)arrayName.size, (const char *)arrayName.data);
+
+    if ((readUInt32_MatFile(flags.data, swapBytes) & 0xff) != MX_SPARSE_CLASS || (readUInt32_MatFile(flags.data, swapBytes) & MAT_FLAG_COMPLEX)) {
+        return NULL;
+    }
+    rows = (int)readUInt32_MatFile(dimensions.data, swapBytes);
+    columns = (int)readUInt32_MatFile(dimensions.data + 4, swapBytes);
+    if (rows != columns || rows <= 0) {
+        return NULL;
+    }
+    if (!readMatElement(matrix->data, matrix->size, &position, swapBytes, &ir)
+        || !readMatElement(matrix->data, matrix->size, &position, swapBytes, &jc)) {
+        return NULL;
+    }
+    hasValues = readMatElement(matrix->data, matrix->size, &position, swapBytes, &pr); //logical matrices may leave out the values
+    return convertSparseMatrixToCSR_MatFile(rows, &ir, &jc, hasValues ? &pr : NULL, swapBytes);
+}
+
+/*
+    This function returns true if the file at fileString starts with the header of a MATLAB Level-5 .mat file.
+*/
+bool isMatFile(char *fileString)
+{
+    unsigned char header[MAT_HEADER_SIZE];
+    FILE *fp = fopen(fileString, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+    size_t length = fread(header, 1, MAT_HEADER_SIZE, fp);
+    fclose(fp);
+    return length == MAT_HEADER_SIZE && memcmp(header, "MATLAB 5.0 MAT-file", 19) == 0;
+}
+
+/*
+    This function loads a social graph from a MATLAB Level-5 .mat file into a graph in CSR form.
+    The graph is the sparse matrix named "A", or the first square sparse matrix if there is no "A".
+    Self-loops and one-way entries are removed by normalizeNeighbors_CSR, same as in loadCSRGraphFromReader.
+    Returns a pointer to the graph and stores its number of vertices and nonzero entries in numVertices and numEdges,
+    or returns NULL if the file cannot be read or has no such matrix.
+*/
+CSRGraph* loadCSRGraphFromMatFile(char *fileString, int *numVertices, int *numEdges)
+{
+    FILE *fp = fopen(fileString, "rb");
+    if (fp == NULL) {
+        printf("File not found.\n");
+        return NULL;
+    }
+
+    double startTime = getWallClockTime();
+    fseek(fp, 0, SEEK_END);
+    long fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *buffer = malloc(fileSize > 0 ? fileSize : 1);
+    if (buffer == NULL) {
+        printf("Memory allocation for reading the .mat file has failed. Terminating program...\n");
+        fclose(fp);
+        exit(-1);
+    }
+    size_t length = fread(buffer, 1, fileSize > 0 ? fileSize : 0, fp);
+    fclose(fp);
+
+    if (length < MAT_HEADER_SIZE || memcmp(buffer, "MATLAB 5.0 MAT-file", 19) != 0
+        || (memcmp(buffer + 126, "IM", 2) != 0 && memcmp(buffer + 126, "MI", 2) != 0)) {
+        printf("Invalid .mat file format.\n");
+        free(buffer);
+        return NULL;
+    }
+    //"IM" means the file was written with the same byte order as this machine is assumed to have, i.e., little-endian
+    uint16_t byteOrderCheck = 1;
+    bool littleEndian = *(unsigned char *)&byteOrderCheck == 1;
+    bool swapBytes = (memcmp(buffer + 126, "IM", 2) == 0) != littleEndian;
+
+    CSRGraph *graph = NULL, *candidate;
+    MatElement element, inner;
+    size_t position = MAT_HEADER_SIZE, innerPosition, decompressedLength;
+    size_t decompressedBytes = 0;
+    unsigned char *decompressed;
+    char name[64];
+
+    while (position < length && readMatElement(buffer, length, &position, swapBytes, &element)) {
+        decompressed = NULL;
+        if (element.type == MI_COMPRESSED) {
+            decompressed = inflateZlib(element.data, element.size, &decompressedLength);
+            innerPosition = 0;
+            if (decompressed == NULL) {
+                printf("Skipping a compressed variable that could not be decompressed.\n");
+                continue;
+            }
+            decompressedBytes += decompressedLength;
+            if (!readMatElement(decompressed, decompressedLength, &innerPosition, swapBytes, &inner)) {
+                free(decompressed);
+                continue;
+            }
+            element = inner;
+        }
+        if (element.type == MI_MATRIX) {
+            candidate = readSparseMatrix_MatFile(&element, swapBytes, name, sizeof(name));
+            if (candidate != NULL) {
+                if (graph == NULL) {
+                    graph = candidate;
+                } else if (strcmp(name, "A") == 0) {
+                    freeCSRGraph(graph);
+                    graph = candidate;
+                } else {
+                    freeCSRGraph(candidate);
+                }
+                if (strcmp(name, "A") == 0) {
+                    free(decompressed);
+                    break;
+                }
+            }
+        }
+        free(decompressed);
+    }
+    free(buffer);
+
+    if (graph == NULL) {
+        printf("The .mat file does not contain a square sparse matrix.\n");
+        return NULL;
+    }
+    normalizeNeighbors_CSR(graph); //the rows are already sorted, since the columns are placed in order
+    *numVertices = graph->numVertices;
+    *numEdges = graph->numEdges;
+    printf("Read %.2f MB (%.2f MB decompressed) and %d edges in %.3f s.\n",
+           length / (1024.0 * 1024.0), decompressedBytes / (1024.0 * 1024.0), graph->numEdges, getWallClockTime() - startTime);
+    return graph;
+}
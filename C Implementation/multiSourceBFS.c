@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Multi-source BFS (MS-BFS) with bit-parallel frontiers, for the distances from many sources at once, e.g., the eccentricity
+    of every student or the average separation of a whole school graph.
+
+    Up to MSBFS_LANES searches run together, one per bit of a per-vertex lane word: bit i of seen[v] is set once the search
+    from the i-th source has reached v, and bit i of visit[v] if v is in that search's current frontier. Each level scans the
+    friends of every vertex whose visit word is nonzero once, and moves visit[v] & ~seen[friend] to the friend, so one edge scan
+    serves every search that has v in its frontier. On social graphs the searches overlap after a level or two, which is where
+    the saving over running findConnections_BFS_* once per source comes from.
+    A lane word is 64 bits, or 256 bits when the program is built with AVX2 enabled (e.g., gcc -mavx2), in which case the lane
+    operations use 256-bit instructions. Sources beyond MSBFS_LANES are handled in further passes.
+    The distances are the BFS distances, so they match those of one findConnections_BFS_* search per pair exactly.
+*/
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MSBFS_LANE_WORDS 4
+#else
+#define MSBFS_LANE_WORDS 1
+#endif
+#define MSBFS_LANES (MSBFS_LANE_WORDS * 64) //sources per pass
+
+/*
+    One bit per source of a pass.
+*/
+typedef struct MSBFSLanesTag {
+    uint64_t words[MSBFS_LANE_WORDS];
+} MSBFSLanes;
+
+/*
+    This function stores visit & ~seen in discovered and returns true if it has a set bit, i.e., if some search in visit
+    reaches the vertex of seen for the first time.
+*/
+bool discoverLanes_MSBFS(const MSBFSLanes *visit, const MSBFSLanes *seen, MSBFSLanes *discovered)
+{
+#if defined(__AVX2__)
+    __m256i bits = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*)seen), _mm256_loadu_si256((const __m256i*)visit));
+    _mm256_storeu_si256((__m256i*)discovered, bits);
+    return !_mm256_testz_si256(bits, bits);
+#else
+    int w;
+    uint64_t any = 0;
+    for (w = 0; w < MSBFS_LANE_WORDS; w++) {
+        discovered->words[w] = visit->words[w] & ~seen->words[w];
+        any |= discovered->words[w];
+    }
+    return any != 0;
+#endif
+}
+
+/*
+    This function sets the bits of discovered in both a and b.
+*/
+void addLanes_MSBFS(MSBFSLanes *a, MSBFSLanes *b, const MSBFSLanes *discovered)
+{
+#if defined(__AVX2__)
+    __m256i bits = _mm256_loadu_si256((const __m256i*)discovered);
+    _mm256_storeu_si256((__m256i*)a, _mm256_or_si256(_mm256_loadu_si256((const __m256i*)a), bits));
+    _mm256_storeu_si256((__m256i*)b, _mm256_or_si256(_mm256_loadu_si256((const __m256i*)b), bits));
+#else
+    int w;
+    for (w = 0; w < MSBFS_LANE_WORDS; w++) {
+        a->words[w] |= discovered->words[w];
+        b->words[w] |= discovered->words[w];
+    }
+#endif
+}
+
+bool hasLanes_MSBFS(const MSBFSLanes *lanes)
+{
+    int w;
+    uint64_t any = 0;
+    for (w = 0; w < MSBFS_LANE_WORDS; w++) {
+        any |= lanes->words[w];
+    }
+    return any != 0;
+}
+
+/*
+    This function records that the searches whose bits are set in lanes reached vertex at the given distance.
+    firstSource is the index in sources of the source of lane 0 of the pass.
+*/
+void recordLanes_MSBFS(MSBFSLanes *lanes, int vertex, int distance, int firstSource, int numVertices, MultiSourceBFSResult *result)
+{
+    int w, lane;
+    uint64_t bits;
+    for (w = 0; w < MSBFS_LANE_WORDS; w++) {
+        bits = lanes->words[w];
+        if (result->histogram != NULL) {
+            result->histogram[distance] += countSetBits64(bits);
+        }
+        if (distance > 0) {
+            result->reachablePairs += countSetBits64(bits);
+            result->distanceSum += (long long)distance * countSetBits64(bits);
+        }
+        if (result->distances == NULL && result->eccentricities == NULL && result->sourceReachable == NULL
+            && result->sourceDistanceSums == NULL) {
+            continue;
+        }
+        while (bits != 0) {
+            lane = firstSource + w * 64 + countTrailingZeros64(bits);
+            if (result->distances != NULL) {
+                result->distances[(size_t)lane * numVertices + vertex] = distance;
+            }
+            if (result->eccentricities != NULL) {
+                result->eccentricities[lane] = distance; //levels only grow, so the last one recorded is the highest
+            }
+            if (result->sourceReachable != NULL && distance > 0) {
+                result->sourceReachable[lane]++;
+            }
+            if (result->sourceDistanceSums != NULL) {
+                result->sourceDistanceSums[lane] += distance;
+            }
+            bits &= bits - 1;
+        }
+    }
+}
+
+/*
+    This function runs a BFS from every vertex in sources on any graph format, MSBFS_LANES sources at a time, and stores in
+    result the arrays it asks for (the ones that are not NULL), together with the number of (source, vertex) pairs with
+    a path between them and the sum of their distances. A source counts as reaching itself at distance 0 in the histogram
+    and the distances, but not in the pair count or sum, so distanceSum / reachablePairs is the average separation.
+    The friends of a vertex are listed by collectNeighbors.
+    Returns false if a source is out of range.
+*/
+bool runMultiSourceBFS(void *graph, int numVertices, int *sources, int numSources, BiBFSNeighborFunction collectNeighbors,
+                       MultiSourceBFSResult *result)
+{
+    int i, k, v, first, lanesUsed, count, distance;
+    bool active;
+    MSBFSLanes discovered;
+
+    for (i = 0; i < numSources; i++) {
+        if (sources[i] < 0 || sources[i] >= numVertices) {
+            return false;
+        }
+    }
+    result->reachablePairs = 0;
+    result->distanceSum = 0;
+    if (result->distances != NULL) {
+        memset(result->distances, -1, (size_t)numSources * numVertices * sizeof(int));
+    }
+    if (result->histogram != NULL) {
+        memset(result->histogram, 0, numVertices * sizeof(long long));
+    }
+    if (result->eccentricities != NULL) {
+        memset(result->eccentricities, 0, numSources * sizeof(int));
+    }
+    if (result->sourceReachable != NULL) {
+        memset(result->sourceReachable, 0, numSources * sizeof(int));
+    }
+    if (result->sourceDistanceSums != NULL) {
+        memset(result->sourceDistanceSums, 0, numSources * sizeof(long long));
+    }
+
+    MSBFSLanes *seen = malloc((numVertices > 0 ? numVertices : 1) * sizeof(MSBFSLanes));
+    MSBFSLanes *visit = malloc((numVertices > 0 ? numVertices : 1) * sizeof(MSBFSLanes));
+    MSBFSLanes *visitNext = malloc((numVertices > 0 ? numVertices : 1) * sizeof(MSBFSLanes));
+    int *neighbors = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    if (seen == NULL || visit == NULL || visitNext == NULL || neighbors == NULL) {
+        printf("Memory allocation for the multi-source BFS has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    for (first = 0; first < numSources; first += MSBFS_LANES) {
+        lanesUsed = numSources - first < MSBFS_LANES ? numSources - first : MSBFS_LANES;
+        memset(seen, 0, numVertices * sizeof(MSBFSLanes));
+        memset(visit, 0, numVertices * sizeof(MSBFSLanes));
+        memset(visitNext, 0, numVertices * sizeof(MSBFSLanes));
+        for (i = 0; i < lanesUsed; i++) { //two sources of a pass can be the same vertex, each with its own bit
+            seen[sources[first + i]].words[i / 64] |= 1ULL << (i % 64);
+            visit[sources[first + i]].words[i / 64] |= 1ULL << (i % 64);
+        }
+        for (v = 0; v < numVertices; v++) {
+            if (hasLanes_MSBFS(&visit[v])) {
+                recordLanes_MSBFS(&visit[v], v, 0, first, numVertices, result);
+            }
+        }
+
+        active = true;
+        for (distance = 1; active; distance++) {
+            //top-down step: every vertex in some frontier hands its searches to the friends they have not reached yet
+            for (v = 0; v < numVertices; v++) {
+                if (!hasLanes_MSBFS(&visit[v])) {
+                    continue;
+                }
+                count = collectNeighbors(graph, v, neighbors);
+                for (k = 0; k < count; k++) {
+                    if (discoverLanes_MSBFS(&visit[v], &seen[neighbors[k]], &discovered)) {
+                        addLanes_MSBFS(&visitNext[neighbors[k]], &seen[neighbors[k]], &discovered);
+                    }
+                }
+            }
+            //the searches that reached a vertex in this level form the next frontier
+            active = false;
+            for (v = 0; v < numVertices; v++) {
+                visit[v] = visitNext[v];
+                if (hasLanes_MSBFS(&visit[v])) {
+                    recordLanes_MSBFS(&visit[v], v, distance, first, numVertices, result);
+                    memset(&visitNext[v], 0, sizeof(MSBFSLanes));
+                    active = true;
+                }
+            }
+        }
+    }
+
+    free(seen);
+    free(visit);
+    free(visitNext);
+    free(neighbors);
+    return true;
+}
+
+bool runMultiSourceBFS_AdjList(singlyNode** adjList, int numVertices, int *sources, int numSources, MultiSourceBFSResult *result)
+{
+    return runMultiSourceBFS(adjList, numVertices, sources, numSources, collectNeighbors_BiBFS_AdjList, result);
+}
+
+bool runMultiSourceBFS_AdjMatrix(bool** adjMatrix, int numVertices, int *sources, int numSources, MultiSourceBFSResult *result)
+{
+    BiBFSMatrix matrix = {adjMatrix, numVertices};
+    return runMultiSourceBFS(&matrix, numVertices, sources, numSources, collectNeighbors_BiBFS_AdjMatrix, result);
+}
+
+bool runMultiSourceBFS_CSR(CSRGraph *graph, int *sources, int numSources, MultiSourceBFSResult *result)
+{
+    return runMultiSourceBFS(graph, graph->numVertices, sources, numSources, collectNeighbors_BiBFS_CSR, result);
+}
+
+bool runMultiSourceBFS_BitMatrix(BitMatrix *bitMatrix, int *sources, int numSources, MultiSourceBFSResult *result)
+{
+    return runMultiSourceBFS(bitMatrix, bitMatrix->numVertices, sources, numSources, collectNeighbors_BiBFS_BitMatrix, result);
+}
+
+/*
+    This function prints the distance histogram of a multi-source BFS run with numSources sources, which must have computed
+    the histogram, and the average separation and highest eccentricity it found.
+*/
+void printMultiSourceBFS(MultiSourceBFSResult *result, int numSources, int numVertices)
+{
+    int i, diameter = 0;
+    long long unreachablePairs = (long long)numSources * numVertices - numSources - result->reachablePairs;
+
+    printf("Distance  Pairs\n");
+    for (i = 1; i < numVertices && result->histogram[i] > 0; i++) {
+        printf("%8d  %lld\n", i, result->histogram[i]);
+        diameter = i;
+    }
+    printf("Pairs with a connection: %lld, without: %lld.\n", result->reachablePairs, unreachablePairs);
+    if (result->reachablePairs > 0) {
+        printf("Average separation: %.4f. Highest eccentricity of the sources: %d.\n",
+               (double)result->distanceSum / result->reachablePairs, diameter);
+    }
+}
@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Mutual friends of two IDs, i.e., the IDs that are friends with both, on any graph format.
+
+    The sorted formats intersect the two friend lists:
+        csr     the neighbors of a verifiedSymmetric graph are already sorted, unique and mutual, so the two slices of the
+                neighbors array are intersected in place.
+        list    the two lists of mutual friends are collected into a buffer of the caller, and sorted only if they are not
+                ascending already, as the lists built from CSR form are, e.g., from a snapshot or after relabeling.
+    The intersection compares a block of one list with a block of the other all at once: each ID of the first block is
+    compared with every ID of the second by comparing the blocks, rotating the second one lane and comparing again, and the
+    block with the lower last ID is then replaced by the next one. A block is 8 IDs with AVX2 (e.g., gcc -mavx2) and 4 IDs
+    with SSE2, which every x86-64 compiler enables. The rest of the lists, and every list on other processors, are merged
+    one ID at a time by intersectSorted_Scalar, which gives the same IDs in the same order.
+    The matrix formats AND the two rows:
+        bitmatrix  64 cells per word of each row, counted with countSetBits64.
+        matrix     16 (SSE2) or 32 (AVX2) cells at a time, turned into a bit mask with one movemask instruction.
+    Passing useVector = false runs the scalar version of each, which must find the same mutual friends, e.g., to compare them.
+*/
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MUTUAL_VECTOR_NAME "avx2"
+#define MUTUAL_MATRIX_CELLS 32 //matrix cells ANDed at a time
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MUTUAL_VECTOR_NAME "sse2"
+#define MUTUAL_MATRIX_CELLS 16
+#else
+#define MUTUAL_VECTOR_NAME "scalar"
+#define MUTUAL_MATRIX_CELLS 0
+#endif
+
+/*
+    This function intersects two strictly increasing lists of IDs by merging them one ID at a time.
+    Stores the IDs in both lists in common, in increasing order, if common is not NULL.
+    Returns the number of IDs in both lists.
+*/
+int intersectSorted_Scalar(const int *a, int countA, const int *b, int countB, int *common)
+{
+    int i = 0, j = 0, count = 0;
+    while (i < countA && j < countB) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            if (common != NULL) {
+                common[count] = a[i];
+            }
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+/*
+    This function stores the IDs of block whose bits are set in mask in common, if common is not NULL.
+    Returns the number of set bits.
+*/
+int storeMatches_Mutual(const int *block, uint64_t mask, int *common)
+{
+    int count = 0;
+    if (common == NULL) {
+        return countSetBits64(mask);
+    }
+    while (mask != 0) {
+        common[count++] = block[countTrailingZeros64(mask)];
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+/*
+    This function intersects two strictly increasing lists of IDs a block at a time with SIMD instructions, and the last
+    few IDs with intersectSorted_Scalar. It finds the same IDs, in the same order, as intersectSorted_Scalar.
+    Stores the IDs in both lists in common, in increasing order, if common is not NULL.
+    Returns the number of IDs in both lists.
+*/
+int intersectSorted_Vector(const int *a, int countA, const int *b, int countB, int *common)
+{
+    int i = 0, j = 0, count = 0;
+#if defined(__AVX2__)
+    int r;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= countA && j + 8 <= countB) {
+        __m256i blockA = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i blockB = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i matches = _mm256_cmpeq_epi32(blockA, blockB);
+        for (r = 1; r < 8; r++) {
+            blockB = _mm256_permutevar8x32_epi32(blockB, rotate);
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(blockA, blockB));
+        }
+        count += storeMatches_Mutual(a + i, (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(matches)), common != NULL ? common + count : NULL);
+        //every ID of the block with the lower last ID has now been compared with every ID of the other list it could match
+        int lastA = a[i + 7], lastB = b[j + 7];
+        i += lastA <= lastB ? 8 : 0;
+        j += lastB <= lastA ? 8 : 0;
+    }
+#elif defined(__SSE2__)
+    while (i + 4 <= countA && j + 4 <= countB) {
+        __m128i blockA = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i blockB = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i matches = _mm_cmpeq_epi32(blockA, blockB);
+        blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+        blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+        blockB = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi32(blockA, blockB));
+        count += storeMatches_Mutual(a + i, (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(matches)), common != NULL ? common + count : NULL);
+        //every ID of the block with the lower last ID has now been compared with every ID of the other list it could match
+        int lastA = a[i + 3], lastB = b[j + 3];
+        i += lastA <= lastB ? 4 : 0;
+        j += lastB <= lastA ? 4 : 0;
+    }
+#endif
+    return count + intersectSorted_Scalar(a + i, countA - i, b + j, countB - j, common != NULL ? common + count : NULL);
+}
+
+/*
+    This function makes a sorted list of IDs strictly increasing by dropping repeated IDs.
+    Returns the new number of IDs.
+*/
+int removeDuplicates_Mutual(int *values, int count)
+{
+    int i, unique = 0;
+    for (i = 0; i < count; i++) {
+        if (unique == 0 || values[i] != values[unique - 1]) {
+            values[unique++] = values[i];
+        }
+    }
+    return unique;
+}
+
+/*
+    The IDs in common are friends of ID1 and ID2 in one direction, as found in their neighbors; for a graph whose neighbors
+    are not known to be mutual, this function keeps only the IDs that also list ID1 and ID2 back. Only the neighbors of the
+    kept IDs are searched, not those of ID1 and ID2, which are usually the longer ones. ID1 and ID2 themselves are dropped,
+    as hasEdge_* does for self-loops.
+    Returns the new number of IDs.
+*/
+int keepListedBack_CSR(CSRGraph *graph, int ID1, int ID2, int *common, int count)
+{
+    int i, k, degree, kept = 0;
+    for (i = 0; i < count; i++) {
+        k = common[i];
+        degree = graph->offsets[k + 1] - graph->offsets[k];
+        if (k != ID1 && k != ID2 && containsNeighbor_CSR(graph->neighbors + graph->offsets[k], degree, ID1) //check adjacencyCSR.c for the implementation of containsNeighbor_CSR
+            && containsNeighbor_CSR(graph->neighbors + graph->offsets[k], degree, ID2)) {
+            common[kept++] = k;
+        }
+    }
+    return kept;
+}
+
+/*
+    This function finds the mutual friends of ID1 and ID2 in a graph in CSR form.
+    Stores them in common, in increasing order, if common is not NULL; it needs room for as many IDs as the smaller friend list.
+    Returns the number of mutual friends, or -1 if an ID is invalid.
+*/
+int findMutualFriends_CSR(CSRGraph *graph, int ID1, int ID2, int *common, bool useVector)
+{
+    int count, countA, countB;
+    int *a, *b;
+    if (ID1 < 0 || ID1 >= graph->numVertices || ID2 < 0 || ID2 >= graph->numVertices) {
+        return -1;
+    }
+    a = graph->neighbors + graph->offsets[ID1];
+    b = graph->neighbors + graph->offsets[ID2];
+    countA = graph->offsets[ID1 + 1] - graph->offsets[ID1];
+    countB = graph->offsets[ID2 + 1] - graph->offsets[ID2];
+    if (graph->verifiedSymmetric) {
+        return useVector ? intersectSorted_Vector(a, countA, b, countB, common) : intersectSorted_Scalar(a, countA, b, countB, common);
+    }
+
+    //the neighbors can repeat and need not be mutual, so they are cleaned up in copies first
+    int *friendsA = malloc((countA > 0 ? countA : 1) * sizeof(int));
+    int *friendsB = malloc((countB > 0 ? countB : 1) * sizeof(int));
+    int *found = malloc((countA > 0 ? countA : 1) * sizeof(int));
+    if (friendsA == NULL || friendsB == NULL || found == NULL) {
+        printf("Memory allocation for the mutual friends has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memcpy(friendsA, a, countA * sizeof(int));
+    memcpy(friendsB, b, countB * sizeof(int));
+    countA = removeDuplicates_Mutual(friendsA, countA);
+    countB = removeDuplicates_Mutual(friendsB, countB);
+    count = useVector ? intersectSorted_Vector(friendsA, countA, friendsB, countB, found) : intersectSorted_Scalar(friendsA, countA, friendsB, countB, found);
+    count = keepListedBack_CSR(graph, ID1, ID2, found, count);
+    if (common != NULL) {
+        memcpy(common, found, count * sizeof(int));
+    }
+    free(friendsA);
+    free(friendsB);
+    free(found);
+    return count;
+}
+
+/*
+    This function stores the mutual friends of vertex in an adjacency list in buffer, in increasing order. Each friend is
+    collected once and only if the friendship is mutual (check bidirectionalBFS.c), and the friends are only sorted if the
+    list is not ascending already, so a list built from CSR form costs one walk.
+    Returns the number of friends.
+*/
+int collectSortedFriends_Mutual(singlyNode** adjList, int vertex, int *buffer)
+{
+    int i, count = collectNeighbors_BiBFS_AdjList(adjList, vertex, buffer);
+    for (i = 1; i < count && buffer[i - 1] < buffer[i]; i++);
+    if (i < count) {
+        qsort(buffer, count, sizeof(int), compareIntegers);
+    }
+    return count;
+}
+
+/*
+    This function finds the mutual friends of ID1 and ID2 in an adjacency list, whose friends are collected into friends first.
+    friends belongs to the caller, so nothing is allocated per search; it needs room for the friends of ID1 and of ID2 together,
+    e.g., twice the highest number of friends in the list.
+    Stores them in common, in increasing order, if common is not NULL; it needs room for as many IDs as the smaller friend list.
+    Returns the number of mutual friends, or -1 if an ID is invalid.
+*/
+int findMutualFriends_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *common, int *friends, bool useVector)
+{
+    int countA, countB;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices) {
+        return -1;
+    }
+    countA = collectSortedFriends_Mutual(adjList, ID1, friends);
+    countB = collectSortedFriends_Mutual(adjList, ID2, friends + countA);
+    return useVector ? intersectSorted_Vector(friends, countA, friends + countA, countB, common)
+                     : intersectSorted_Scalar(friends, countA, friends + countA, countB, common);
+}
+
+/*
+    This function returns a mask whose bit c is set if cell i + c is set in both rows, for the MUTUAL_MATRIX_CELLS cells from i on.
+*/
+uint64_t andRows_Mutual(const bool *rowA, const bool *rowB, int i)
+{
+#if defined(__AVX2__)
+    __m256i both = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(rowA + i)), _mm256_loadu_si256((const __m256i*)(rowB + i)));
+    return ~(uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(both, _mm256_setzero_si256())) & 0xffffffffULL;
+#elif defined(__SSE2__)
+    __m128i both = _mm_and_si128(_mm_loadu_si128((const __m128i*)(rowA + i)), _mm_loadu_si128((const __m128i*)(rowB + i)));
+    return ~(uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(both, _mm_setzero_si128())) & 0xffffULL;
+#else
+    (void)rowA;
+    (void)rowB;
+    (void)i;
+    return 0;
+#endif
+}
+
+/*
+    This function finds the mutual friends of ID1 and ID2 in an adjacency matrix. The two rows are ANDed, and only the
+    cells set in both rows have their mirrored cells checked, the same check as hasEdge_AdjMatrix.
+    Stores them in common, in increasing order, if common is not NULL; it needs room for numVertices IDs.
+    Returns the number of mutual friends, or -1 if an ID is invalid.
+*/
+int findMutualFriends_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int *common, bool useVector)
+{
+    int i = 0, k, count = 0;
+    uint64_t candidates;
+    const bool *rowA, *rowB;
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices) {
+        return -1;
+    }
+    rowA = adjMatrix[ID1];
+    rowB = adjMatrix[ID2];
+
+    for (; useVector && MUTUAL_MATRIX_CELLS > 0 && i + MUTUAL_MATRIX_CELLS <= numVertices; i += MUTUAL_MATRIX_CELLS) {
+        candidates = andRows_Mutual(rowA, rowB, i);
+        while (candidates != 0) {
+            k = i + countTrailingZeros64(candidates);
+            if (adjMatrix[k][ID1] && adjMatrix[k][ID2] && k != ID1 && k != ID2) {
+                if (common != NULL) {
+                    common[count] = k;
+                }
+                count++;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+    for (k = i; k < numVertices; k++) { //the scalar version, and the cells after the last full block
+        if (rowA[k] && rowB[k] && adjMatrix[k][ID1] && adjMatrix[k][ID2] && k != ID1 && k != ID2) {
+            if (common != NULL) {
+                common[count] = k;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+    This function finds the mutual friends of ID1 and ID2 in a bit matrix by ANDing the friend words of their rows
+    (check getFriendWord_BitMatrix) and counting the set bits. Every build does this a 64-bit word at a time.
+    Stores them in common, in increasing order, if common is not NULL; it needs room for numVertices IDs.
+    Returns the number of mutual friends, or -1 if an ID is invalid.
+*/
+int findMutualFriends_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *common)
+{
+    int w, count = 0;
+    uint64_t both;
+    if (ID1 < 0 || ID1 >= bitMatrix->numVertices || ID2 < 0 || ID2 >= bitMatrix->numVertices) {
+        return -1;
+    }
+    for (w = 0; w < bitMatrix->wordsPerRow; w++) {
+        both = getFriendWord_BitMatrix(bitMatrix, ID1, w) & getFriendWord_BitMatrix(bitMatrix, ID2, w);
+        if (both == 0) {
+            continue;
+        }
+        if (common == NULL) {
+            count += countSetBits64(both);
+        }
+        while (common != NULL && both != 0) {
+            common[count++] = w * 64 + countTrailingZeros64(both);
+            both &= both - 1;
+        }
+    }
+    return count;
+}
+
+/*
+    This function finds the mutual friends of ID1 and ID2 in a graph of any format, with the IDs of the file, which are
+    translated if the graph was reordered.
+    Stores them in common, in increasing order, if common is not NULL; it needs room for numVertices IDs.
+    friends is only used by an adjacency list, as described in findMutualFriends_AdjList, and can be NULL for the other formats.
+    Returns the number of mutual friends, or -1 if an ID is invalid.
+*/
+int findMutualFriends_GraphHandle(GraphHandle *handle, int ID1, int ID2, int *common, int *friends, bool useVector)
+{
+    int i, count;
+    if (ID1 < 0 || ID1 >= handle->numVertices || ID2 < 0 || ID2 >= handle->numVertices) {
+        return -1;
+    }
+    if (handle->oldToNew != NULL) {
+        ID1 = handle->oldToNew[ID1];
+        ID2 = handle->oldToNew[ID2];
+    }
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        count = findMutualFriends_AdjList(handle->adjList, handle->numVertices, ID1, ID2, common, friends, useVector);
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        count = findMutualFriends_AdjMatrix(handle->adjMatrix, handle->numVertices, ID1, ID2, common, useVector);
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        count = findMutualFriends_CSR(handle->csrGraph, ID1, ID2, common, useVector);
+    } else {
+        count = findMutualFriends_BitMatrix(handle->bitMatrix, ID1, ID2, common);
+    }
+    if (handle->newToOld != NULL && common != NULL) {
+        for (i = 0; i < count; i++) {
+            common[i] = handle->newToOld[common[i]];
+        }
+        qsort(common, count, sizeof(int), compareIntegers); //ascending in the new IDs is not ascending in those of the file
+    }
+    return count;
+}
+
+/*
+    This function prints the mutual friends of ID1 and ID2 found by findMutualFriends_*.
+*/
+void printMutualFriends(int ID1, int ID2, int *common, int count)
+{
+    int i;
+    printf("\n\t=== MUTUAL FRIENDS OF %d AND %d ===\n", ID1, ID2);
+    for (i = 0; i < count; i++) {
+        printf("%d\n", common[i]);
+    }
+    printf("\n%d and %d have %d mutual friends.\n", ID1, ID2, count);
+}
@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "data_structures.h"
+
+/*
+    Parallel level-synchronous BFS, for single searches on graphs large enough that one core is the bottleneck.
+
+    The search expands one whole level at a time. The vertices of the current frontier are handed out to the threads in blocks
+    of PARALLEL_BFS_BLOCK_SIZE, and each thread appends the vertices it discovers to its own local frontier buffer, so the
+    threads never write to a shared queue. A vertex is claimed by atomically setting its bit in a shared visited bitmap, and
+    only the thread whose fetch-or set the bit writes its parent, so every parent is an edge from the previous level and the
+    returned path is a shortest path, with the same length as the one from findConnections_BFS_*. When several shortest paths
+    exist, the one returned can differ from run to run, because the thread that claims a vertex first wins.
+    Between levels, every thread copies its local buffer into the shared next frontier at an offset given by the sizes of the
+    buffers of the threads before it, and the search stops after the level in which ID2 is reached.
+*/
+
+#define PARALLEL_BFS_BLOCK_SIZE 64 //frontier vertices taken at a time by a thread
+#define PARALLEL_BFS_MAX_THREADS 256
+
+/*
+    A barrier for the threads of one search. The last thread to arrive wakes the others and is told so by the return value,
+    which lets exactly one thread do the work that has to happen between two phases.
+*/
+typedef struct ParallelBFSBarrierTag {
+    pthread_mutex_t lock;
+    pthread_cond_t allArrived;
+    int numThreads;
+    int numWaiting;
+    int generation;
+} ParallelBFSBarrier;
+
+/*
+    The state shared by the threads of one search.
+*/
+typedef struct ParallelBFSTag {
+    void *graph;
+    int numVertices;
+    int numThreads;
+    BiBFSNeighborFunction collectNeighbors;
+    int target;
+    uint64_t *visitedBits; //bit v is set once v has been claimed by a thread
+    int *parentVertices;
+    int *frontier;
+    int *nextFrontier;
+    int frontierSize;
+    int nextBlock; //index of the next frontier vertex to be handed out, updated atomically
+    int *localSizes; //number of vertices in each thread's local buffer after a level
+    bool done;
+    ParallelBFSBarrier barrier;
+} ParallelBFS;
+
+/*
+    The arguments of one thread of a search. Thread 0 is the thread that called findConnections_ParallelBFS.
+*/
+typedef struct ParallelBFSThreadTag {
+    ParallelBFS *search;
+    int id;
+    pthread_t thread;
+} ParallelBFSThread;
+
+void initBarrier_ParallelBFS(ParallelBFSBarrier *barrier, int numThreads)
+{
+    pthread_mutex_init(&barrier->lock, NULL);
+    pthread_cond_init(&barrier->allArrived, NULL);
+    barrier->numThreads = numThreads;
+    barrier->numWaiting = 0;
+    barrier->generation = 0;
+}
+
+/*
+    This function waits until all the threads of the search have reached the barrier.
+    Returns true in the last thread to arrive and false in the others.
+*/
+bool waitBarrier_ParallelBFS(ParallelBFSBarrier *barrier)
+{
+    bool last = false;
+    pthread_mutex_lock(&barrier->lock);
+    int generation = barrier->generation;
+    if (++barrier->numWaiting == barrier->numThreads) {
+        barrier->numWaiting = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->allArrived);
+        last = true;
+    } else {
+        while (generation == barrier->generation) {
+            pthread_cond_wait(&barrier->allArrived, &barrier->lock);
+        }
+    }
+    pthread_mutex_unlock(&barrier->lock);
+    return last;
+}
+
+void destroyBarrier_ParallelBFS(ParallelBFSBarrier *barrier)
+{
+    pthread_mutex_destroy(&barrier->lock);
+    pthread_cond_destroy(&barrier->allArrived);
+}
+
+/*
+    This function sets bit v of the visited bitmap and returns true if it was not set before, i.e., if the calling thread
+    is the one that claims v.
+*/
+bool claimVertex_ParallelBFS(uint64_t *visitedBits, int v)
+{
+    uint64_t mask = 1ULL << (v & 63);
+    if (__atomic_load_n(&visitedBits[v >> 6], __ATOMIC_RELAXED) & mask) {
+        return false; //cheap check first, since most edges lead to vertices that are already visited
+    }
+    return (__atomic_fetch_or(&visitedBits[v >> 6], mask, __ATOMIC_RELAXED) & mask) == 0;
+}
+
+/*
+    This function is run by every thread of a search, and expands the frontier together with the others until ID2 is reached
+    or the frontier is empty.
+*/
+void* runThread_ParallelBFS(void *argument)
+{
+    ParallelBFSThread *self = argument;
+    ParallelBFS *search = self->search;
+    int i, k, start, end, u, count, offset, total;
+    int localSize, localCapacity = PARALLEL_BFS_BLOCK_SIZE;
+    int *local = malloc(localCapacity * sizeof(int));
+    int *neighbors = malloc(search->numVertices * sizeof(int));
+    if (local == NULL || neighbors == NULL) {
+        printf("Memory allocation for the parallel BFS has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    while (true) {
+        //expand blocks of the current frontier into the local buffer
+        localSize = 0;
+        while ((start = __atomic_fetch_add(&search->nextBlock, PARALLEL_BFS_BLOCK_SIZE, __ATOMIC_RELAXED)) < search->frontierSize) {
+            end = start + PARALLEL_BFS_BLOCK_SIZE < search->frontierSize ? start + PARALLEL_BFS_BLOCK_SIZE : search->frontierSize;
+            for (i = start; i < end; i++) {
+                u = search->frontier[i];
+                count = search->collectNeighbors(search->graph, u, neighbors);
+                for (k = 0; k < count; k++) {
+                    if (claimVertex_ParallelBFS(search->visitedBits, neighbors[k])) {
+                        search->parentVertices[neighbors[k]] = u;
+                        if (localSize == localCapacity) {
+                            localCapacity *= 2;
+                            local = realloc(local, localCapacity * sizeof(int));
+                            if (local == NULL) {
+                                printf("Memory allocation for the parallel BFS has failed. Terminating program...\n");
+                                exit(-1);
+                            }
+                        }
+                        local[localSize++] = neighbors[k];
+                    }
+                }
+            }
+        }
+        search->localSizes[self->id] = localSize;
+        waitBarrier_ParallelBFS(&search->barrier);
+
+        //merge the local buffers into the next frontier, each thread copying its own
+        offset = 0;
+        total = 0;
+        for (i = 0; i < search->numThreads; i++) {
+            if (i < self->id) {
+                offset += search->localSizes[i];
+            }
+            total += search->localSizes[i];
+        }
+        memcpy(search->nextFrontier + offset, local, localSize * sizeof(int));
+
+        if (waitBarrier_ParallelBFS(&search->barrier)) {
+            int *swap = search->frontier;
+            search->frontier = search->nextFrontier;
+            search->nextFrontier = swap;
+            search->frontierSize = total;
+            search->nextBlock = 0;
+            search->done = total == 0 || search->parentVertices[search->target] != -1;
+        }
+        waitBarrier_ParallelBFS(&search->barrier);
+        if (search->done) {
+            break;
+        }
+    }
+
+    free(local);
+    free(neighbors);
+    return NULL;
+}
+
+/*
+    This function runs a parallel level-synchronous BFS between ID1 and ID2 on any graph format, with numThreads threads,
+    or one per processor if numThreads is 0 or less. The friends of a vertex are listed by collectNeighbors, which must be
+    safe to call from several threads at once. The shared arrays of the search come from scratch, made by createSearchScratch
+    for SEARCH_PARALLEL_BFS; if scratch is NULL, they are allocated for this search alone. The threads and their own buffers
+    are still made for every search.
+    Returns an array of integers that represents a shortest path between the two IDs if a connection is found, and NULL otherwise.
+*/
+int* findConnections_ParallelBFS(void *graph, int numVertices, int ID1, int ID2, int *pathLength, int numThreads,
+                                 BiBFSNeighborFunction collectNeighbors, SearchScratch *scratch)
+{
+    if (ID1 < 0 || ID1 >= numVertices || ID2 < 0 || ID2 >= numVertices || ID1 == ID2) {
+        return NULL;
+    }
+    if (numThreads <= 0) {
+        numThreads = getNumProcessors();
+    }
+    if (numThreads > PARALLEL_BFS_MAX_THREADS) {
+        numThreads = PARALLEL_BFS_MAX_THREADS;
+    }
+
+    int i;
+    int *path = NULL;
+    ParallelBFS search;
+    ParallelBFSThread *threads = malloc(numThreads * sizeof(ParallelBFSThread));
+    SearchScratch *ownScratch = NULL;
+
+    if (scratch == NULL) {
+        scratch = ownScratch = createSearchScratch(numVertices, SEARCH_PARALLEL_BFS); //check data_structures.c for the implementation of createSearchScratch
+    }
+
+    search.graph = graph;
+    search.numVertices = numVertices;
+    search.numThreads = numThreads;
+    search.collectNeighbors = collectNeighbors;
+    search.target = ID2;
+    search.visitedBits = scratch->visitedBits;
+    search.parentVertices = scratch->parentVertices[0]; //only read for claimed vertices and ID2, so only those are set
+    search.frontier = scratch->frontier[0];
+    search.nextFrontier = scratch->nextFrontier;
+    search.localSizes = malloc(numThreads * sizeof(int));
+    if (threads == NULL || search.localSizes == NULL) {
+        printf("Memory allocation for the parallel BFS has failed. Terminating program...\n");
+        exit(-1);
+    }
+    memset(search.visitedBits, 0, (((size_t)numVertices + 63) / 64) * sizeof(uint64_t));
+    search.parentVertices[ID1] = -1;
+    search.parentVertices[ID2] = -1;
+    search.visitedBits[ID1 >> 6] |= 1ULL << (ID1 & 63);
+    search.frontier[0] = ID1;
+    search.frontierSize = 1;
+    search.nextBlock = 0;
+    search.done = false;
+    initBarrier_ParallelBFS(&search.barrier, numThreads);
+
+    for (i = 0; i < numThreads; i++) {
+        threads[i].search = &search;
+        threads[i].id = i;
+        if (i > 0 && pthread_create(&threads[i].thread, NULL, runThread_ParallelBFS, &threads[i]) != 0) {
+            printf("Creating a thread for the parallel BFS has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    runThread_ParallelBFS(&threads[0]); //the calling thread takes part in the search as thread 0
+    for (i = 1; i < numThreads; i++) {
+        pthread_join(threads[i].thread, NULL);
+    }
+
+    if (search.parentVertices[ID2] != -1) {
+        path = reconstructPath(search.parentVertices, ID2, pathLength);
+    }
+
+    destroyBarrier_ParallelBFS(&search.barrier);
+    free(threads);
+    free(search.localSizes);
+    freeSearchScratch(ownScratch);
+    return path;
+}
+
+int* findConnections_ParallelBFS_AdjList(singlyNode** adjList, int numVertices, int ID1, int ID2, int *pathLength, int numThreads, SearchScratch *scratch)
+{
+    return findConnections_ParallelBFS(adjList, numVertices, ID1, ID2, pathLength, numThreads, collectNeighbors_BiBFS_AdjList, scratch);
+}
+
+int* findConnections_ParallelBFS_AdjMatrix(bool** adjMatrix, int numVertices, int ID1, int ID2, int *pathLength, int numThreads, SearchScratch *scratch)
+{
+    BiBFSMatrix matrix = {adjMatrix, numVertices};
+    return findConnections_ParallelBFS(&matrix, numVertices, ID1, ID2, pathLength, numThreads, collectNeighbors_BiBFS_AdjMatrix, scratch);
+}
+
+int* findConnections_ParallelBFS_CSR(CSRGraph *graph, int ID1, int ID2, int *pathLength, int numThreads, SearchScratch *scratch)
+{
+    return findConnections_ParallelBFS(graph, graph->numVertices, ID1, ID2, pathLength, numThreads, collectNeighbors_BiBFS_CSR, scratch);
+}
+
+int* findConnections_ParallelBFS_BitMatrix(BitMatrix *bitMatrix, int ID1, int ID2, int *pathLength, int numThreads, SearchScratch *scratch)
+{
+    return findConnections_ParallelBFS(bitMatrix, bitMatrix->numVertices, ID1, ID2, pathLength, numThreads, collectNeighbors_BiBFS_BitMatrix, scratch);
+}
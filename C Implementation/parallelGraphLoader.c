@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "data_structures.h"
+
+/*
+    Parallel construction of a graph in CSR form from a social graph .txt file, for the large Facebook100 graphs where parsing
+    the text is most of the load time.
+
+    The file is mapped into memory (check mapFile_Snapshot in graphSnapshot.c) and the edges after the header are split into
+    one byte range per thread, each moved forward to the start of a line, so every line is parsed by exactly one thread.
+    Each thread parses its range with its own EdgeFileReader over the mapped bytes, so the numbers are read exactly as by
+    loadSortedCSRGraphFromReader. The graph is then built in four phases, each run by all the threads at once:
+        count    every thread counts the edges of each vertex in its range, in its own counts array, so no counter is shared.
+        offsets  every thread takes a block of vertices and turns their counts into the degree of each vertex and, for each
+                 thread, the position of its first edge of that vertex among the vertex's neighbors. A prefix sum of the
+                 degrees, done by the calling thread, gives the offsets.
+        scatter  every thread parses its range again and writes each edge into the next free slot of its part of the
+                 neighbors of the vertex, so the threads never write to the same slot.
+        sort     every thread sorts the neighbors of its block of vertices.
+    The result is the same graph as loadSortedCSRGraphFromReader builds, with every line of the file kept.
+    If the file cannot be mapped, the graph is loaded by loadSortedCSRGraphFromReader instead. So is a file in which a range
+    stops early, at a token that is not a number or at an odd number of IDs: readEdge ends the whole file there, which one
+    thread cannot tell the threads of the later ranges, and such a file is not worth a second way of stopping.
+*/
+
+#define PARALLEL_LOADER_MAX_THREADS 256
+#define PARALLEL_LOADER_MIN_BYTES (1 << 16) //the smallest part of the file worth a thread of its own
+
+#define PARALLEL_LOADER_COUNT 0
+#define PARALLEL_LOADER_OFFSETS 1
+#define PARALLEL_LOADER_SCATTER 2
+#define PARALLEL_LOADER_SORT 3
+
+/*
+    The state shared by the threads of one load.
+*/
+typedef struct ParallelLoaderTag {
+    char *data; //the mapped file
+    int numVertices;
+    int numThreads;
+    int **counts; //counts[t][v] is the number of edges of v in the range of thread t, and after the offsets phase the index of its first one among the neighbors of v
+    CSRGraph *graph;
+} ParallelLoader;
+
+/*
+    The arguments of one thread of a load. Thread 0 is the thread that called loadSortedCSRGraphParallel.
+*/
+typedef struct ParallelLoaderThreadTag {
+    ParallelLoader *loader;
+    int id;
+    int phase;
+    size_t start; //first byte of the range of the file, at the start of a line
+    size_t end; //one past the last byte of the range
+    int firstVertex; //block of vertices of the offsets and sort phases
+    int lastVertex;
+    long long edgesRead;
+    long long edgesRejected;
+    bool stoppedEarly; //the range has a token that is not a number, or an ID without its pair
+    pthread_t thread;
+} ParallelLoaderThread;
+
+/*
+    This function sets up reader to parse the range of the file of a thread, as if it were the only block of a file.
+*/
+void openRange_ParallelLoader(ParallelLoaderThread *thread, EdgeFileReader *reader)
+{
+    memset(reader, 0, sizeof(EdgeFileReader));
+    reader->fp = NULL; //nothing to refill from, so the reader stops at the end of the range
+    reader->buffer = thread->loader->data + thread->start;
+    reader->length = thread->end - thread->start;
+    reader->numVertices = thread->loader->numVertices;
+}
+
+/*
+    This function runs the current phase of the load for one thread.
+*/
+void* runThread_ParallelLoader(void *argument)
+{
+    ParallelLoaderThread *thread = argument;
+    ParallelLoader *loader = thread->loader;
+    CSRGraph *graph = loader->graph;
+    int *counts = loader->counts[thread->id];
+    int t, v, ID1, ID2, degree, count;
+    EdgeFileReader reader;
+
+    if (thread->phase == PARALLEL_LOADER_COUNT) {
+        openRange_ParallelLoader(thread, &reader);
+        while (readEdge(&reader, &ID1, &ID2)) {
+            counts[ID1]++;
+        }
+        thread->edgesRead = reader.edgesRead;
+        thread->edgesRejected = reader.edgesRejected;
+        thread->stoppedEarly = reader.stoppedEarly;
+    } else if (thread->phase == PARALLEL_LOADER_OFFSETS) {
+        for (v = thread->firstVertex; v < thread->lastVertex; v++) {
+            degree = 0;
+            for (t = 0; t < loader->numThreads; t++) {
+                count = loader->counts[t][v];
+                loader->counts[t][v] = degree; //the edges of v from the earlier ranges come first, as in the file
+                degree += count;
+            }
+            graph->offsets[v + 1] = degree;
+        }
+    } else if (thread->phase == PARALLEL_LOADER_SCATTER) {
+        openRange_ParallelLoader(thread, &reader);
+        while (readEdge(&reader, &ID1, &ID2)) {
+            graph->neighbors[graph->offsets[ID1] + counts[ID1]++] = ID2;
+        }
+    } else {
+        for (v = thread->firstVertex; v < thread->lastVertex; v++) {
+            qsort(graph->neighbors + graph->offsets[v], graph->offsets[v + 1] - graph->offsets[v], sizeof(int), compareIntegers);
+        }
+    }
+    return NULL;
+}
+
+/*
+    This function runs one phase of the load on every thread, with the calling thread as thread 0, and waits for all of them.
+*/
+void runPhase_ParallelLoader(ParallelLoaderThread *threads, int numThreads, int phase)
+{
+    int i;
+    for (i = 0; i < numThreads; i++) {
+        threads[i].phase = phase;
+        if (i > 0 && pthread_create(&threads[i].thread, NULL, runThread_ParallelLoader, &threads[i]) != 0) {
+            printf("Creating a thread for the parallel loader has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    runThread_ParallelLoader(&threads[0]);
+    for (i = 1; i < numThreads; i++) {
+        pthread_join(threads[i].thread, NULL);
+    }
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file into a graph in CSR form using numThreads threads,
+    or one per processor if numThreads is 0 or less. fileString must be the path that reader was opened from.
+    Every line of the file is kept and each vertex's neighbors are sorted, as in loadSortedCSRGraphFromReader, and the counts
+    of reader are updated as if it had read the edges itself, so printEdgeFileStats and the validation report still work.
+    Returns NULL if the file cannot be loaded.
+*/
+CSRGraph* loadSortedCSRGraphParallel(EdgeFileReader *reader, char *fileString, int numThreads, int *numVertices, int *numEdges)
+{
+    int i;
+    size_t size = 0, headerEnd, boundary;
+    long offset = ftell(reader->fp);
+    ParallelLoader loader;
+    ParallelLoaderThread *threads;
+    char *data = mapFile_Snapshot(fileString, &size); //check graphSnapshot.c for the implementation of mapFile_Snapshot
+
+    if (data == NULL || offset < 0) {
+        if (data != NULL) {
+            unmapGraphSnapshot(data, size);
+        }
+        return loadSortedCSRGraphFromReader(reader, numVertices, numEdges); //check adjacencyCSR.c for its implementation
+    }
+    headerEnd = (size_t)offset - (reader->length - reader->position); //the reader has read the header and nothing else
+    if (numThreads <= 0) {
+        numThreads = getNumProcessors();
+    }
+    if ((size - headerEnd) / PARALLEL_LOADER_MIN_BYTES < (size_t)numThreads) {
+        numThreads = (int)((size - headerEnd) / PARALLEL_LOADER_MIN_BYTES);
+    }
+    if (numThreads > PARALLEL_LOADER_MAX_THREADS) {
+        numThreads = PARALLEL_LOADER_MAX_THREADS;
+    }
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+
+    *numVertices = reader->numVertices;
+    *numEdges = reader->numEdges;
+    loader.data = data;
+    loader.numVertices = *numVertices;
+    loader.numThreads = numThreads;
+    loader.graph = createCSRGraph(*numVertices, 0); //check adjacencyCSR.c for the implementation of createCSRGraph
+    loader.counts = malloc(numThreads * sizeof(int*));
+    threads = malloc(numThreads * sizeof(ParallelLoaderThread));
+    if (loader.counts == NULL || threads == NULL) {
+        printf("Memory allocation for the parallel loader has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    //split the edges into ranges of about the same size, each starting at a line
+    boundary = headerEnd;
+    for (i = 0; i < numThreads; i++) {
+        loader.counts[i] = calloc(*numVertices, sizeof(int));
+        if (loader.counts[i] == NULL) {
+            printf("Memory allocation for the parallel loader has failed. Terminating program...\n");
+            exit(-1);
+        }
+        threads[i].loader = &loader;
+        threads[i].id = i;
+        threads[i].start = boundary;
+        if (i == numThreads - 1) {
+            boundary = size;
+        } else if (boundary < headerEnd + (size - headerEnd) / numThreads * (i + 1)) {
+            boundary = headerEnd + (size - headerEnd) / numThreads * (i + 1);
+        }
+        while (boundary < size && data[boundary - 1] != '\n') {
+            boundary++;
+        }
+        threads[i].end = boundary;
+        threads[i].firstVertex = (int)((long long)*numVertices * i / numThreads);
+        threads[i].lastVertex = (int)((long long)*numVertices * (i + 1) / numThreads);
+    }
+
+    runPhase_ParallelLoader(threads, numThreads, PARALLEL_LOADER_COUNT);
+    for (i = 0; i < numThreads && !threads[i].stoppedEarly; i++);
+    if (i < numThreads) { //the reader has still only read the header, so it can load the file from the first edge
+        for (i = 0; i < numThreads; i++) {
+            free(loader.counts[i]);
+        }
+        free(loader.counts);
+        free(threads);
+        free(loader.graph->offsets);
+        free(loader.graph->neighbors);
+        free(loader.graph);
+        unmapGraphSnapshot(data, size);
+        return loadSortedCSRGraphFromReader(reader, numVertices, numEdges);
+    }
+    runPhase_ParallelLoader(threads, numThreads, PARALLEL_LOADER_OFFSETS);
+    for (i = 0; i < *numVertices; i++) {
+        loader.graph->offsets[i + 1] += loader.graph->offsets[i];
+    }
+    loader.graph->numEdges = loader.graph->offsets[*numVertices];
+    free(loader.graph->neighbors);
+    loader.graph->neighbors = malloc((loader.graph->numEdges > 0 ? loader.graph->numEdges : 1) * sizeof(int));
+    if (loader.graph->neighbors == NULL) {
+        printf("Memory allocation for CSR neighbors has failed. Terminating program...\n");
+        exit(-1);
+    }
+    runPhase_ParallelLoader(threads, numThreads, PARALLEL_LOADER_SCATTER);
+    runPhase_ParallelLoader(threads, numThreads, PARALLEL_LOADER_SORT);
+
+    //the file was parsed twice, once to count and once to scatter, the same as by loadSortedCSRGraphFromReader, whose second
+    //pass reads the whole file from its first byte again
+    reader->bytesRead = (long long)size;
+    reader->edgesRead = 0;
+    reader->edgesRejected = 0;
+    reader->passes++;
+    for (i = 0; i < numThreads; i++) {
+        reader->edgesRead += threads[i].edgesRead;
+        reader->edgesRejected += threads[i].edgesRejected;
+        free(loader.counts[i]);
+    }
+    free(loader.counts);
+    free(threads);
+    unmapGraphSnapshot(data, size); //check graphSnapshot.c for the implementation of unmapGraphSnapshot
+    return loader.graph;
+}
+
+/*
+    This function reads the edges of an opened social graph .txt file into a graph in CSR form with loadSortedCSRGraphParallel,
+    then removes duplicates, self-loops and one-way entries with normalizeNeighbors_CSR, as loadCSRGraphFromReader does.
+    Returns NULL if the file cannot be loaded.
+*/
+CSRGraph* loadCSRGraphParallel(EdgeFileReader *reader, char *fileString, int numThreads, int *numVertices, int *numEdges)
+{
+    CSRGraph *graph = loadSortedCSRGraphParallel(reader, fileString, numThreads, numVertices, numEdges);
+    if (graph != NULL) {
+        normalizeNeighbors_CSR(graph); //check adjacencyCSR.c for the implementation of normalizeNeighbors_CSR
+    }
+    return graph;
+}
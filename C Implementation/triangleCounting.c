@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "data_structures.h"
+
+/*
+    Triangle counting and clustering coefficients of a whole graph, on any graph format.
+
+    The local clustering of a person is the share of the pairs of their friends who are friends themselves, i.e., the triangles
+    through them divided by degree * (degree - 1) / 2. The global transitivity is 3 * triangles / connected triples, where the
+    connected triples are the pairs of friends of every person, and the average clustering is the mean of the local ones.
+
+    The graph is first copied into CSR form and its neighbors made unique and mutual with normalizeNeighbors_CSR, so every
+    format counts the same friendships as hasEdge_*; a CSR graph that is already verifiedSymmetric is used as it is. Then every
+    friendship is oriented from the person of lower rank to the one of higher rank, ranking by degree and then by ID. Every
+    triangle then has exactly one person with both others among their out-friends, and no one has more than about sqrt(2E)
+    out-friends, however popular they are. For each person u and each out-friend v of u, the out-friends of both close a triangle:
+        merge   the two sorted out-friend lists are intersected with intersectSorted_Vector (check mutualFriends.c), which
+                costs the length of both lists.
+        bitset  the out-friends of u are marked in a bitset once, and the out-friends of each v are looked up in it, which
+                costs only the length of the list of v.
+    auto, the default, uses the bitset for the people with at least TRIANGLE_BITSET_MIN_DEGREE out-friends and merges the rest.
+    The people are split between the threads in chunks of TRIANGLE_CHUNK_VERTICES, taken in turn as the threads finish, and every
+    thread counts the triangles through each person in its own array, so no counter is shared.
+*/
+
+#define TRIANGLE_CHUNK_VERTICES 256
+#define TRIANGLE_BITSET_MIN_DEGREE 32
+#define TRIANGLE_MAX_THREADS 256
+
+char *triangleMethodNames[TRIANGLE_NUM_METHODS] = {"auto", "merge", "bitset"};
+
+/*
+    The state shared by the threads of one count.
+*/
+typedef struct TriangleCounterTag {
+    CSRGraph *oriented; //the out-friends of every person, sorted by ID
+    int method;
+    int nextVertex; //first person of the next chunk to be taken
+    pthread_mutex_t lock;
+} TriangleCounter;
+
+/*
+    The arguments of one thread of a count. Thread 0 is the thread that called countTriangles_GraphHandle.
+*/
+typedef struct TriangleThreadTag {
+    TriangleCounter *counter;
+    long long *triangles; //triangles[v] is the number of triangles through v found by this thread
+    uint64_t *marks; //bitset of the out-friends of the current person, for the bitset method
+    int *common;
+    pthread_t thread;
+} TriangleThread;
+
+/*
+    This function returns true if u ranks below v, i.e., has fewer friends, or as many and a lower ID.
+*/
+bool ranksBelow_Triangles(CSRGraph *graph, int u, int v)
+{
+    int degreeU = graph->offsets[u + 1] - graph->offsets[u];
+    int degreeV = graph->offsets[v + 1] - graph->offsets[v];
+    return degreeU < degreeV || (degreeU == degreeV && u < v);
+}
+
+/*
+    This function keeps, for every person of a verifiedSymmetric graph, only the friends who rank above them.
+    Each friendship is then stored once, and the out-friends stay sorted by ID.
+*/
+CSRGraph* orientGraph_Triangles(CSRGraph *graph)
+{
+    int i, k, count = 0;
+    CSRGraph *oriented = createCSRGraph(graph->numVertices, graph->numEdges / 2); //check adjacencyCSR.c for the implementation of createCSRGraph
+    for (i = 0; i < graph->numVertices; i++) {
+        oriented->offsets[i] = count;
+        for (k = graph->offsets[i]; k < graph->offsets[i + 1]; k++) {
+            if (ranksBelow_Triangles(graph, i, graph->neighbors[k])) {
+                oriented->neighbors[count++] = graph->neighbors[k];
+            }
+        }
+    }
+    oriented->offsets[graph->numVertices] = count;
+    oriented->numEdges = count;
+    return oriented;
+}
+
+/*
+    This function counts the triangles whose lowest-ranked person is u, adding each one to the counts of its three people.
+*/
+void countVertex_Triangles(TriangleThread *thread, int u)
+{
+    CSRGraph *oriented = thread->counter->oriented;
+    int *outU = oriented->neighbors + oriented->offsets[u];
+    int degreeU = oriented->offsets[u + 1] - oriented->offsets[u];
+    int i, k, v, w, *outV, degreeV, count;
+    bool useBitset = thread->counter->method == TRIANGLE_METHOD_BITSET
+                     || (thread->counter->method == TRIANGLE_METHOD_AUTO && degreeU >= TRIANGLE_BITSET_MIN_DEGREE);
+
+    if (degreeU < 2) {
+        return; //a triangle needs two out-friends
+    }
+    if (useBitset) {
+        for (i = 0; i < degreeU; i++) {
+            thread->marks[outU[i] >> 6] |= 1ULL << (outU[i] & 63);
+        }
+    }
+    for (i = 0; i < degreeU; i++) {
+        v = outU[i];
+        outV = oriented->neighbors + oriented->offsets[v];
+        degreeV = oriented->offsets[v + 1] - oriented->offsets[v];
+        count = 0;
+        if (useBitset) {
+            for (k = 0; k < degreeV; k++) {
+                w = outV[k];
+                if (thread->marks[w >> 6] & (1ULL << (w & 63))) {
+                    thread->triangles[w]++;
+                    count++;
+                }
+            }
+        } else {
+            count = intersectSorted_Vector(outU, degreeU, outV, degreeV, thread->common); //check mutualFriends.c for its implementation
+            for (k = 0; k < count; k++) {
+                thread->triangles[thread->common[k]]++;
+            }
+        }
+        thread->triangles[u] += count;
+        thread->triangles[v] += count;
+    }
+    if (useBitset) {
+        for (i = 0; i < degreeU; i++) {
+            thread->marks[outU[i] >> 6] = 0; //clearing only the marked words is cheaper than the whole bitset
+        }
+    }
+}
+
+/*
+    This function is run by every thread of a count. It takes chunks of people until none are left.
+*/
+void* runThread_Triangles(void *argument)
+{
+    TriangleThread *thread = argument;
+    TriangleCounter *counter = thread->counter;
+    int u, first;
+
+    while (true) {
+        pthread_mutex_lock(&counter->lock);
+        first = counter->nextVertex;
+        counter->nextVertex += TRIANGLE_CHUNK_VERTICES;
+        pthread_mutex_unlock(&counter->lock);
+        if (first >= counter->oriented->numVertices) {
+            return NULL;
+        }
+        for (u = first; u < first + TRIANGLE_CHUNK_VERTICES && u < counter->oriented->numVertices; u++) {
+            countVertex_Triangles(thread, u);
+        }
+    }
+}
+
+/*
+    This function counts the triangles of a loaded graph of any format with the given TRIANGLE_METHOD_*, using numThreads threads,
+    or one per processor if numThreads is 0 or less, and computes its clustering coefficients into stats.
+    Every array of stats uses the IDs of the graph, which are those of the file unless the graph was reordered.
+    The arrays are freed with freeClusteringStatistics.
+*/
+void countTriangles_GraphHandle(GraphHandle *handle, int method, int numThreads, ClusteringStatistics *stats)
+{
+    int i, t, n = handle->numVertices, degree;
+    double startTime = getWallClockTime();
+    CSRGraph *graph;
+    TriangleCounter counter;
+    TriangleThread *threads;
+
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        graph = convertAdjListToCSR(handle->adjList, n); //check adjacencyCSR.c for the implementation of the conversions
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        graph = convertAdjMatrixToCSR(handle->adjMatrix, n);
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        graph = handle->csrGraph;
+    } else {
+        graph = convertBitMatrixToCSR(handle->bitMatrix);
+    }
+    if (!graph->verifiedSymmetric) {
+        if (graph == handle->csrGraph) { //normalize a copy, so the graph of the handle keeps its entries
+            graph = createCSRGraph(n, handle->csrGraph->numEdges);
+            memcpy(graph->offsets, handle->csrGraph->offsets, (n + 1) * sizeof(int));
+            memcpy(graph->neighbors, handle->csrGraph->neighbors, handle->csrGraph->numEdges * sizeof(int));
+        }
+        normalizeNeighbors_CSR(graph); //check adjacencyCSR.c for the implementation of normalizeNeighbors_CSR
+    }
+
+    if (numThreads <= 0) {
+        numThreads = getNumProcessors();
+    }
+    if (numThreads > TRIANGLE_MAX_THREADS) {
+        numThreads = TRIANGLE_MAX_THREADS;
+    }
+    counter.oriented = orientGraph_Triangles(graph);
+    counter.method = method;
+    counter.nextVertex = 0;
+    pthread_mutex_init(&counter.lock, NULL);
+    threads = malloc(numThreads * sizeof(TriangleThread));
+    if (threads == NULL) {
+        printf("Memory allocation for the triangle count has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (t = 0; t < numThreads; t++) {
+        threads[t].counter = &counter;
+        threads[t].triangles = calloc(n > 0 ? n : 1, sizeof(long long));
+        threads[t].marks = calloc(n / 64 + 1, sizeof(uint64_t));
+        threads[t].common = malloc((n > 0 ? n : 1) * sizeof(int));
+        if (threads[t].triangles == NULL || threads[t].marks == NULL || threads[t].common == NULL) {
+            printf("Memory allocation for the triangle count has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    for (t = 1; t < numThreads; t++) {
+        if (pthread_create(&threads[t].thread, NULL, runThread_Triangles, &threads[t]) != 0) {
+            printf("Creating a thread for the triangle count has failed. Terminating program...\n");
+            exit(-1);
+        }
+    }
+    runThread_Triangles(&threads[0]);
+    for (t = 1; t < numThreads; t++) {
+        pthread_join(threads[t].thread, NULL);
+    }
+
+    //add up the counts of the threads and turn them into clustering coefficients
+    memset(stats, 0, sizeof(ClusteringStatistics));
+    stats->numVertices = n;
+    stats->numThreads = numThreads;
+    stats->method = method;
+    stats->vertexTriangles = threads[0].triangles;
+    stats->degrees = malloc((n > 0 ? n : 1) * sizeof(int));
+    stats->localClustering = malloc((n > 0 ? n : 1) * sizeof(double));
+    if (stats->degrees == NULL || stats->localClustering == NULL) {
+        printf("Memory allocation for the triangle count has failed. Terminating program...\n");
+        exit(-1);
+    }
+    for (i = 0; i < n; i++) {
+        for (t = 1; t < numThreads; t++) {
+            stats->vertexTriangles[i] += threads[t].triangles[i];
+        }
+        degree = graph->offsets[i + 1] - graph->offsets[i];
+        stats->degrees[i] = degree;
+        stats->triangles += stats->vertexTriangles[i];
+        stats->triples += (long long)degree * (degree - 1) / 2;
+        stats->localClustering[i] = degree > 1 ? stats->vertexTriangles[i] / ((double)degree * (degree - 1) / 2) : 0;
+        stats->averageClustering += stats->localClustering[i];
+    }
+    stats->triangles /= 3; //every triangle was counted once for each of its people
+    stats->averageClustering = n > 0 ? stats->averageClustering / n : 0;
+    stats->transitivity = stats->triples > 0 ? 3.0 * stats->triangles / stats->triples : 0;
+
+    for (t = 0; t < numThreads; t++) {
+        if (t > 0) {
+            free(threads[t].triangles);
+        }
+        free(threads[t].marks);
+        free(threads[t].common);
+    }
+    free(threads);
+    pthread_mutex_destroy(&counter.lock);
+    freeCSRGraph(counter.oriented);
+    if (graph != handle->csrGraph) {
+        freeCSRGraph(graph);
+    }
+    stats->seconds = getWallClockTime() - startTime;
+}
+
+/*
+    This function frees the arrays of stats computed by countTriangles_GraphHandle.
+*/
+void freeClusteringStatistics(ClusteringStatistics *stats)
+{
+    free(stats->vertexTriangles);
+    free(stats->degrees);
+    free(stats->localClustering);
+}
+
+void printClusteringStatistics(ClusteringStatistics *stats)
+{
+    printf("\n\t=== CLUSTERING ===\n");
+    printf("Triangles: %lld, connected triples: %lld.\n", stats->triangles, stats->triples);
+    printf("Global transitivity: %.6f. Average local clustering: %.6f.\n", stats->transitivity, stats->averageClustering);
+    printf("Counted with the %s method on %d thread%s in %.3f s.\n", triangleMethodNames[stats->method], stats->numThreads,
+           stats->numThreads == 1 ? "" : "s", stats->seconds);
+}
+
+/*
+    This function writes the local clustering of every person of a graph to outputPath, one line per person in increasing order
+    of their ID in the file: "ID degree triangles clustering". IDs are translated back if the graph was reordered.
+    Returns false if the file cannot be created.
+*/
+bool writeLocalClustering(ClusteringStatistics *stats, GraphHandle *handle, char *outputPath)
+{
+    int i, v;
+    FILE *out = fopen(outputPath, "w");
+    if (out == NULL) {
+        printf("Could not create %s.\n", outputPath);
+        return false;
+    }
+    for (i = 0; i < stats->numVertices; i++) {
+        v = handle->oldToNew != NULL ? handle->oldToNew[i] : i;
+        fprintf(out, "%d %d %lld %.6f\n", i, stats->degrees[v], stats->vertexTriangles[v], stats->localClustering[v]);
+    }
+    fclose(out);
+    return true;
+}
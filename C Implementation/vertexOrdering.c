@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "data_structures.h"
+
+/*
+    Vertex reordering for cache locality.
+
+    The IDs in the Facebook100 files say nothing about who is friends with whom, so a search reads parentVertices,
+    the visited set and the neighbor storage at random places. Relabeling the vertices so that friends get nearby IDs
+    makes most of those reads land on cache lines that were just used. The orderings are:
+        rcm     reverse Cuthill-McKee: a BFS from a lowest-degree vertex of each component that visits the neighbors of
+                each vertex by increasing degree, reversed at the end. Friends end up with close IDs, i.e., the matrix band is narrow.
+        degree  vertices by decreasing number of friends, so the hubs that most searches go through share a few cache lines.
+        bfs     plain BFS order from the lowest ID of each component, so every level of a search is a mostly contiguous range.
+    A reordered GraphHandle maps the IDs given to it and the paths it returns, so callers keep using the IDs of the file.
+    Only whether two IDs are connected, and the length found by the BFS-family searches (bfs, dobfs, bibfs and pbfs), stay
+    the same: those still return a shortest path, but when there are several they may return a different one, since ties
+    are broken by the new IDs. DFS visits the friends of each vertex in the order of their new IDs, so it can follow a
+    completely different, and longer, path than on the original IDs.
+*/
+
+char *vertexOrderNames[GRAPH_NUM_ORDERS] = {"none", "rcm", "degree", "bfs"};
+
+/*
+    This function numbers the vertices of a graph in CSR form in BFS order, starting a new search from each vertex of starts,
+    in that order, that has not been reached yet. If byDegree is true, the friends of each vertex are visited by increasing
+    degree, as Cuthill-McKee does, and otherwise by increasing ID.
+    Stores the vertex that gets each new ID in newToOld.
+*/
+void numberInBFSOrder_Ordering(CSRGraph *graph, int *starts, bool byDegree, int *newToOld)
+{
+    int s, k, u, v, count, head = 0, tail = 0;
+    int numVertices = graph->numVertices;
+    bool *visited = calloc(numVertices > 0 ? numVertices : 1, sizeof(bool));
+    uint64_t *keys = malloc((numVertices > 0 ? numVertices : 1) * sizeof(uint64_t));
+    if (visited == NULL || keys == NULL) {
+        printf("Memory allocation for the vertex ordering has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    for (s = 0; s < numVertices; s++) {
+        if (visited[starts[s]]) {
+            continue;
+        }
+        visited[starts[s]] = true;
+        newToOld[tail++] = starts[s]; //newToOld doubles as the queue, since vertices are numbered in the order they are enqueued
+        while (head < tail) {
+            u = newToOld[head++];
+            count = 0;
+            for (k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+                v = graph->neighbors[k];
+                if (!visited[v]) {
+                    visited[v] = true;
+                    keys[count++] = ((uint64_t)(byDegree ? graph->offsets[v + 1] - graph->offsets[v] : 0) << 32) | (uint32_t)v;
+                }
+            }
+            if (byDegree) {
+                qsort(keys, count, sizeof(uint64_t), compareKeys64); //check data_structures.c for the implementation of compareKeys64
+            }
+            for (k = 0; k < count; k++) {
+                newToOld[tail++] = (int)(keys[k] & 0xffffffffu);
+            }
+        }
+    }
+    free(visited);
+    free(keys);
+}
+
+/*
+    This function computes a new numbering of the vertices of a graph in CSR form for the given GRAPH_ORDER_*.
+    Returns newToOld, where newToOld[i] is the vertex that gets ID i.
+*/
+int* computeVertexOrder(CSRGraph *graph, int ordering)
+{
+    int i, degree;
+    int numVertices = graph->numVertices;
+    int *newToOld = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    int *starts = malloc((numVertices > 0 ? numVertices : 1) * sizeof(int));
+    uint64_t *keys = malloc((numVertices > 0 ? numVertices : 1) * sizeof(uint64_t));
+    if (newToOld == NULL || starts == NULL || keys == NULL) {
+        printf("Memory allocation for the vertex ordering has failed. Terminating program...\n");
+        exit(-1);
+    }
+
+    if (ordering == GRAPH_ORDER_RCM || ordering == GRAPH_ORDER_DEGREE) {
+        //sort by degree, increasing for the starts of Cuthill-McKee and decreasing for the degree ordering
+        for (i = 0; i < numVertices; i++) {
+            degree = graph->offsets[i + 1] - graph->offsets[i];
+            keys[i] = ((uint64_t)(ordering == GRAPH_ORDER_DEGREE ? INT32_MAX - degree : degree) << 32) | (uint32_t)i;
+        }
+        qsort(keys, numVertices, sizeof(uint64_t), compareKeys64);
+        for (i = 0; i < numVertices; i++) {
+            starts[i] = (int)(keys[i] & 0xffffffffu);
+        }
+    } else {
+        for (i = 0; i < numVertices; i++) {
+            starts[i] = i;
+        }
+    }
+
+    if (ordering == GRAPH_ORDER_DEGREE) {
+        memcpy(newToOld, starts, numVertices * sizeof(int));
+    } else if (ordering == GRAPH_ORDER_RCM) {
+        numberInBFSOrder_Ordering(graph, starts, true, newToOld);
+        for (i = 0; i < numVertices / 2; i++) { //reverse the Cuthill-McKee order
+            int swap = newToOld[i];
+            newToOld[i] = newToOld[numVertices - 1 - i];
+            newToOld[numVertices - 1 - i] = swap;
+        }
+    } else if (ordering == GRAPH_ORDER_BFS) {
+        numberInBFSOrder_Ordering(graph, starts, false, newToOld);
+    } else {
+        memcpy(newToOld, starts, numVertices * sizeof(int)); //GRAPH_ORDER_NONE keeps every ID
+    }
+    free(starts);
+    free(keys);
+    return newToOld;
+}
+
+/*
+    This function builds a copy of a graph in CSR form in which vertex newToOld[i] becomes vertex i, and stores the inverse
+    mapping in oldToNew. Each vertex's neighbors are sorted again under the new IDs.
+    Returns a pointer to the new graph.
+*/
+CSRGraph* relabelCSRGraph(CSRGraph *graph, int *newToOld, int *oldToNew)
+{
+    int i, k, old;
+    CSRGraph *relabeled = createCSRGraph(graph->numVertices, graph->numEdges); //check adjacencyCSR.c for the implementation of createCSRGraph
+
+    for (i = 0; i < graph->numVertices; i++) {
+        oldToNew[newToOld[i]] = i;
+    }
+    for (i = 0; i < graph->numVertices; i++) {
+        old = newToOld[i];
+        relabeled->offsets[i + 1] = relabeled->offsets[i] + graph->offsets[old + 1] - graph->offsets[old];
+        for (k = graph->offsets[old]; k < graph->offsets[old + 1]; k++) {
+            relabeled->neighbors[relabeled->offsets[i] + k - graph->offsets[old]] = oldToNew[graph->neighbors[k]];
+        }
+        qsort(relabeled->neighbors + relabeled->offsets[i], relabeled->offsets[i + 1] - relabeled->offsets[i], sizeof(int), compareIntegers);
+    }
+    relabeled->verifiedSymmetric = graph->verifiedSymmetric;
+    return relabeled;
+}
+
+/*
+    This function relabels the vertices of a loaded graph of any format with the given GRAPH_ORDER_*.
+    Graphs that are not in CSR form are converted to it, relabeled, and converted back.
+    From then on, findConnections_GraphHandle and collectNeighbors_GraphHandle translate between the IDs of the file and the new ones.
+    Returns false if the graph was already relabeled.
+*/
+bool reorderGraphHandle(GraphHandle *handle, int ordering)
+{
+    CSRGraph *graph, *relabeled;
+    if (handle->oldToNew != NULL) {
+        return false;
+    }
+    if (ordering == GRAPH_ORDER_NONE) {
+        return true;
+    }
+
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        graph = convertAdjListToCSR(handle->adjList, handle->numVertices);
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        graph = convertAdjMatrixToCSR(handle->adjMatrix, handle->numVertices);
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        graph = handle->csrGraph;
+    } else {
+        graph = convertBitMatrixToCSR(handle->bitMatrix);
+    }
+
+    handle->newToOld = computeVertexOrder(graph, ordering);
+    handle->oldToNew = malloc((handle->numVertices > 0 ? handle->numVertices : 1) * sizeof(int));
+    if (handle->oldToNew == NULL) {
+        printf("Memory allocation for the vertex ordering has failed. Terminating program...\n");
+        exit(-1);
+    }
+    relabeled = relabelCSRGraph(graph, handle->newToOld, handle->oldToNew);
+    handle->ordering = ordering;
+    freeCSRGraph(graph);
+
+    if (handle->format == GRAPH_FORMAT_LIST) {
+        freeAdjacencyList(handle->adjList, handle->numVertices);
+        handle->adjList = convertCSRToAdjList(relabeled);
+    } else if (handle->format == GRAPH_FORMAT_MATRIX) {
+        freeAdjMatrix(handle->adjMatrix, handle->numVertices);
+        handle->adjMatrix = convertCSRToAdjMatrix(relabeled);
+    } else if (handle->format == GRAPH_FORMAT_CSR) {
+        handle->csrGraph = relabeled;
+        return true;
+    } else {
+        freeBitMatrix(handle->bitMatrix);
+        handle->bitMatrix = convertCSRToBitMatrix(relabeled);
+    }
+    freeCSRGraph(relabeled);
+    return true;
+}